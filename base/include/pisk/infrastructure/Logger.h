@@ -18,10 +18,18 @@
 #include "../utils/algorithm_utils.h"
 #include "Exception.h"
 
+#include "TraceRecord.h"
+
 #include <memory>
 #include <vector>
 #include <string>
 
+//The most verbose level compiled in (see Logger::Level: 0 is Silent ... 6 is Spam);
+//the logging at more verbose levels is removed by the compiler
+#ifndef PISK_LOG_LEVEL
+#	define PISK_LOG_LEVEL 6
+#endif
+
 namespace pisk
 {
 namespace infrastructure
@@ -58,12 +66,95 @@ namespace infrastructure
 			}
 		};
 
-		static bool is_level_filtered(const Level new_level) threadsafe noexcept;
+		//What log() does when the ring of the asynchronous mode is full
+		enum class OverflowPolicy
+		{
+			Drop,
+			Block,
+		};
+
+		//A printer of one level: logger::spam("tag") is false when the level is filtered,
+		//so the arguments of print() are evaluated only when the record is going to be written:
+		//	if (auto&& log = logger::spam("script"))
+		//		log.print("Execute {}", to_string(arguments));
+		//The record goes to the log storage and/or to the trace storage (see set_trace_storage).
+		//The tag have to outlive the printer.
+		template <Level level>
+		class Printer
+		{
+			const bool text;
+			const bool traced;
+			const char* tag;
+		public:
+			explicit Printer(const char* tag) noexcept:
+				text(not is_level_filtered(level)),
+				traced(is_level_traced(level)),
+				tag(text or traced ? tag : nullptr)
+			{}
+			explicit operator bool() const noexcept
+			{
+				return is_level_compiled(level) and tag != nullptr;
+			}
+			template <typename Format, typename ...TArgs>
+			void print(const Format& format, const TArgs& ... args) const threadsafe noexcept
+			{
+				if (not *this)
+					return;
+				if (text)
+					log(level, tag, utils::string::format(format, args...));
+				if (traced)
+					trace(level, tag, format, args...);
+			}
+		};
+
+		static constexpr bool is_level_compiled(const Level check_level) noexcept
+		{
+			return static_cast<int>(check_level) <= PISK_LOG_LEVEL;
+		}
+
+		static bool is_level_filtered(const Level check_level) threadsafe noexcept
+		{
+			return not is_level_compiled(check_level) or is_level_filtered_at_runtime(check_level);
+		}
+
+		static bool is_level_filtered_at_runtime(const Level check_level) threadsafe noexcept;
 
 		static void set_log_level(const Level new_level) threadsafe noexcept;
 
 		static void set_log_storage(std::unique_ptr<LogStorage> storage) threadsafe noexcept;
 
+		static bool is_level_traced(const Level check_level) threadsafe noexcept
+		{
+			return is_level_compiled(check_level) and is_level_traced_at_runtime(check_level);
+		}
+
+		//False for any level while the trace storage is not set
+		static bool is_level_traced_at_runtime(const Level check_level) threadsafe noexcept;
+
+		//Records up to the level (Debug by default) go to the trace storage regardless of set_log_level
+		static void set_trace_level(const Level new_level) threadsafe noexcept;
+
+		//The binary trace: records keep the ids of the interned tag and format and the raw arguments,
+		//nothing is formatted on the writing side (see TraceLog.h)
+		static void set_trace_storage(std::unique_ptr<TraceStorage> storage) threadsafe noexcept;
+
+		//Asynchronous mode: log() copies the record into a lock-free ring of `capacity` slots and returns;
+		//a background thread writes the records into the storage by batches.
+		//The pending records are lost on a crash unless install_crash_handlers() is called.
+		static void start_async(const std::size_t capacity = 4096, const OverflowPolicy policy = OverflowPolicy::Drop) threadsafe noexcept;
+
+		//Opt-in: an unhandled exception flushes the pending records of the asynchronous mode, and the fatal signals
+		//(SIGSEGV, SIGABRT, SIGFPE, SIGILL) write them to LogStorage::get_crash_descriptor() by write(2) only.
+		//The terminate handler and the signal handlers installed before are called after that.
+		//An application with its own crash reporter has to install it after this call or not call it at all
+		static void install_crash_handlers() threadsafe noexcept;
+
+		//Writes the pending records and returns to the synchronous mode
+		static void stop_async() threadsafe noexcept;
+
+		//Waits until the records logged before the call are in the storage
+		static void flush() threadsafe noexcept;
+
 		static void log(const Level level, const std::string& tag, const std::string& message) threadsafe noexcept;
 
 		static void log(const Level level, const std::string& tag, const std::vector<std::string>& messages) threadsafe noexcept;
@@ -73,45 +164,119 @@ namespace infrastructure
 			return {};
 		}
 
+		template <std::size_t N, typename ...TArgs>
+		static void trace(const Level level, const char* tag, const char (&format)[N], const TArgs& ... args) threadsafe noexcept {
+			TraceRecord record;
+			TraceArgumentWriter writer(record);
+			const int expand[] = {0, (writer.write(args), 0)...};
+			UNUSED(expand);
+			trace(level, tag, format, std::char_traits<char>::length(format), record);
+		}
 		template <typename ...TArgs>
-		static void log_format(const Level level, const std::string& tag, const std::string& format, TArgs&& ... args) threadsafe noexcept {
+		static void trace(const Level level, const char* tag, const std::string& format, const TArgs& ... args) threadsafe noexcept {
+			TraceRecord record;
+			TraceArgumentWriter writer(record);
+			const int expand[] = {0, (writer.write(args), 0)...};
+			UNUSED(expand);
+			trace(level, tag, format.data(), format.size(), record);
+		}
+
+		static void trace(const Level level, const char* tag, const char* format, const std::size_t format_size, TraceRecord& record) threadsafe noexcept;
+
+		//Nothing is formatted (the tag and the format are not converted to std::string as well) when the level is filtered
+		template <typename Tag, typename Format, typename ...TArgs>
+		static void log_format(const Level level, const Tag& tag, const Format& format, TArgs&& ... args) threadsafe noexcept {
 			if (is_level_filtered(level))
 				return;
-			const std::string message = utils::string::format(format, std::forward<TArgs>(args)...);
-			log(level, tag, message);
+			log(level, tag, utils::string::format(format, std::forward<TArgs>(args)...));
 		}
-		template <typename ...TArgs>
-		static void critical(const std::string& tag, const std::string& format, TArgs&& ... args) threadsafe noexcept {
-			log_format(Level::Critical, tag, format, std::forward<TArgs>(args)...);
+
+		static Printer<Level::Critical> critical(const char* tag) threadsafe noexcept {
+			return Printer<Level::Critical>(tag);
 		}
-		template <typename ...TArgs>
-		static void error(const std::string& tag, const std::string& format, TArgs&& ... args) threadsafe noexcept {
-			log_format(Level::Error, tag, format, std::forward<TArgs>(args)...);
+		static Printer<Level::Critical> critical(const std::string& tag) threadsafe noexcept {
+			return Printer<Level::Critical>(tag.c_str());
 		}
-		template <typename ...TArgs>
-		static void warning(const std::string& tag, const std::string& format, TArgs&& ... args) threadsafe noexcept {
-			log_format(Level::Warning, tag, format, std::forward<TArgs>(args)...);
+		template <typename Tag, typename Format, typename ...TArgs>
+		static void critical(const Tag& tag, const Format& format, TArgs&& ... args) threadsafe noexcept {
+			critical(tag).print(format, std::forward<TArgs>(args)...);
 		}
-		template <typename ...TArgs>
-		static void info(const std::string& tag, const std::string& format, TArgs&& ... args) threadsafe noexcept {
-			log_format(Level::Information, tag, format, std::forward<TArgs>(args)...);
+
+		static Printer<Level::Error> error(const char* tag) threadsafe noexcept {
+			return Printer<Level::Error>(tag);
 		}
-		template <typename ...TArgs>
-		static void debug(const std::string& tag, const std::string& format, TArgs&& ... args) threadsafe noexcept {
-			log_format(Level::Debug, tag, format, std::forward<TArgs>(args)...);
+		static Printer<Level::Error> error(const std::string& tag) threadsafe noexcept {
+			return Printer<Level::Error>(tag.c_str());
 		}
-		template <typename ...TArgs>
-		static void spam(const std::string& tag, const std::string& format, TArgs&& ... args) threadsafe noexcept {
-			log_format(Level::Spam, tag, format, std::forward<TArgs>(args)...);
+		template <typename Tag, typename Format, typename ...TArgs>
+		static void error(const Tag& tag, const Format& format, TArgs&& ... args) threadsafe noexcept {
+			error(tag).print(format, std::forward<TArgs>(args)...);
+		}
+
+		static Printer<Level::Warning> warning(const char* tag) threadsafe noexcept {
+			return Printer<Level::Warning>(tag);
+		}
+		static Printer<Level::Warning> warning(const std::string& tag) threadsafe noexcept {
+			return Printer<Level::Warning>(tag.c_str());
+		}
+		template <typename Tag, typename Format, typename ...TArgs>
+		static void warning(const Tag& tag, const Format& format, TArgs&& ... args) threadsafe noexcept {
+			warning(tag).print(format, std::forward<TArgs>(args)...);
+		}
+
+		static Printer<Level::Information> info(const char* tag) threadsafe noexcept {
+			return Printer<Level::Information>(tag);
+		}
+		static Printer<Level::Information> info(const std::string& tag) threadsafe noexcept {
+			return Printer<Level::Information>(tag.c_str());
+		}
+		template <typename Tag, typename Format, typename ...TArgs>
+		static void info(const Tag& tag, const Format& format, TArgs&& ... args) threadsafe noexcept {
+			info(tag).print(format, std::forward<TArgs>(args)...);
+		}
+
+		static Printer<Level::Debug> debug(const char* tag) threadsafe noexcept {
+			return Printer<Level::Debug>(tag);
+		}
+		static Printer<Level::Debug> debug(const std::string& tag) threadsafe noexcept {
+			return Printer<Level::Debug>(tag.c_str());
+		}
+		template <typename Tag, typename Format, typename ...TArgs>
+		static void debug(const Tag& tag, const Format& format, TArgs&& ... args) threadsafe noexcept {
+			debug(tag).print(format, std::forward<TArgs>(args)...);
+		}
+
+		static Printer<Level::Spam> spam(const char* tag) threadsafe noexcept {
+			return Printer<Level::Spam>(tag);
+		}
+		static Printer<Level::Spam> spam(const std::string& tag) threadsafe noexcept {
+			return Printer<Level::Spam>(tag.c_str());
+		}
+		template <typename Tag, typename Format, typename ...TArgs>
+		static void spam(const Tag& tag, const Format& format, TArgs&& ... args) threadsafe noexcept {
+			spam(tag).print(format, std::forward<TArgs>(args)...);
 		}
 	};
 
 	class LogStorage
 	{
 	public:
+		virtual ~LogStorage() {}
+
 		virtual void store(const Logger::Level level, const std::string& tag, const std::string& message) noexcept = 0;
 
 		virtual void store(const Logger::Level level, const std::string& tag, const std::vector<std::string>& messages) noexcept = 0;
+
+		//Called after a record (or a batch of records in the asynchronous mode) is stored
+		virtual void flush() noexcept
+		{}
+
+		//A descriptor the crash handlers write the pending records to (see Logger::install_crash_handlers);
+		//-1 if the records can not be written without the storage
+		virtual int get_crash_descriptor() const noexcept
+		{
+			return -1;
+		}
 	};
 }
 	using logger = infrastructure::Logger;
@@ -0,0 +1,111 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "Exception.h"
+#include "Logger.h"
+#include "TraceRecord.h"
+
+#include <unordered_map>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace pisk
+{
+namespace infrastructure
+{
+	class TraceFormatException : public Exception
+	{};
+
+	//The beginning of a trace block; the table of strings and the ring of records follow it
+	struct TraceHeader
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t record_size;
+		std::uint64_t records;
+		std::uint64_t records_offset;
+		std::uint64_t strings_offset;
+		std::uint64_t strings_capacity;
+		std::uint64_t strings_size;
+		//the clocks at the moment the block is formatted, ns
+		std::int64_t steady_origin;
+		std::int64_t system_origin;
+	};
+
+	//Trace storage in a fixed block of memory (a mapped file is the intended one).
+	//Writing a record is a fetch_add and a copy of the slot; the oldest records are overwritten.
+	//A string is stored once: its id is the offset of the entry (size and chars) in the table of strings.
+	class EXPORT TraceRing :
+		public TraceStorage
+	{
+		TraceHeader* header;
+		char* strings;
+		TraceRecord* records;
+		std::uint64_t mask;
+		std::atomic<std::uint64_t> next {0};
+
+		std::mutex guard;
+		std::unordered_map<std::string, std::uint32_t> interned;
+
+	public:
+		constexpr static std::uint32_t unknown_string = 0xFFFFFFFF;
+
+		//Size of the block for `records` (rounded up to a power of two) and `strings` bytes of the strings
+		static std::size_t block_size(const std::size_t records, const std::size_t strings) noexcept;
+
+		//Formats the block; it has to be at least block_size(record_count, strings_capacity) bytes
+		TraceRing(void* block, const std::size_t record_count, const std::size_t strings_capacity);
+
+		virtual std::uint32_t intern(const char* text, const std::size_t size) noexcept override;
+
+		virtual void write(TraceRecord& record) noexcept override;
+	};
+
+	//Decodes a block written by TraceRing; used offline, a block being written may give broken records
+	class EXPORT TraceReader
+	{
+		std::vector<char> block;
+		const TraceHeader* header;
+
+	public:
+		struct Line
+		{
+			std::uint64_t sequence;
+			//ns since the epoch of the system clock
+			std::int64_t time;
+			std::uint32_t thread;
+			Logger::Level level;
+			std::string tag;
+			std::string message;
+		};
+
+		//Throws TraceFormatException if the data is not a trace block
+		TraceReader(const char* data, const std::size_t size);
+
+		//The records in the order of writing
+		std::vector<Line> read() const;
+
+		//Formats the arguments of the record by `format` like utils::string::format does
+		static std::string format(const std::string& format, const TraceRecord& record);
+
+	private:
+		std::string get_string(const std::uint32_t id) const;
+	};
+}
+}
@@ -0,0 +1,192 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "../utils/algorithm_utils.h"
+#include "../utils/keystring.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace pisk
+{
+namespace infrastructure
+{
+	enum class TraceArgument : std::uint8_t
+	{
+		Signed,
+		Unsigned,
+		Floating,
+		Boolean,
+		Character,
+		Pointer,
+		String,
+	};
+
+	//A record of the binary trace log: the format and the arguments are kept unformatted.
+	//The struct is the slot of the trace file, so it has the fixed layout.
+	struct TraceRecord
+	{
+		std::uint64_t sequence;
+		std::int64_t timestamp;
+		std::uint32_t thread;
+		std::uint32_t tag;
+		std::uint32_t format;
+		std::uint8_t level;
+		std::uint8_t count;
+		std::uint16_t size;
+		std::uint8_t arguments[88];
+		//the sequence written once more after the payload: the record is whole if both are equal
+		std::uint64_t end_sequence;
+	};
+	static_assert(sizeof(TraceRecord) == 128, "TraceRecord is the slot of the trace file");
+
+	//Serializes arguments into the record: a type byte and the raw value; strings keep a length byte.
+	//Arguments which do not fit are dropped, the last string is truncated.
+	class TraceArgumentWriter
+	{
+		TraceRecord& record;
+		bool full = false;
+
+	public:
+		explicit TraceArgumentWriter(TraceRecord& record) noexcept:
+			record(record)
+		{
+			record.count = 0;
+			record.size = 0;
+		}
+
+		template <typename TArg>
+		void write(const TArg& value)
+		{
+			using namespace utils::string::details;
+			write(value, kind_tag<kind_of<TArg>()>());
+		}
+
+	private:
+		void put(const TraceArgument type, const void* value, const std::size_t size) noexcept
+		{
+			if (full or record.size + 1 + size > sizeof(record.arguments))
+			{
+				full = true;
+				return;
+			}
+			record.arguments[record.size++] = static_cast<std::uint8_t>(type);
+			std::memcpy(record.arguments + record.size, value, size);
+			record.size += static_cast<std::uint16_t>(size);
+			++record.count;
+		}
+
+		void put_string(const char* text, std::size_t size) noexcept
+		{
+			if (full or std::size_t(record.size) + 2 > sizeof(record.arguments))
+			{
+				full = true;
+				return;
+			}
+			size = std::min<std::size_t>({size, 255, sizeof(record.arguments) - record.size - 2});
+			record.arguments[record.size++] = static_cast<std::uint8_t>(TraceArgument::String);
+			record.arguments[record.size++] = static_cast<std::uint8_t>(size);
+			std::memcpy(record.arguments + record.size, text, size);
+			record.size += static_cast<std::uint16_t>(size);
+			++record.count;
+		}
+
+		template <typename TArg>
+		void put_integer(const TArg value) noexcept
+		{
+			if (std::is_signed<TArg>::value)
+			{
+				const std::int64_t raw = static_cast<std::int64_t>(value);
+				put(TraceArgument::Signed, &raw, sizeof(raw));
+			}
+			else
+			{
+				const std::uint64_t raw = static_cast<std::uint64_t>(value);
+				put(TraceArgument::Unsigned, &raw, sizeof(raw));
+			}
+		}
+
+		void write(const bool value, utils::string::details::kind_tag<utils::string::details::kind::boolean>) noexcept
+		{
+			const std::uint8_t raw = value ? 1 : 0;
+			put(TraceArgument::Boolean, &raw, sizeof(raw));
+		}
+		void write(const char value, utils::string::details::kind_tag<utils::string::details::kind::character>) noexcept
+		{
+			put(TraceArgument::Character, &value, sizeof(value));
+		}
+		template <typename TArg>
+		void write(const TArg value, utils::string::details::kind_tag<utils::string::details::kind::integer>) noexcept
+		{
+			put_integer(value);
+		}
+		template <typename TArg>
+		void write(const TArg value, utils::string::details::kind_tag<utils::string::details::kind::enumeration>) noexcept
+		{
+			put_integer(static_cast<std::underlying_type_t<TArg>>(value));
+		}
+		template <typename TArg>
+		void write(const TArg value, utils::string::details::kind_tag<utils::string::details::kind::floating>) noexcept
+		{
+			const double raw = static_cast<double>(value);
+			put(TraceArgument::Floating, &raw, sizeof(raw));
+		}
+		void write(const char* value, utils::string::details::kind_tag<utils::string::details::kind::text>) noexcept
+		{
+			if (value == nullptr)
+				put_string("nullptr", 7);
+			else
+				put_string(value, std::strlen(value));
+		}
+		void write(const std::string& value, utils::string::details::kind_tag<utils::string::details::kind::text>) noexcept
+		{
+			put_string(value.data(), value.size());
+		}
+		void write(const void* value, utils::string::details::kind_tag<utils::string::details::kind::pointer>) noexcept
+		{
+			const std::uint64_t raw = reinterpret_cast<std::uintptr_t>(value);
+			put(TraceArgument::Pointer, &raw, sizeof(raw));
+		}
+		void write(const utils::keystring& value, utils::string::details::kind_tag<utils::string::details::kind::other>) noexcept
+		{
+			const std::string& content = value.get_content();
+			put_string(content.data(), content.size());
+		}
+		//Other types are stored as the result of `to_string(value)` found by ADL: a keystring or a std::string
+		template <typename TArg>
+		void write(const TArg& value, utils::string::details::kind_tag<utils::string::details::kind::other>)
+		{
+			const auto& text = to_string(value);
+			put_string(text.data(), text.size());
+		}
+	};
+
+	//Receiver of the trace records; it has to be lock-free for writers, the trace is always on
+	class TraceStorage
+	{
+	public:
+		virtual ~TraceStorage() {}
+
+		//Returns an id of the string; the logger caches ids, so a string is interned once per thread
+		virtual std::uint32_t intern(const char* text, const std::size_t size) noexcept = 0;
+
+		//The storage fills `sequence`, `end_sequence` and `thread` of the record
+		virtual void write(TraceRecord& record) noexcept = 0;
+	};
+}
+}
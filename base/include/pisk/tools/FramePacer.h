@@ -0,0 +1,101 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+
+#include <cstddef>
+#include <chrono>
+#include <vector>
+
+namespace pisk
+{
+namespace tools
+{
+	//Sleeps until the time point of the monotonic clock; an absolute deadline does not add the oversleep
+	//of the previous waits. On Linux it is clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)
+	void EXPORT sleep_until(const std::chrono::steady_clock::time_point time);
+
+	//What to do with the frames which are missed because a tick took too long
+	enum class FrameOverrun
+	{
+		//the missed frames are dropped, the next frame keeps the phase of the grid
+		Skip,
+		//the tick runs the update once per missed frame, but not more than max_catch_up extra times
+		CatchUp,
+	};
+
+	//Fixed timestep on a grid of `interval` from the first frame: the frame time is not taken from the time
+	//of wakeup, so the late wakeups do not accumulate and the pace does not drift
+	class EXPORT FramePacer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	private:
+		Clock::duration interval;
+		FrameOverrun overrun;
+		std::size_t max_catch_up;
+
+		Clock::time_point frame;
+		bool started = false;
+
+	public:
+		FramePacer(const Clock::duration interval, const FrameOverrun overrun, const std::size_t max_catch_up);
+
+		//Moves to the next frame for the current time `now`; returns the count of updates the tick has to run.
+		//If `now` is before the frame, the caller has to wait until get_frame_time()
+		std::size_t advance(const Clock::time_point now);
+
+		//advance() and sleep_until() the frame
+		std::size_t wait_next_frame();
+
+		Clock::time_point get_frame_time() const
+		{
+			return frame;
+		}
+	};
+
+	//The periods between the ticks: min and average are over all the ticks,
+	//the percentile is over the last `window` ones. Is not threadsafe
+	class EXPORT TickStatistics
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		static constexpr std::size_t window = 1024;
+
+	private:
+		std::vector<Clock::duration> periods;
+		std::size_t next_period = 0;
+
+		Clock::time_point last_tick;
+		std::size_t count = 0;
+		Clock::duration min = Clock::duration::max();
+		Clock::duration total = Clock::duration::zero();
+
+	public:
+		void tick(const Clock::time_point now);
+
+		//the count of the measured periods: one less than the count of the ticks
+		std::size_t get_count() const
+		{
+			return count;
+		}
+		Clock::duration get_min() const;
+		Clock::duration get_average() const;
+		//`percent` is in (0, 100]
+		Clock::duration get_percentile(const double percent) const;
+	};
+}
+}
@@ -17,15 +17,59 @@
 #include "../utils/noncopyable.h"
 #include "../infrastructure/Exception.h"
 #include "../infrastructure/Logger.h"
+#include "ThreadPool.h"
 
+#include <condition_variable>
 #include <functional>
+#include <memory>
 #include <atomic>
+#include <chrono>
 #include <thread>
+#include <mutex>
 
 namespace pisk
 {
 namespace tools
 {
+namespace details
+{
+	//End of a job running on the pool. The waiter sees it under the lock only,
+	//so the job may be destroyed as soon as wait() returns
+	class job_completion
+	{
+		std::mutex guard;
+		std::condition_variable signal;
+		bool done = false;
+
+	public:
+		void set()
+		{
+			std::unique_lock<std::mutex> lock(guard);
+			done = true;
+			signal.notify_all();
+		}
+
+		//a worker of the pool runs other tasks meanwhile: the job may be queued behind the waiting one
+		void wait(ThreadPool& pool)
+		{
+			std::unique_lock<std::mutex> lock(guard);
+			while (not done and pool.is_worker_thread())
+			{
+				lock.unlock();
+				const bool helped = pool.run_pending_task();
+				lock.lock();
+				if (not helped)
+					signal.wait_for(lock, std::chrono::milliseconds(1));
+			}
+			signal.wait(lock, [this]() {
+				return done;
+			});
+		}
+	};
+}
+
+	//Runs the function on an own thread or on the thread pool; the destructor requests the stop and waits for the end.
+	//A job on the pool holds a worker while it runs, so the long running ones are better made cyclical.
 	class ScopedJob final :
 		public utils::noncopyable
 	{
@@ -35,6 +79,8 @@ namespace tools
 	private:
 		std::atomic_bool stop_flag;
 		JobRunFn run;
+		ThreadPool* pool = nullptr;
+		details::job_completion completion;
 		std::thread thread;
 
 		void safe_run()
@@ -60,6 +106,20 @@ namespace tools
 			}
 		}
 
+		ScopedJob(ThreadPool& _pool, JobRunFn _run, const ThreadPool::Priority priority = ThreadPool::Priority::Normal) :
+			stop_flag(false),
+			run(_run),
+			pool(&_pool)
+		{
+			if (run == nullptr)
+				throw infrastructure::InvalidArgumentException();
+			pool->post([this]() {
+				safe_run();
+				completion.set();
+			}, priority);
+			logger::debug("job", "Constructed on the pool: {}", this);
+		}
+
 		~ScopedJob()
 		{
 			logger::debug("job", "Destructing: {}", this);
@@ -88,11 +148,20 @@ namespace tools
 		void join()
 		{
 			logger::debug("job", "Join: {}", this);
+			if (pool != nullptr)
+			{
+				completion.wait(*pool);
+				return;
+			}
 			assert(std::this_thread::get_id() != thread.get_id());
 			thread.join();
 		}
 	};
 
+	//Calls the iteration until the stop; the iteration is called at least once.
+	//On the pool every iteration is a task of its own, so other tasks run between iterations.
+	//A suspended job is not iterated until resume() or the stop: on the pool it holds no worker at all.
+	//A delayed one is iterated again after the delay: the iteration polls without blocking the worker.
 	class CyclicalScopedJob final :
 		public utils::noncopyable
 	{
@@ -105,28 +174,122 @@ namespace tools
 		JobSetupFn on_start;
 		JobIterationFn iteration;
 		JobFinishFn on_end;
-		ScopedJob job;
 
-		void run()
-		{
-			if (iteration == nullptr)
-				return;
+		ThreadPool* pool = nullptr;
+		const ThreadPool::Priority priority = ThreadPool::Priority::Normal;
+		details::job_completion completion;
+
+		std::atomic_bool stop_flag {false};
+		mutable std::mutex state_guard;
+		std::condition_variable state_signal;
+		mutable bool suspend_requested = false;
+		mutable ThreadPool::Clock::duration delay_requested = ThreadPool::Clock::duration::zero();
+		bool resume_requested = false;
+		bool parked = false;
 
+		std::unique_ptr<ScopedJob> job;
+
+		bool start()
+		{
 			if (on_start)
 				if (on_start() == false)
 				{
 					logger::warning("job", "Failed start job: on_start returned false; {}", this);
-					return;
+					return false;
 				}
+			return true;
+		}
+
+		void finish()
+		{
+			if (on_end)
+				on_end();
+		}
+
+		void iterate()
+		{
+			{
+				std::unique_lock<std::mutex> lock(state_guard);
+				suspend_requested = false;
+				delay_requested = ThreadPool::Clock::duration::zero();
+				resume_requested = false;
+			}
+			iteration(*this);
+		}
+
+		void run()
+		{
+			if (not start())
+				return;
 
 			do
 			{
-				iteration(*this);
+				iterate();
+				std::unique_lock<std::mutex> lock(state_guard);
+				state_signal.wait_for(lock, delay_requested, [this]() {
+					return is_stopped() or resume_requested;
+				});
+				state_signal.wait(lock, [this]() {
+					return is_stopped() or not suspend_requested or resume_requested;
+				});
 			}
 			while (not_stopped());
 
-			if (on_end)
-				on_end();
+			finish();
+		}
+
+		void first_step()
+		{
+			if (start())
+				step();
+			else
+				completion.set();
+		}
+
+		//the stop may come while the step is in the queue
+		void next_step()
+		{
+			if (not_stopped())
+			{
+				step();
+				return;
+			}
+			finish();
+			completion.set();
+		}
+
+		void step()
+		{
+			iterate();
+			{
+				std::unique_lock<std::mutex> lock(state_guard);
+				if (not_stopped())
+				{
+					if (suspend_requested and not resume_requested)
+						parked = true;
+					else if (delay_requested > ThreadPool::Clock::duration::zero() and not resume_requested)
+						post_step_after(delay_requested);
+					else
+						post_step();
+					return;
+				}
+			}
+			finish();
+			completion.set();
+		}
+
+		void post_step()
+		{
+			pool->post([this]() {
+				next_step();
+			}, priority);
+		}
+		//the destructor waits for the posted step, so the stop waits for the delay at most
+		void post_step_after(const ThreadPool::Clock::duration delay)
+		{
+			pool->post_after(delay, [this]() {
+				next_step();
+			}, priority);
 		}
 
 	public:
@@ -134,24 +297,91 @@ namespace tools
 			JobIterationFn _iteration,
 			JobFinishFn _on_end = nullptr,
 			JobSetupFn _on_start = nullptr
+		) :
+			on_start(_on_start),
+			iteration(_iteration),
+			on_end(_on_end)
+		{
+			if (iteration == nullptr)
+				throw infrastructure::InvalidArgumentException();
+			job = std::make_unique<ScopedJob>(std::bind(&CyclicalScopedJob::run, this));
+		}
+
+		CyclicalScopedJob(
+			ThreadPool& _pool,
+			JobIterationFn _iteration,
+			JobFinishFn _on_end = nullptr,
+			JobSetupFn _on_start = nullptr,
+			const ThreadPool::Priority _priority = ThreadPool::Priority::Normal
 		) :
 			on_start(_on_start),
 			iteration(_iteration),
 			on_end(_on_end),
-			job(std::bind(&CyclicalScopedJob::run, this))
+			pool(&_pool),
+			priority(_priority)
 		{
 			if (iteration == nullptr)
 				throw infrastructure::InvalidArgumentException();
+			pool->post([this]() {
+				first_step();
+			}, priority);
+		}
+
+		~CyclicalScopedJob()
+		{
+			stop();
+			if (pool != nullptr)
+				completion.wait(*pool);
+			job.reset();
 		}
 
 		bool not_stopped() const
 		{
-			return job.not_stopped();
+			return not is_stopped();
 		}
 
 		bool is_stopped() const
 		{
-			return job.is_stopped();
+			return stop_flag;
+		}
+
+		//Stops the iterations after the current one; the iteration suspends the job through the given reference
+		void suspend() const threadsafe
+		{
+			std::unique_lock<std::mutex> lock(state_guard);
+			suspend_requested = true;
+		}
+
+		//Iterates again after the delay, not at once; a resume during the iteration cancels the delay of this iteration
+		void delay(const ThreadPool::Clock::duration delay) const threadsafe
+		{
+			std::unique_lock<std::mutex> lock(state_guard);
+			delay_requested = delay;
+		}
+
+		//Continues the suspended job; a resume during the iteration cancels the suspend of this iteration
+		void resume() threadsafe
+		{
+			std::unique_lock<std::mutex> lock(state_guard);
+			resume_requested = true;
+			wake_parked();
+		}
+
+	private:
+		void stop()
+		{
+			stop_flag = true;
+			std::unique_lock<std::mutex> lock(state_guard);
+			wake_parked();
+		}
+
+		void wake_parked()
+		{
+			state_signal.notify_all();
+			if (not parked)
+				return;
+			parked = false;
+			post_step();
 		}
 	};
 }
@@ -0,0 +1,47 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "../utils/property_tree.h"
+
+#include "ThreadPool.h"
+
+#include <cstddef>
+
+namespace pisk
+{
+namespace tools
+{
+	//The count of the top-level `children` of a patch from which replace_parallel() and apply_patch_parallel() use the pool
+	constexpr std::size_t parallel_replace_threshold = 1024;
+
+	//utils::property::replace(original, admixture) which merges the top-level `children` items on the pool;
+	//the calling thread merges as well and returns when all of them are done. The result is the same as
+	//the one of replace(). Small patches and trees out of the default memory resource (an arena is not
+	//threadsafe) are merged by replace(). If merges of items throw, the other items are still merged and
+	//the first exception is rethrown: `original` is left partially changed, as replace() leaves it
+	void EXPORT replace_parallel(utils::property& original, const utils::property& admixture, ThreadPool& pool, const std::size_t threshold = parallel_replace_threshold);
+
+	//replace_parallel() on ThreadPool::shared()
+	void EXPORT replace_parallel(utils::property& original, const utils::property& admixture);
+
+	//replace_parallel() for utils::property::apply_patch(): the patch markers of diff() and compact() are applied
+	void EXPORT apply_patch_parallel(utils::property& original, const utils::property& patch, ThreadPool& pool, const std::size_t threshold = parallel_replace_threshold);
+
+	//apply_patch_parallel() on ThreadPool::shared()
+	void EXPORT apply_patch_parallel(utils::property& original, const utils::property& patch);
+}
+}
+
@@ -15,11 +15,16 @@
 
 #include "../defines.h"
 #include "../utils/noncopyable.h"
-#include "../utils/safequeue.h"
+#include "../utils/mpsc_queue.h"
+#include "../utils/small_function.h"
 #include "../infrastructure/Logger.h"
 #include "../infrastructure/Exception.h"
 
 #include <future>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
 #include <functional>
 #include <type_traits>
 
@@ -29,6 +34,7 @@ namespace tools
 {
 namespace _details
 {
+	//The callee is kept inside the task: a task is allocated only as a node of the queue
 	class RemoteTask :
 		public utils::noncopyable
 	{
@@ -37,67 +43,87 @@ namespace _details
 		using result_t = void;
 
 	private:
-		std::function<callee_t> callee;
-		std::promise<result_t> promise;
+		utils::small_function<callee_t> callee;
 
 	public:
 		RemoteTask() = default;
 		RemoteTask(RemoteTask&&) = default;
 		RemoteTask& operator=(RemoteTask&&) = default;
 
-		RemoteTask(std::function<callee_t> callee) :
-			callee(std::move(callee))
+		template <typename Callee, typename = std::enable_if_t<!std::is_same<std::decay_t<Callee>, RemoteTask>::value>>
+		RemoteTask(Callee&& callee) :
+			callee(std::forward<Callee>(callee))
 		{}
 
 		bool valid() const
 		{
-			return callee != nullptr;
+			return static_cast<bool>(callee);
 		}
 
 		void swap(RemoteTask& out)
 		{
-			promise.swap(out.promise);
 			callee.swap(out.callee);
 		}
 
 		void reset()
 		{
-			decltype(promise) trash;
-			promise.swap(trash);
 			callee = nullptr;
 		}
 
-		std::future<result_t> get_future()
-		{
-			return promise.get_future();
-		}
-
 		void operator ()()
 		{
 			callee();
-			promise.set_value();
 		}
 	};
 
 	class RemoteTaskList :
 		public utils::noncopyable
 	{
-		utils::safequeue<RemoteTask> tasks;
+		//the tasks are executed by the single thread of RemoteTaskExecutor
+		utils::mpsc_queue<RemoteTask> tasks;
 
 	public:
 
-		std::future<void> push(std::function<void()> handle) threadsafe
+		template <typename Callee>
+		std::future<void> push(Callee&& handle) threadsafe
 		{
-			auto task = RemoteTask(handle);
-			auto future = task.get_future();
-			tasks.push(std::move(task));
+			std::promise<void> promise;
+			auto future = promise.get_future();
+			post(promised<std::decay_t<Callee>>{std::move(promise), std::forward<Callee>(handle)});
 			return future;
 		}
 
+		//Fire-and-forget: the caller gets no future
+		template <typename Callee>
+		void post(Callee&& handle) threadsafe
+		{
+			tasks.push(RemoteTask(std::forward<Callee>(handle)));
+		}
+
 		bool pop(RemoteTask& task) threadsafe
 		{
 			return tasks.pop(task);
 		}
+
+		//Moves all the queued tasks to the end of `out`
+		std::size_t pop_all(std::vector<RemoteTask>& out) threadsafe
+		{
+			return tasks.pop_all(out);
+		}
+
+	private:
+		template <typename Callee>
+		struct promised
+		{
+			std::promise<void> promise;
+			Callee handle;
+
+			void operator()()
+			{
+				handle();
+				promise.set_value();
+			}
+		};
 	};
 
 }//namespace _details
@@ -108,11 +134,15 @@ namespace _details
 		_details::RemoteTaskList task_list;
 		std::atomic<std::thread::id> execute_thread_id{std::thread::id{}};
 
+		//the drained tasks; is used by the thread of init() only
+		std::vector<_details::RemoteTask> batch;
+		std::size_t batch_position = 0;
+
 	public:
 
 		void init()
 		{
-			if (execute_thread_id != std::thread::id{})
+			if (execute_thread_id.load() != std::thread::id{})
 			{
 				pisk::logger::critical("RemoteTaskExecutor", "already initialized");
 				throw infrastructure::InitializeError();
@@ -122,7 +152,7 @@ namespace _details
 
 		void deinit()
 		{
-			if (execute_thread_id != std::this_thread::get_id())
+			if (execute_thread_id.load() != std::this_thread::get_id())
 			{
 				pisk::logger::error("RemoteTaskExecutor", "unable to execute 'deinit': RemoteTaskExecutor still no initialized");
 				throw infrastructure::InitializeError();
@@ -131,14 +161,33 @@ namespace _details
 			execute_thread_id = std::thread::id{};
 		}
 
+		//Is called by the thread of init(): the list has the single consumer.
+		//Executes the tasks queued before the call; the tasks pushed by them wait for the next call
 		void execute_remote_tasks() threadsafe
 		{
 			check_initialized(__FUNCTION__);
 
-			_details::RemoteTask task;
-			while (task_list.pop(task))
-				if (task.valid())
-					task();
+			fetch_batch();
+			while (batch_position != batch.size())
+				execute_next();
+		}
+
+		//The same, but stops when `budget` is spent (after one task at least); the rest are executed first by the next call.
+		//Returns false if some tasks are left
+		template <typename Rep, typename Period>
+		bool execute_remote_tasks(const std::chrono::duration<Rep, Period>& budget) threadsafe
+		{
+			check_initialized(__FUNCTION__);
+
+			const auto deadline = std::chrono::steady_clock::now() + budget;
+			fetch_batch();
+			while (batch_position != batch.size())
+			{
+				execute_next();
+				if (std::chrono::steady_clock::now() >= deadline)
+					break;
+			}
+			return batch_position == batch.size();
 		}
 
 		template <typename Callee>
@@ -146,7 +195,7 @@ namespace _details
 		{
 			check_initialized(__FUNCTION__);
 
-			if (execute_thread_id == std::this_thread::get_id())
+			if (execute_thread_id.load() == std::this_thread::get_id())
 				return runnable();
 
 			decltype(runnable()) out;
@@ -160,7 +209,7 @@ namespace _details
 		{
 			check_initialized(__FUNCTION__);
 
-			if (execute_thread_id == std::this_thread::get_id())
+			if (execute_thread_id.load() == std::this_thread::get_id())
 				return runnable();
 
 			task_list.push([&runnable]() {
@@ -173,23 +222,58 @@ namespace _details
 		{
 			check_initialized(__FUNCTION__);
 
-			struct data {
-				std::promise<decltype(runnable())> _promise;
-				std::remove_reference_t<Callee> _runnable;
-			};
-			auto d = std::make_shared<data>(data{{}, std::forward<Callee>(runnable)});
-			auto out = d->_promise.get_future();
-			task_list.push([d]() mutable {
-				execute<decltype(runnable())>(std::move(d->_promise), std::move(d->_runnable));
-			});
+			using result_t = decltype(runnable());
+			std::promise<result_t> promise;
+			auto out = promise.get_future();
+			task_list.post(promised_task<result_t, std::decay_t<Callee>>{std::move(promise), std::forward<Callee>(runnable)});
 			return out;
 		}
 
+		//Fire-and-forget: no promise and future are made for the result
+		template <typename Callee>
+		void post_remote_task(Callee&& runnable) threadsafe
+		{
+			check_initialized(__FUNCTION__);
+
+			task_list.post(std::forward<Callee>(runnable));
+		}
+
 	private:
+		template <typename Result, typename Callee>
+		struct promised_task
+		{
+			std::promise<Result> promise;
+			Callee runnable;
+
+			void operator()()
+			{
+				execute<Result>(std::move(promise), std::move(runnable));
+			}
+		};
+
+		void fetch_batch()
+		{
+			if (batch_position == batch.size())
+			{
+				batch.clear();
+				batch_position = 0;
+			}
+			task_list.pop_all(batch);
+		}
+
+		//the task is taken out of the batch before the call: a throwing task does not block the others
+		void execute_next()
+		{
+			_details::RemoteTask task;
+			task.swap(batch[batch_position++]);
+			if (task.valid())
+				task();
+		}
+
 		template <std::size_t size>
 		void check_initialized(const char (&fn_name)[size]) const threadsafe
 		{
-			if (execute_thread_id == std::thread::id{})
+			if (execute_thread_id.load() == std::thread::id{})
 			{
 				pisk::logger::error("RemoteTaskExecutor", "unable to execute '{}': RemoteTaskExecutor still no initialized", fn_name);
 				throw infrastructure::InitializeError();
@@ -0,0 +1,119 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "../utils/noncopyable.h"
+#include "../utils/small_function.h"
+
+#include <condition_variable>
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+namespace pisk
+{
+namespace tools
+{
+	//Work-stealing executor: every worker owns a queue per priority and takes the work of others when idle.
+	//A task posted from a worker goes to the queue of this worker, a task from other threads is spread round-robin.
+	//Tasks must not block for long: a blocked task holds the worker and the pool does not grow.
+	class EXPORT ThreadPool final :
+		public utils::noncopyable
+	{
+	public:
+		enum class Priority : std::uint8_t
+		{
+			High,
+			Normal,
+			Low,
+		};
+
+		using Task = utils::small_function<void ()>;
+		using Clock = std::chrono::steady_clock;
+
+		//The process-wide pool with default_threads_count() workers; it is created on the first call
+		static ThreadPool& shared();
+
+		//The count of hardware threads, at least one
+		static std::size_t default_threads_count();
+
+		explicit ThreadPool(const std::size_t threads_count = default_threads_count());
+
+		//Runs all the queued tasks and joins the workers
+		~ThreadPool();
+
+		std::size_t threads_count() const;
+
+		//Is the current thread the worker of this pool
+		bool is_worker_thread() const threadsafe;
+
+		void post(Task task, const Priority priority = Priority::Normal) threadsafe;
+
+		//Posts the task when the delay is passed; the tasks which are not due are dropped with the pool
+		void post_after(const Clock::duration delay, Task task, const Priority priority = Priority::Normal) threadsafe;
+
+		template <typename Callee>
+		auto submit(Callee&& callee, const Priority priority = Priority::Normal) threadsafe -> std::future<decltype(callee())>
+		{
+			std::packaged_task<decltype(callee())()> task(std::forward<Callee>(callee));
+			auto out = task.get_future();
+			post(std::move(task), priority);
+			return out;
+		}
+
+		//Runs one queued task on the calling worker; a waiting worker helps instead of holding the thread.
+		//Returns false if the queues are empty or the thread is not the worker of this pool.
+		bool run_pending_task() threadsafe;
+
+	private:
+		static constexpr std::size_t priorities_count = 3;
+
+		struct worker;
+		struct timer
+		{
+			Clock::time_point due;
+			Priority priority;
+			Task task;
+		};
+
+		bool take(const std::size_t index, Task& out);
+		void post_due_timers();
+		void run(const std::size_t index);
+		void execute(Task& task);
+
+		std::vector<std::unique_ptr<worker>> workers;
+		std::atomic<std::size_t> next_worker {0};
+		std::atomic<std::size_t> pending {0};
+		std::atomic<std::size_t> sleeping {0};
+		std::mutex sleep_guard;
+		std::condition_variable wake;
+		bool stopping = false;
+		//a heap by `due`; `next_due` is the earliest one, so the workers check it without the lock
+		std::mutex timers_guard;
+		std::vector<timer> timers;
+		std::atomic<Clock::rep> next_due {no_timers};
+		static constexpr Clock::rep no_timers = Clock::duration::max().count();
+		std::vector<std::thread> threads;
+	};
+}
+}
+
@@ -18,6 +18,10 @@
 #include <string>
 #include <cstring>
 #include <cstdarg>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <array>
 #include <algorithm>
 #include <type_traits>
 
@@ -85,163 +89,383 @@ namespace string
 {
 	namespace details
 	{
-		constexpr const char hex_prefix[] = "0x";
-
-		template <typename TArg>
-		inline std::size_t get_to_string_size(const TArg&, std::enable_if_t<std::is_arithmetic<TArg>::value>* = 0)
-		{
-			static_assert(std::numeric_limits<TArg>::digits10 != 0, "qwe");
-			return std::numeric_limits<TArg>::digits10;
-		}
-		template <typename TArg>
-		inline std::size_t get_to_string_size(const TArg&, std::enable_if_t<std::is_enum<TArg>::value>* = 0)
+		//Placeholder: {} or {:[<|>][0][width][.precision][type]}, type is one of d x X f e E g G
+		struct spec
 		{
-			using subtype_t = std::underlying_type_t<TArg>;
-			static_assert(std::numeric_limits<subtype_t>::digits10 != 0, "qwe");
-			return std::numeric_limits<subtype_t>::digits10;
-		}
-		template <typename TArg>
-		inline std::size_t get_to_string_size(const TArg&, std::enable_if_t<std::is_pointer<TArg>::value>* = 0)
+			char align = 0;
+			bool zero = false;
+			std::size_t width = 0;
+			int precision = -1;
+			char type = 0;
+		};
+
+		//Output of the formatter: the first bytes are kept on the stack, longer strings go to the heap
+		class buffer
 		{
-			return sizeof(hex_prefix)-1 + get_to_string_size(static_cast<std::size_t>(0));
-		}
-		template <typename TArg>
-		inline std::size_t get_to_string_size(const TArg&, std::enable_if_t<std::is_same<TArg, bool>::value>* = 0)
+			char local[256];
+			std::unique_ptr<char[]> heap;
+			char* begin = local;
+			std::size_t length = 0;
+			std::size_t capacity = sizeof(local);
+
+		public:
+			buffer() = default;
+			buffer(const buffer&) = delete;
+			buffer& operator=(const buffer&) = delete;
+
+			const char* data() const
+			{
+				return begin;
+			}
+			std::size_t size() const
+			{
+				return length;
+			}
+
+			void reserve(const std::size_t extra)
+			{
+				if (length + extra <= capacity)
+					return;
+				const std::size_t new_capacity = std::max(capacity * 2, length + extra);
+				std::unique_ptr<char[]> storage(new char[new_capacity]);
+				std::memcpy(storage.get(), begin, length);
+				heap = std::move(storage);
+				begin = heap.get();
+				capacity = new_capacity;
+			}
+
+			void append(const char* text, const std::size_t count)
+			{
+				reserve(count);
+				std::memcpy(begin + length, text, count);
+				length += count;
+			}
+			void append(const std::size_t count, const char ch)
+			{
+				reserve(count);
+				std::memset(begin + length, ch, count);
+				length += count;
+			}
+			void push_back(const char ch)
+			{
+				reserve(1);
+				begin[length++] = ch;
+			}
+
+			//raw access for snprintf
+			char* tail()
+			{
+				return begin + length;
+			}
+			std::size_t available() const
+			{
+				return capacity - length;
+			}
+			void commit(const std::size_t count)
+			{
+				length += count;
+			}
+		};
+
+		inline std::size_t padding(const std::size_t size, const spec& s)
 		{
-			return 5;
+			return s.width > size ? s.width - size : 0;
 		}
-		inline std::size_t get_to_string_size(const char&)
+
+		inline void write_text(buffer& out, const char* text, std::size_t size, const spec& s)
 		{
-			return 1;
+			if (s.precision >= 0)
+				size = std::min(size, static_cast<std::size_t>(s.precision));
+			const std::size_t pad = padding(size, s);
+			if (s.align == '>')
+				out.append(pad, ' ');
+			out.append(text, size);
+			if (s.align != '>')
+				out.append(pad, ' ');
 		}
-		template <std::size_t N>
-		inline std::size_t get_to_string_size(const char (&arg)[N])
+
+		inline void write_integer(buffer& out, unsigned long long value, const bool negative, const bool pointer, const spec& s)
 		{
-			return N * get_to_string_size(arg[0]);
+			const bool hex = s.type == 'x' or s.type == 'X' or (pointer and s.type != 'd');
+			const unsigned base = hex ? 16 : 10;
+			const char* alphabet = s.type == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+
+			char digits[std::numeric_limits<unsigned long long>::digits10 + 2];
+			char* const end = digits + sizeof(digits);
+			char* begin = end;
+			do
+			{
+				*--begin = alphabet[value % base];
+				value /= base;
+			}
+			while (value != 0);
+
+			char prefix[2];
+			std::size_t prefix_size = 0;
+			if (negative)
+				prefix[prefix_size++] = '-';
+			else if (pointer and hex)
+			{
+				prefix[prefix_size++] = '0';
+				prefix[prefix_size++] = 'x';
+			}
+
+			const std::size_t size = end - begin;
+			const std::size_t pad = padding(prefix_size + size, s);
+			const bool left = s.align == '<';
+			const bool zeros = s.zero and not left;
+			if (not left and not zeros)
+				out.append(pad, ' ');
+			out.append(prefix, prefix_size);
+			if (zeros)
+				out.append(pad, '0');
+			out.append(begin, size);
+			if (left)
+				out.append(pad, ' ');
 		}
-		inline std::size_t get_to_string_size(const char* arg)
+
+		template <typename Float>
+		inline void write_floating(buffer& out, const Float value, const spec& s)
 		{
-			return std::strlen(arg);
+			char pattern[10];
+			std::size_t size = 0;
+			pattern[size++] = '%';
+			if (s.align == '<')
+				pattern[size++] = '-';
+			else if (s.zero)
+				pattern[size++] = '0';
+			pattern[size++] = '*';
+			pattern[size++] = '.';
+			pattern[size++] = '*';
+			if (std::is_same<Float, long double>::value)
+				pattern[size++] = 'L';
+			switch (s.type)
+			{
+			case 'e': case 'E': case 'g': case 'G':
+				pattern[size++] = s.type;
+				break;
+			case 'x':
+				pattern[size++] = 'a';
+				break;
+			case 'X':
+				pattern[size++] = 'A';
+				break;
+			default:
+				pattern[size++] = 'f';
+			}
+			pattern[size] = '\x0';
+
+			const int width = static_cast<int>(s.width);
+			int written = std::snprintf(out.tail(), out.available(), pattern, width, s.precision, value);
+			if (written < 0)
+				return;
+			if (static_cast<std::size_t>(written) >= out.available())
+			{
+				out.reserve(written + 1);
+				written = std::snprintf(out.tail(), out.available(), pattern, width, s.precision, value);
+			}
+			out.commit(written);
 		}
 
-		inline std::size_t get_to_string_size(const std::string& arg)
+		enum class kind
 		{
-			return arg.size();
-		}
+			boolean,
+			character,
+			integer,
+			floating,
+			enumeration,
+			text,
+			pointer,
+			other,
+		};
 
-		inline std::size_t get_total_size()
+		template <typename TArg>
+		constexpr kind kind_of()
 		{
-			return 0;
+			using type = std::decay_t<TArg>;
+			return
+				std::is_same<type, bool>::value ? kind::boolean :
+				std::is_same<type, char>::value ? kind::character :
+				std::is_integral<type>::value ? kind::integer :
+				std::is_floating_point<type>::value ? kind::floating :
+				std::is_enum<type>::value ? kind::enumeration :
+				std::is_same<type, const char*>::value or std::is_same<type, char*>::value ? kind::text :
+				std::is_same<type, std::string>::value ? kind::text :
+				std::is_pointer<type>::value ? kind::pointer :
+				kind::other;
 		}
+		template <kind Kind>
+		using kind_tag = std::integral_constant<kind, Kind>;
 
-		template <typename TArg, typename ... TArgs>
-		inline std::size_t get_total_size(const TArg& arg, const TArgs& ... args)
+		inline void write_value(buffer& out, const bool value, const spec& s, kind_tag<kind::boolean>)
 		{
-			return get_to_string_size(arg) + get_total_size(args...);
+			if (value)
+				write_text(out, "true", 4, s);
+			else
+				write_text(out, "false", 5, s);
 		}
-
-		template <typename TArg>
-		inline std::string to_string(const TArg& arg, std::enable_if_t<std::is_arithmetic<TArg>::value>* = 0)
+		inline void write_value(buffer& out, const char value, const spec& s, kind_tag<kind::character>)
 		{
-			return std::to_string(arg);
+			write_text(out, &value, 1, s);
 		}
 		template <typename TArg>
-		inline std::string to_string(const TArg& arg, std::enable_if_t<std::is_enum<TArg>::value>* = 0)
+		inline void write_value(buffer& out, const TArg value, const spec& s, kind_tag<kind::integer>)
 		{
-			using subtype_t = std::underlying_type_t<TArg>;
-			return to_string(static_cast<subtype_t>(arg));
+			const bool negative = value < 0;
+			const unsigned long long magnitude = static_cast<unsigned long long>(value);
+			write_integer(out, negative ? 0ull - magnitude : magnitude, negative, false, s);
 		}
 		template <typename TArg>
-		inline std::string to_string(const TArg& arg, std::enable_if_t<std::is_pointer<TArg>::value>* = 0)
+		inline void write_value(buffer& out, const TArg value, const spec& s, kind_tag<kind::floating>)
 		{
-			return hex_prefix + std::to_string(reinterpret_cast<std::size_t>(arg));
+			write_floating(out, value, s);
 		}
 		template <typename TArg>
-		inline std::string to_string(const TArg& arg, std::enable_if_t<std::is_same<TArg, bool>::value>* = 0)
+		inline void write_value(buffer& out, const TArg value, const spec& s, kind_tag<kind::enumeration>)
 		{
-			return arg ? "true" : "false";
+			using subtype_t = std::underlying_type_t<TArg>;
+			write_value(out, static_cast<subtype_t>(value), s, kind_tag<kind::integer>());
 		}
-		inline std::string to_string(const char& arg)
+		inline void write_value(buffer& out, const char* value, const spec& s, kind_tag<kind::text>)
 		{
-			return std::string(1, arg);
+			if (value == nullptr)
+				write_text(out, "nullptr", 7, s);
+			else
+				write_text(out, value, std::strlen(value), s);
 		}
-
-		template <std::size_t N>
-		inline std::string to_string(const char (&str)[N])
+		inline void write_value(buffer& out, const std::string& value, const spec& s, kind_tag<kind::text>)
 		{
-			return str;
+			write_text(out, value.data(), value.size(), s);
 		}
-		inline std::string to_string(const char* str)
+		inline void write_value(buffer& out, const void* value, const spec& s, kind_tag<kind::pointer>)
 		{
-			return str;
+			write_integer(out, reinterpret_cast<std::uintptr_t>(value), false, true, s);
 		}
-		inline std::string to_string(const std::string& arg)
+		//Other types are printed by the result of `to_string(value)` found by ADL
+		template <typename TArg>
+		inline void write_value(buffer& out, const TArg& value, const spec& s, kind_tag<kind::other>)
 		{
-			return arg;
+			const auto& text = to_string(value);
+			const std::size_t pad = padding(text.size(), s);
+			if (s.align == '>')
+				out.append(pad, ' ');
+			for (const char ch : text)
+				out.push_back(ch);
+			if (s.align != '>')
+				out.append(pad, ' ');
 		}
-		inline std::string to_string(std::string&& arg)
+
+		struct argument
 		{
-			return std::move(arg);
+			const void* value;
+			void (*write)(buffer& out, const void* value, const spec& s);
+		};
+
+		template <typename TArg>
+		inline void write_argument(buffer& out, const void* value, const spec& s)
+		{
+			write_value(out, *static_cast<const TArg*>(value), s, kind_tag<kind_of<TArg>()>());
 		}
 
 		template <typename TArg>
-		inline std::size_t to_string(std::string& out, std::size_t opos, const TArg& arg)
+		inline argument make_argument(const TArg& value)
 		{
-			const auto& tmp = to_string(arg);
-			for (const char& ch : tmp)
-				out[opos++] = ch;
-			return tmp.size();
+			return {&value, &write_argument<TArg>};
 		}
 
-		inline std::size_t format(const std::string& f, std::string& out, std::size_t fpos, std::size_t opos)
+		//Returns the position after the placeholder or nullptr if `pos` (the char after '{') does not start one
+		inline const char* parse_spec(const char* pos, const char* const end, spec& s)
 		{
-			const std::size_t count = f.size();
-			const std::size_t ocount = out.size();
-			for (;fpos != count; ++fpos)
+			if (pos != end and *pos == '}')
+				return pos + 1;
+			if (pos == end or *pos != ':')
+				return nullptr;
+			++pos;
+			if (pos != end and (*pos == '<' or *pos == '>'))
+				s.align = *pos++;
+			if (pos != end and *pos == '0')
+			{
+				s.zero = true;
+				++pos;
+			}
+			for (; pos != end and *pos >= '0' and *pos <= '9'; ++pos)
+				s.width = s.width * 10 + (*pos - '0');
+			if (pos != end and *pos == '.')
 			{
-				if (opos >= ocount)
-					throw infrastructure::OutOfRangeException();
-				out[opos++] = f[fpos];
+				s.precision = 0;
+				for (++pos; pos != end and *pos >= '0' and *pos <= '9'; ++pos)
+					s.precision = s.precision * 10 + (*pos - '0');
 			}
-			return opos;
+			if (pos != end and std::strchr("dxXfeEgG", *pos) != nullptr)
+				s.type = *pos++;
+			if (pos == end or *pos != '}')
+				return nullptr;
+			return pos + 1;
 		}
 
-		template <typename TArg, typename ... TArgs>
-		inline std::size_t format(const std::string& f, std::string& out, std::size_t fpos, std::size_t opos, TArg&& arg, TArgs&& ... args)
+		//One pass over the format: literal runs are copied as a whole, placeholders take the next argument.
+		//Placeholders without an argument left are kept as is.
+		inline void format(buffer& out, const char* pos, const char* const end, const argument* arg, const argument* const arg_end)
 		{
-			const std::size_t count = f.size();
-			const std::size_t ocount = out.size();
-			for (;fpos != count; ++fpos)
+			const char* literal = pos;
+			while (arg != arg_end)
 			{
-				const char ch = f[fpos];
-				if (ch == '\x0')
+				pos = static_cast<const char*>(std::memchr(pos, '{', end - pos));
+				if (pos == nullptr)
 					break;
-				if (ch == '{')
+				spec s;
+				const char* next = parse_spec(pos + 1, end, s);
+				if (next == nullptr)
 				{
-					if (f[fpos+1] == '}')
-					{
-						opos += to_string(out, opos, arg);
-						return format(f, out, fpos+2, opos, std::forward<TArgs>(args)...);
-					}
+					++pos;
+					continue;
 				}
-
-				if (opos >= ocount)
-					throw infrastructure::OutOfRangeException();
-
-				out[opos++] = ch;
+				out.append(literal, pos - literal);
+				arg->write(out, arg->value, s);
+				++arg;
+				pos = literal = next;
 			}
-			return opos;
+			out.append(literal, end - literal);
+		}
+
+		template <typename ... TArgs>
+		inline void format(buffer& out, const char* f, const std::size_t size, const TArgs& ... args)
+		{
+			const std::array<argument, sizeof...(TArgs)> arguments {{make_argument(args)...}};
+			format(out, f, f + size, arguments.data(), arguments.data() + arguments.size());
 		}
 	}//namespace details
 
+	//Appends the formatted string to `out`; a warmed up `out` is not reallocated
 	template <typename ... TArgs>
-	inline std::string format(const std::string& f, TArgs&& ... args)
+	inline void format_to(std::string& out, const std::string& f, const TArgs& ... args)
 	{
-		std::string out;
-		out.resize(f.size() + details::get_total_size(args...));
-		const std::size_t count = details::format(f, out, 0, 0, std::forward<TArgs>(args)...);
-		out.resize(count);
-		return out;
+		details::buffer tmp;
+		details::format(tmp, f.data(), f.size(), args...);
+		out.append(tmp.data(), tmp.size());
+	}
+	template <std::size_t N, typename ... TArgs>
+	inline void format_to(std::string& out, const char (&f)[N], const TArgs& ... args)
+	{
+		details::buffer tmp;
+		details::format(tmp, f, std::char_traits<char>::length(f), args...);
+		out.append(tmp.data(), tmp.size());
+	}
+
+	template <typename ... TArgs>
+	inline std::string format(const std::string& f, const TArgs& ... args)
+	{
+		details::buffer tmp;
+		details::format(tmp, f.data(), f.size(), args...);
+		return std::string(tmp.data(), tmp.size());
+	}
+	//The length of a literal is folded by the compiler, so the literal is not copied to std::string
+	template <std::size_t N, typename ... TArgs>
+	inline std::string format(const char (&f)[N], const TArgs& ... args)
+	{
+		details::buffer tmp;
+		details::format(tmp, f, std::char_traits<char>::length(f), args...);
+		return std::string(tmp.data(), tmp.size());
 	}
 }//namespace string
 
@@ -0,0 +1,62 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "../infrastructure/DataStream.h"
+
+#include "property_tree.h"
+
+#include <cstdint>
+
+namespace pisk
+{
+namespace utils
+{
+namespace binary
+{
+	//Binary form of utils::property. All numbers are little-endian, blocks are 4-byte aligned,
+	//so the buffer can be read in place (for example from a memory-mapped file).
+	//
+	//  header:     char magic[4] = "PSKB"; u16 version; u16 flags; u32 size;
+	//              u32 strings_count; u32 strings_offset; value root
+	//  value:      u32 tag (property::type); u32 payload:
+	//              bool, int, float - the value itself; long, double - offset of 8 bytes;
+	//              string - index in the string table; dictionary, array - offset of the block
+	//  strings:    u32 offsets[strings_count]; each string is u32 length, bytes, '\0'
+	//  dictionary: u32 count; {u32 key_index; value}[count], sorted by the key bytes
+	//  array:      u32 count; value[count]
+	constexpr std::uint16_t format_version = 1;
+	constexpr std::size_t header_size = 28;
+
+	//checks the magic and the version; `size` may be less than the whole document, but not less than header_size
+	bool EXPORT is_binary_property(const void* data, const std::size_t size) threadsafe noexcept;
+
+	utils::property EXPORT parse_binary_to_property(const void* data, const std::size_t size) threadsafe noexcept;
+	utils::property EXPORT parse_binary_to_property(const infrastructure::DataBuffer& content) threadsafe noexcept;
+	utils::property EXPORT parse_binary_to_property(const infrastructure::DataStream& data) threadsafe noexcept;
+
+	infrastructure::DataBuffer EXPORT to_binary(const utils::property& prop) threadsafe noexcept;
+
+	struct BinaryToPropertyLoader
+	{
+		typedef utils::property ParsedType;
+		static utils::property parse(const infrastructure::DataStream& data) noexcept
+		{
+			return parse_binary_to_property(data);
+		}
+	};
+}
+}
+}
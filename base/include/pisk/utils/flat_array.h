@@ -0,0 +1,395 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "slot_pool.h"
+
+#include <initializer_list>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace pisk
+{
+namespace utils
+{
+	//Array for the property tree: O(1) access by index, iteration in the order of indexes.
+	//It is not a contiguous array of values: a contiguous vector of pointers indexes the values kept in a slot_pool.
+	//That is deliberate, references to the elements stay valid while the array grows and after erase()
+	//(as with the std::map it replaced). The cost is one indirection per access and the values spread over
+	//O(log N) slabs instead of one block, so the iteration is not as cache friendly as over a std::vector.
+	//All memory is taken from the given memory_resource; a copy uses the default resource unless another one is passed.
+	//Indexes skipped by a sparse initialization are holes: they are not counted by size(),
+	//skipped by iteration and turn into elements on the first non-const access.
+	template <typename Value>
+	class flat_array
+	{
+	public:
+		using value_type = Value;
+		using size_type = std::size_t;
+
+	private:
+		slot_pool<Value> pool;
+		std::vector<Value*, resource_allocator<Value*>> items;
+		std::size_t holes = 0;
+
+		template <typename ValueRef>
+		class base_iterator
+		{
+			template <typename>
+			friend class base_iterator;
+
+			Value* const* first = nullptr;
+			Value* const* pos = nullptr;
+			Value* const* last = nullptr;
+
+			void skip_holes()
+			{
+				while (pos != last and *pos == nullptr)
+					++pos;
+			}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::remove_reference_t<ValueRef>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = value_type*;
+			using reference = ValueRef;
+
+			base_iterator() = default;
+			base_iterator(Value* const* first, Value* const* pos, Value* const* last):
+				first(first),
+				pos(pos),
+				last(last)
+			{
+				skip_holes();
+			}
+			template <typename OtherRef>
+			base_iterator(const base_iterator<OtherRef>& other):
+				first(other.first),
+				pos(other.pos),
+				last(other.last)
+			{}
+
+			std::size_t index() const
+			{
+				return pos - first;
+			}
+
+			reference operator*() const
+			{
+				return **pos;
+			}
+			pointer operator->() const
+			{
+				return *pos;
+			}
+			base_iterator& operator++()
+			{
+				++pos;
+				skip_holes();
+				return *this;
+			}
+			base_iterator operator++(int)
+			{
+				base_iterator out(*this);
+				++*this;
+				return out;
+			}
+			template <typename OtherRef>
+			bool operator == (const base_iterator<OtherRef>& other) const
+			{
+				return pos == other.pos;
+			}
+			template <typename OtherRef>
+			bool operator != (const base_iterator<OtherRef>& other) const
+			{
+				return pos != other.pos;
+			}
+		};
+
+	public:
+		using iterator = base_iterator<Value&>;
+		using const_iterator = base_iterator<const Value&>;
+
+		flat_array():
+			flat_array(new_delete_resource())
+		{}
+		explicit flat_array(memory_resource* resource):
+			pool(resource),
+			items(resource)
+		{}
+
+		flat_array(const flat_array& other, memory_resource* resource = new_delete_resource()):
+			flat_array(resource)
+		{
+			assign(other);
+		}
+		flat_array(flat_array&& other) noexcept:
+			flat_array(other.get_resource())
+		{
+			swap(other);
+		}
+		flat_array(std::initializer_list<std::pair<std::size_t, Value>> values, memory_resource* resource = new_delete_resource()):
+			flat_array(resource)
+		{
+			for (const auto& value : values)
+			{
+				if (value.first >= extent())
+				{
+					holes += value.first + 1 - extent();
+					items.resize(value.first + 1, nullptr);
+				}
+				if (items[value.first] == nullptr)
+					at(value.first) = value.second;
+			}
+		}
+		~flat_array()
+		{
+			clear();
+		}
+
+		flat_array& operator=(const flat_array& other)
+		{
+			if (this != &other)
+			{
+				clear();
+				assign(other);
+			}
+			return *this;
+		}
+		flat_array& operator=(flat_array&& other) noexcept
+		{
+			flat_array tmp(std::move(other));
+			swap(tmp);
+			return *this;
+		}
+
+		void swap(flat_array& other) noexcept
+		{
+			pool.swap(other.pool);
+			items.swap(other.items);
+			std::swap(holes, other.holes);
+		}
+
+		memory_resource* get_resource() const
+		{
+			return pool.get_resource();
+		}
+
+		//count of elements; holes are not counted
+		std::size_t size() const
+		{
+			return items.size() - holes;
+		}
+		//index past the last element
+		std::size_t extent() const
+		{
+			return items.size();
+		}
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		void reserve(const std::size_t count)
+		{
+			pool.reserve(count > size() ? count - size() : 0);
+			items.reserve(count);
+		}
+
+		//new elements are default constructed; the growth is geometric, so an array can be filled by resize(extent() + 1)
+		void resize(const std::size_t count)
+		{
+			while (extent() > count)
+				pop_back();
+			if (count > items.capacity())
+				reserve(std::max(count, items.capacity() * 2));
+			while (extent() < count)
+				emplace_back();
+		}
+
+		void clear() noexcept
+		{
+			for (Value* item : items)
+				if (item != nullptr)
+					pool.destroy(item);
+			items.clear();
+			holes = 0;
+			pool.release();
+		}
+
+		iterator begin()
+		{
+			return iterator(items.data(), items.data(), items.data() + items.size());
+		}
+		iterator end()
+		{
+			return iterator(items.data(), items.data() + items.size(), items.data() + items.size());
+		}
+		const_iterator begin() const
+		{
+			return const_iterator(items.data(), items.data(), items.data() + items.size());
+		}
+		const_iterator end() const
+		{
+			return const_iterator(items.data(), items.data() + items.size(), items.data() + items.size());
+		}
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		bool contains(const std::size_t index) const
+		{
+			return index < extent() and items[index] != nullptr;
+		}
+
+		//index have to refer to an element, not to a hole
+		Value& operator[](const std::size_t index)
+		{
+			return *items[index];
+		}
+		const Value& operator[](const std::size_t index) const
+		{
+			return *items[index];
+		}
+
+		//index have to be less than extent(); a hole turns into a default constructed element
+		Value& at(const std::size_t index)
+		{
+			Value*& item = items[index];
+			if (item == nullptr)
+			{
+				item = create_item(uses_memory_resource<Value>{});
+				--holes;
+			}
+			return *item;
+		}
+		//index have to be less than extent(); returns nullptr for a hole
+		const Value* get(const std::size_t index) const
+		{
+			return items[index];
+		}
+
+		template <typename ... TArgs>
+		Value& emplace_back(TArgs&& ... args)
+		{
+			if (items.size() == items.capacity())
+				items.reserve(std::max<std::size_t>(4, items.capacity() * 2));
+			Value* item = create_item(uses_memory_resource<Value>{}, std::forward<TArgs>(args)...);
+			items.push_back(item);
+			return *item;
+		}
+		void push_back(const Value& value)
+		{
+			emplace_back(value);
+		}
+		void push_back(Value&& value)
+		{
+			emplace_back(std::move(value));
+		}
+		void pop_back()
+		{
+			if (items.back() != nullptr)
+				pool.destroy(items.back());
+			else
+				--holes;
+			items.pop_back();
+		}
+
+		//the following elements (and holes) shift down by one
+		void erase(const std::size_t index)
+		{
+			Value* item = items[index];
+			items.erase(items.begin() + index);
+			if (item != nullptr)
+				pool.destroy(item);
+			else
+				--holes;
+		}
+
+		//the element turns into a hole; the following elements keep their indexes
+		void reset(const std::size_t index)
+		{
+			Value*& item = items[index];
+			if (item == nullptr)
+				return;
+			pool.destroy(item);
+			item = nullptr;
+			++holes;
+		}
+
+		bool operator == (const flat_array& other) const
+		{
+			if (extent() != other.extent() or size() != other.size())
+				return false;
+			for (std::size_t index = 0; index < extent(); ++index)
+			{
+				const Value* left = items[index];
+				const Value* right = other.items[index];
+				if (left == nullptr or right == nullptr)
+				{
+					if (left != right)
+						return false;
+				}
+				else if (not (*left == *right))
+					return false;
+			}
+			return true;
+		}
+		bool operator != (const flat_array& other) const
+		{
+			return not (*this == other);
+		}
+
+	private:
+		template <typename ... TArgs>
+		Value* create_item(std::false_type, TArgs&& ... args)
+		{
+			return pool.create(std::forward<TArgs>(args)...);
+		}
+		template <typename ... TArgs>
+		Value* create_item(std::true_type, TArgs&& ... args)
+		{
+			Value* item = pool.create(*get_resource());
+			try
+			{
+				assign_constructed(*item, std::forward<TArgs>(args)...);
+			}
+			catch (...)
+			{
+				pool.destroy(item);
+				throw;
+			}
+			return item;
+		}
+
+		void assign(const flat_array& other)
+		{
+			reserve(other.size());
+			items.reserve(other.extent());
+			for (const Value* item : other.items)
+				items.push_back(item == nullptr ? nullptr : create_item(uses_memory_resource<Value>{}, *item));
+			holes = other.holes;
+		}
+	};
+}
+}
@@ -0,0 +1,516 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "slot_pool.h"
+
+#include <initializer_list>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <cstdint>
+#include <vector>
+#include <tuple>
+
+namespace pisk
+{
+namespace utils
+{
+	//Associative container for the property tree: a vector of (hash, entry) pairs in insertion order
+	//plus an open addressing table over the precomputed hashes (linear probing, load factor up to 1/2).
+	//Entries live in a slot_pool, so references to values stay valid until the entry is erased (as with std::map).
+	//Erase leaves a tombstone in the index and the table slots keep their positions, so it costs O(1);
+	//the index is compacted when the tombstones make up more than half of it.
+	//Small maps have no table and are searched linearly over the contiguous hashes.
+	//Iteration follows the insertion order and a copy keeps it, so it is deterministic; a caller which
+	//needs the keys sorted (a serializer, for example) sorts them on its own. All memory is taken from
+	//the given memory_resource; a copy uses the default resource unless another one is passed.
+	template <typename Key, typename Value, typename Hash = std::hash<Key>>
+	class flat_map
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<const Key, Value>;
+		using size_type = std::size_t;
+
+	private:
+		//entry is nullptr for an erased one
+		struct index_entry
+		{
+			std::size_t hash;
+			value_type* entry;
+		};
+
+		//up to this size a linear search over the hashes is faster than probing
+		static constexpr std::size_t linear_limit = 8;
+
+		slot_pool<value_type> pool;
+		std::vector<index_entry, resource_allocator<index_entry>> index;
+		//position in the index plus one; 0 is an empty slot
+		std::vector<std::uint32_t, resource_allocator<std::uint32_t>> table;
+		std::size_t shift = 0;
+		std::size_t erased = 0;
+
+		template <typename ValueRef>
+		class base_iterator
+		{
+			template <typename>
+			friend class base_iterator;
+			friend class flat_map;
+
+			const index_entry* pos = nullptr;
+			const index_entry* last = nullptr;
+
+			void skip_erased()
+			{
+				while (pos != last and pos->entry == nullptr)
+					++pos;
+			}
+
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = std::remove_reference_t<ValueRef>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = value_type*;
+			using reference = ValueRef;
+
+			base_iterator() = default;
+			base_iterator(const index_entry* pos, const index_entry* last):
+				pos(pos),
+				last(last)
+			{
+				skip_erased();
+			}
+			template <typename OtherRef>
+			base_iterator(const base_iterator<OtherRef>& other):
+				pos(other.pos),
+				last(other.last)
+			{}
+
+			reference operator*() const
+			{
+				return *pos->entry;
+			}
+			pointer operator->() const
+			{
+				return pos->entry;
+			}
+			base_iterator& operator++()
+			{
+				++pos;
+				skip_erased();
+				return *this;
+			}
+			base_iterator operator++(int)
+			{
+				base_iterator out = *this;
+				++*this;
+				return out;
+			}
+			//begin() points to a live entry, so there is one before any other position
+			base_iterator& operator--()
+			{
+				--pos;
+				while (pos->entry == nullptr)
+					--pos;
+				return *this;
+			}
+			base_iterator operator--(int)
+			{
+				base_iterator out = *this;
+				--*this;
+				return out;
+			}
+			template <typename OtherRef>
+			bool operator == (const base_iterator<OtherRef>& other) const
+			{
+				return pos == other.pos;
+			}
+			template <typename OtherRef>
+			bool operator != (const base_iterator<OtherRef>& other) const
+			{
+				return pos != other.pos;
+			}
+		};
+
+	public:
+		using iterator = base_iterator<value_type&>;
+		using const_iterator = base_iterator<const value_type&>;
+
+		flat_map():
+			flat_map(new_delete_resource())
+		{}
+		explicit flat_map(memory_resource* resource):
+			pool(resource),
+			index(resource),
+			table(resource)
+		{}
+
+		flat_map(const flat_map& other, memory_resource* resource = new_delete_resource()):
+			flat_map(resource)
+		{
+			assign(other);
+		}
+		flat_map(flat_map&& other) noexcept:
+			flat_map(other.get_resource())
+		{
+			swap(other);
+		}
+		flat_map(std::initializer_list<value_type> values, memory_resource* resource = new_delete_resource()):
+			flat_map(resource)
+		{
+			reserve(values.size());
+			for (const value_type& value : values)
+				emplace(value.first, value.second);
+		}
+		~flat_map()
+		{
+			clear();
+		}
+
+		flat_map& operator=(const flat_map& other)
+		{
+			if (this != &other)
+			{
+				clear();
+				assign(other);
+			}
+			return *this;
+		}
+		flat_map& operator=(flat_map&& other) noexcept
+		{
+			flat_map tmp(std::move(other));
+			swap(tmp);
+			return *this;
+		}
+
+		void swap(flat_map& other) noexcept
+		{
+			pool.swap(other.pool);
+			index.swap(other.index);
+			table.swap(other.table);
+			std::swap(shift, other.shift);
+			std::swap(erased, other.erased);
+		}
+
+		memory_resource* get_resource() const
+		{
+			return pool.get_resource();
+		}
+
+		std::size_t size() const
+		{
+			return index.size() - erased;
+		}
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		void reserve(const std::size_t count)
+		{
+			pool.reserve(count > size() ? count - size() : 0);
+			index.reserve(count);
+			if (count > linear_limit and table.size() < count * 2)
+				rehash(table_size_for(count));
+		}
+
+		void clear() noexcept
+		{
+			for (const index_entry& item : index)
+				if (item.entry != nullptr)
+					pool.destroy(item.entry);
+			index.clear();
+			table.clear();
+			shift = 0;
+			erased = 0;
+			pool.release();
+		}
+
+		iterator begin()
+		{
+			return make_iterator(index.data());
+		}
+		iterator end()
+		{
+			return make_iterator(index_end());
+		}
+		const_iterator begin() const
+		{
+			return make_iterator(index.data());
+		}
+		const_iterator end() const
+		{
+			return make_iterator(index_end());
+		}
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		//lookup accepts any type which Hash and Key::operator== accept (for example a literal or a c-string),
+		//so there is no need to construct a temporary Key
+		template <typename K>
+		iterator find(const K& key)
+		{
+			return make_iterator(lookup(Hash{}(key), key));
+		}
+		template <typename K>
+		const_iterator find(const K& key) const
+		{
+			return make_iterator(lookup(Hash{}(key), key));
+		}
+		template <typename K>
+		std::size_t count(const K& key) const
+		{
+			return find(key) == end() ? 0 : 1;
+		}
+
+		template <typename K>
+		Value& operator[](const K& key)
+		{
+			return emplace(key).first->second;
+		}
+
+		template <typename K, typename ... TArgs>
+		std::pair<iterator, bool> emplace(const K& key, TArgs&& ... args)
+		{
+			const std::size_t hash = Hash{}(key);
+			const index_entry* found = lookup(hash, key);
+			if (found != index_end())
+				return {make_iterator(found), false};
+
+			if (index.size() == index.capacity())
+				index.reserve(std::max<std::size_t>(4, index.capacity() * 2));
+			value_type* entry = create_entry(uses_memory_resource<Value>{}, key, std::forward<TArgs>(args)...);
+			index.push_back(index_entry{hash, entry});
+			if (not table.empty() and index.size() * 2 <= table.size())
+				place(index.size() - 1);
+			else if (index.size() > linear_limit)
+				rehash(table_size_for(index.size()));
+			return {make_iterator(index_end() - 1), true};
+		}
+
+		iterator erase(iterator pos)
+		{
+			return erase(const_iterator(pos));
+		}
+		iterator erase(const_iterator pos)
+		{
+			std::size_t offset = static_cast<std::size_t>(pos.pos - index.data());
+			value_type* entry = index[offset].entry;
+			if (not table.empty())
+				unplace(offset);
+			index[offset].entry = nullptr;
+			++erased;
+			pool.destroy(entry);
+			//the tombstones at the end go away at once
+			while (not index.empty() and index.back().entry == nullptr)
+			{
+				index.pop_back();
+				--erased;
+			}
+			if (erased * 2 > index.size())
+			{
+				offset = compact(offset);
+				if (not table.empty())
+					rehash(table.size());
+			}
+			return make_iterator(index.data() + std::min(offset, index.size()));
+		}
+		template <typename K>
+		std::size_t erase(const K& key)
+		{
+			const_iterator pos = find(key);
+			if (pos == end())
+				return 0;
+			erase(pos);
+			return 1;
+		}
+
+		bool operator == (const flat_map& other) const
+		{
+			if (size() != other.size())
+				return false;
+			for (const index_entry& item : index)
+			{
+				if (item.entry == nullptr)
+					continue;
+				const index_entry* found = other.lookup(item.hash, item.entry->first);
+				if (found == other.index_end() or not (found->entry->second == item.entry->second))
+					return false;
+			}
+			return true;
+		}
+		bool operator != (const flat_map& other) const
+		{
+			return not (*this == other);
+		}
+
+	private:
+		void assign(const flat_map& other)
+		{
+			pool.reserve(other.size());
+			index.reserve(other.size());
+			for (const index_entry& item : other.index)
+				if (item.entry != nullptr)
+					index.push_back(index_entry{item.hash, create_entry(uses_memory_resource<Value>{}, item.entry->first, item.entry->second)});
+			if (other.erased != 0)
+			{
+				if (not other.table.empty())
+					rehash(other.table.size());
+				return;
+			}
+			table.assign(other.table.begin(), other.table.end());
+			shift = other.shift;
+		}
+
+		const index_entry* index_end() const
+		{
+			return index.data() + index.size();
+		}
+		iterator make_iterator(const index_entry* pos)
+		{
+			return iterator(pos, index_end());
+		}
+		const_iterator make_iterator(const index_entry* pos) const
+		{
+			return const_iterator(pos, index_end());
+		}
+
+		//Drops the tombstones from the index keeping the order; returns the new position of `offset`.
+		//The table has to be rebuilt after
+		std::size_t compact(const std::size_t offset)
+		{
+			std::size_t moved_offset = 0;
+			std::size_t live = 0;
+			for (std::size_t position = 0; position < index.size(); ++position)
+			{
+				if (position == offset)
+					moved_offset = live;
+				if (index[position].entry != nullptr)
+					index[live++] = index[position];
+			}
+			if (offset >= index.size())
+				moved_offset = live;
+			index.resize(live);
+			erased = 0;
+			return moved_offset;
+		}
+
+		template <typename K, typename ... TArgs>
+		value_type* create_entry(std::false_type, const K& key, TArgs&& ... args)
+		{
+			return pool.create(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<TArgs>(args)...));
+		}
+		template <typename K, typename ... TArgs>
+		value_type* create_entry(std::true_type, const K& key, TArgs&& ... args)
+		{
+			value_type* entry = pool.create(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(*get_resource()));
+			try
+			{
+				assign_constructed(entry->second, std::forward<TArgs>(args)...);
+			}
+			catch (...)
+			{
+				pool.destroy(entry);
+				throw;
+			}
+			return entry;
+		}
+
+		static std::size_t table_size_for(const std::size_t count)
+		{
+			std::size_t size = 16;
+			while (size < count * 2)
+				size *= 2;
+			return size;
+		}
+
+		//Fibonacci hashing: the high bits of the product depend on all bits of the hash
+		std::size_t home(const std::size_t hash) const
+		{
+			constexpr std::size_t golden = sizeof(std::size_t) >= 8 ? static_cast<std::size_t>(0x9E3779B97F4A7C15ULL) : static_cast<std::size_t>(0x9E3779B9UL);
+			return (hash * golden) >> shift;
+		}
+
+		void rehash(const std::size_t size)
+		{
+			if (erased != 0)
+				compact(index.size());
+			table.assign(size, 0);
+			shift = sizeof(std::size_t) * 8;
+			for (std::size_t bits = size; bits > 1; bits /= 2)
+				--shift;
+			for (std::size_t position = 0; position < index.size(); ++position)
+				place(position);
+		}
+
+		void place(const std::size_t position)
+		{
+			const std::size_t mask = table.size() - 1;
+			std::size_t slot = home(index[position].hash);
+			while (table[slot] != 0)
+				slot = (slot + 1) & mask;
+			table[slot] = static_cast<std::uint32_t>(position + 1);
+		}
+
+		//backward shift deletion keeps the probe sequences of the table without tombstones
+		void unplace(const std::size_t position)
+		{
+			const std::size_t mask = table.size() - 1;
+			std::size_t hole = home(index[position].hash);
+			while (table[hole] != position + 1)
+				hole = (hole + 1) & mask;
+			for (std::size_t next = (hole + 1) & mask; table[next] != 0; next = (next + 1) & mask)
+			{
+				const std::size_t wanted = home(index[table[next] - 1].hash);
+				if (((next - wanted) & mask) >= ((next - hole) & mask))
+				{
+					table[hole] = table[next];
+					hole = next;
+				}
+			}
+			table[hole] = 0;
+		}
+
+		template <typename K>
+		const index_entry* lookup(const std::size_t hash, const K& key) const
+		{
+			if (table.empty())
+			{
+				for (const index_entry& item : index)
+					if (item.hash == hash and item.entry != nullptr and item.entry->first == key)
+						return &item;
+				return index_end();
+			}
+			const std::size_t mask = table.size() - 1;
+			for (std::size_t slot = home(hash); table[slot] != 0; slot = (slot + 1) & mask)
+			{
+				const index_entry& item = index[table[slot] - 1];
+				if (item.hash == hash and item.entry->first == key)
+					return &item;
+			}
+			return index_end();
+		}
+	};
+}
+}
@@ -18,6 +18,9 @@
 
 #include "property_tree.h"
 
+#include <cstdint>
+#include <memory>
+
 namespace pisk
 {
 namespace utils
@@ -27,9 +30,187 @@ namespace json
 	utils::property EXPORT parse_json_to_property(const std::string& document) threadsafe noexcept;
 	utils::property EXPORT parse_json_to_property(const infrastructure::DataBuffer& content) threadsafe noexcept;
 	utils::property EXPORT parse_json_to_property(const infrastructure::DataStream& data) threadsafe noexcept;
+	utils::property EXPORT parse_json_to_property(const char* data, const std::size_t size) threadsafe noexcept;
+
+	//Appends the json text of the property to `out`. Keep the buffer between calls and clear() it:
+	//the capacity stays, so serializing in a loop does not allocate. `pretty` adds new lines and tabs.
+	void EXPORT write(const utils::property& prop, std::string& out, const bool pretty = false) threadsafe noexcept;
+	void EXPORT write(const utils::property& prop, infrastructure::DataBuffer& out, const bool pretty = false) threadsafe noexcept;
 
 	std::string EXPORT to_string(const utils::property& prop) threadsafe noexcept;
 
+	namespace details
+	{
+		struct json_document;
+	}
+
+	class lazy_property_iterator;
+
+	//Read-only view of a json document which parses values only when they are reached.
+	//A structural index of the objects and arrays is built once over the raw bytes; operator[] and iteration
+	//scan only the members of the container they are called for and skip nested containers by the index.
+	//materialize() converts the value into utils::property with the same rules as parse_json_to_property.
+	//The view shares the document, copies are cheap and may be used from several threads.
+	//Differences with the eager parser: a broken structure (unbalanced brackets, unterminated strings or
+	//too deep nesting) makes the whole document none; the duplicated keys are all visited by the iteration,
+	//while operator[] returns the last one; a broken scalar is reported only when it is materialized.
+	class EXPORT lazy_property
+	{
+		friend class lazy_property_iterator;
+
+		std::shared_ptr<const details::json_document> document;
+		std::uint32_t begin_offset = 0;
+		std::uint32_t end_offset = 0;
+		std::uint32_t node = UINT32_MAX;
+
+		lazy_property find(const char* key, const std::size_t size) const;
+		lazy_property find(const std::size_t index) const;
+
+	public:
+		lazy_property() = default;
+		//the document is built by parse_json_to_lazy_property
+		lazy_property(const std::shared_ptr<const details::json_document>& document, const std::uint32_t begin, const std::uint32_t end, const std::uint32_t node);
+
+		property::type get_type() const;
+
+		bool is_none() const {
+			return get_type() == property::type::_none;
+		}
+		bool is_bool() const {
+			return get_type() == property::type::_bool;
+		}
+		bool is_double() const {
+			return get_type() == property::type::_double;
+		}
+		bool is_string() const {
+			return get_type() == property::type::_string;
+		}
+		bool is_dictionary() const {
+			return get_type() == property::type::_dictionary;
+		}
+		bool is_array() const {
+			return get_type() == property::type::_array;
+		}
+
+		bool as_bool() const {
+			return materialize().as_bool();
+		}
+		double as_double() const {
+			return materialize().as_double();
+		}
+		const std::string as_string() const {
+			return materialize().as_string();
+		}
+		const keystring as_keystring() const {
+			return materialize().as_keystring();
+		}
+
+		//the value if it has the type of the fallback, the fallback otherwise; only a matched scalar is materialized
+		bool get_or(const bool fallback) const {
+			return is_bool() ? as_bool() : fallback;
+		}
+		double get_or(const double fallback) const {
+			return is_double() ? as_double() : fallback;
+		}
+		std::string get_or(const std::string& fallback) const {
+			return is_string() ? as_string() : fallback;
+		}
+		std::string get_or(const char* fallback) const {
+			return is_string() ? as_string() : std::string(fallback);
+		}
+		keystring get_or(const keystring& fallback) const {
+			return is_string() ? as_keystring() : fallback;
+		}
+
+		//walks the container
+		std::size_t size() const;
+
+		lazy_property operator [](const char* key) const {
+			return find(key, std::char_traits<char>::length(key));
+		}
+		lazy_property operator [](const std::string& key) const {
+			return find(key.data(), key.size());
+		}
+		lazy_property operator [](const keystring_literal& key) const {
+			return find(key.str, key.size);
+		}
+		lazy_property operator [](const keystring& key) const {
+			return find(key.data(), key.size());
+		}
+		//walks the array up to the item
+		lazy_property operator [](const std::size_t index) const {
+			return find(index);
+		}
+
+		bool contains(const char* key) const {
+			return operator[](key).document != nullptr;
+		}
+		bool contains(const std::string& key) const {
+			return operator[](key).document != nullptr;
+		}
+		bool contains(const keystring_literal& key) const {
+			return operator[](key).document != nullptr;
+		}
+		bool contains(const keystring& key) const {
+			return operator[](key).document != nullptr;
+		}
+
+		lazy_property_iterator begin() const;
+		lazy_property_iterator end() const;
+
+		utils::property materialize() const;
+	};
+
+	class EXPORT lazy_property_iterator
+	{
+		friend class lazy_property;
+
+		std::shared_ptr<const details::json_document> document;
+		std::uint32_t position = UINT32_MAX;//the first byte of the current item, UINT32_MAX at the end
+		std::uint32_t resume = 0;
+		std::uint32_t close = 0;
+		std::uint32_t cursor = 0;
+		bool dictionary = false;
+		std::size_t index = 0;
+		std::uint32_t key_begin = 0;
+		std::uint32_t key_end = 0;
+		lazy_property current;
+
+		lazy_property_iterator(const std::shared_ptr<const details::json_document>& document, const std::uint32_t node);
+		void scan();
+
+	public:
+		lazy_property_iterator() = default;
+
+		keystring get_key() const;
+		std::size_t get_index() const {
+			return index;
+		}
+
+		const lazy_property& operator*() const {
+			return current;
+		}
+		const lazy_property* operator->() const {
+			return &current;
+		}
+		lazy_property_iterator& operator++() {
+			++index;
+			scan();
+			return *this;
+		}
+		bool operator==(const lazy_property_iterator& other) const {
+			return document == other.document and position == other.position;
+		}
+		bool operator!=(const lazy_property_iterator& other) const {
+			return not (*this == other);
+		}
+	};
+
+	lazy_property EXPORT parse_json_to_lazy_property(infrastructure::DataBuffer&& content) threadsafe noexcept;
+	lazy_property EXPORT parse_json_to_lazy_property(const std::string& document) threadsafe noexcept;
+	lazy_property EXPORT parse_json_to_lazy_property(const infrastructure::DataBuffer& content) threadsafe noexcept;
+	lazy_property EXPORT parse_json_to_lazy_property(const infrastructure::DataStream& data) threadsafe noexcept;
+
 	struct JsonToPropertyLoader
 	{
 		typedef utils::property ParsedType;
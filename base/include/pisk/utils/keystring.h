@@ -14,8 +14,11 @@
 #pragma once
 
 #include <functional>
-#include <memory>
+#include <cstring>
+#include <atomic>
+#include <string>
 
+#include "../defines.h"
 #include "../infrastructure/Exception.h"
 #include "algorithm_utils.h"
 
@@ -23,125 +26,223 @@ namespace pisk
 {
 namespace utils
 {
-	class keystring
+	//FNV-1a; constexpr to hash literals at compile time
+	constexpr std::size_t calc_keystring_hash(const char* str, const std::size_t size)
+	{
+		constexpr bool is64 = sizeof(std::size_t) >= 8;
+		const std::size_t prime = is64 ? static_cast<std::size_t>(1099511628211ULL) : static_cast<std::size_t>(16777619UL);
+		std::size_t hash = is64 ? static_cast<std::size_t>(14695981039346656037ULL) : static_cast<std::size_t>(2166136261UL);
+		for (std::size_t index = 0; index < size; ++index)
+			hash = (hash ^ static_cast<unsigned char>(str[index])) * prime;
+		return hash;
+	}
+
+	//"children"_ks: a string literal with the hash calculated at compile time
+	struct keystring_literal
 	{
-		std::shared_ptr<const std::string> content;
+		const char* str;
+		std::size_t size;
 		std::size_t hash;
+	};
+
+	namespace details
+	{
+		struct keystring_content
+		{
+			mutable std::atomic<std::size_t> refs;
+			const std::size_t hash;
+			const bool interned;
+			const std::string str;
 
-		static std::size_t calc_hash(const std::string& str)
+			keystring_content(const std::size_t hash, const bool interned, std::string&& str):
+				refs(1),
+				hash(hash),
+				interned(interned),
+				str(std::move(str))
+			{}
+		};
+
+		//Global table: one content per string; it lives until the end of the process
+		const keystring_content* EXPORT intern_keystring(const char* str, const std::size_t size, const std::size_t hash) threadsafe;
+	}
+
+	//Immutable string with the precomputed hash.
+	//Regular keystrings share the content by an atomic counter; interned keystrings (literals and intern())
+	//point to the global table: copying is free and two interned keystrings are equal only if they are the same pointer.
+	class keystring
+	{
+		const details::keystring_content* content = nullptr;
+
+		constexpr static std::size_t empty_hash()
 		{
-			std::hash<std::string> hasher;
-			return hasher(str);
+			return calc_keystring_hash("", 0);
 		}
-		static std::size_t get_empty_hash()
+
+		static const details::keystring_content* make(std::string&& str)
 		{
-			static std::size_t hash = calc_hash("");
-			return hash;
+			if (str.empty())
+				return nullptr;
+			const std::size_t hash = calc_keystring_hash(str.data(), str.size());
+			return new details::keystring_content(hash, false, std::move(str));
+		}
+		void acquire() const
+		{
+			if (content != nullptr and not content->interned)
+				content->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+		void release()
+		{
+			if (content != nullptr and not content->interned)
+				if (content->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					delete content;
+			content = nullptr;
 		}
 
 	public:
 		using value_type = std::string::value_type;
 		using const_interator = std::string::const_iterator;
 
-		keystring() :
-			hash(get_empty_hash())
-		{}
+		keystring() = default;
 		keystring(const char* str) :
-			content(std::make_shared<const std::string>(str == nullptr ? "" : str)),
-			hash(calc_hash(*content))
+			content(str == nullptr ? nullptr : make(std::string(str)))
 		{}
 		explicit keystring(std::string&& str) :
-			content(std::make_shared<const std::string>(std::move(str))),
-			hash(calc_hash(*content))
+			content(make(std::move(str)))
 		{}
 		explicit keystring(const std::string& str) :
-			content(std::make_shared<const std::string>(str)),
-			hash(calc_hash(*content))
+			content(make(std::string(str)))
 		{}
-		keystring(const keystring& str) = default;
+		keystring(const keystring_literal& literal) :
+			content(details::intern_keystring(literal.str, literal.size, literal.hash))
+		{}
+		keystring(const keystring& str) :
+			content(str.content)
+		{
+			acquire();
+		}
+		keystring(keystring&& str) noexcept :
+			content(str.content)
+		{
+			str.content = nullptr;
+		}
+		~keystring()
+		{
+			release();
+		}
+
+		keystring& operator=(const keystring& str)
+		{
+			str.acquire();
+			release();
+			content = str.content;
+			return *this;
+		}
+		keystring& operator=(keystring&& str) noexcept
+		{
+			std::swap(content, str.content);
+			return *this;
+		}
+
+		//interned copy of the string; use it for keys which live long and compared often
+		static keystring intern(const std::string& str)
+		{
+			keystring out;
+			out.content = details::intern_keystring(str.data(), str.size(), calc_keystring_hash(str.data(), str.size()));
+			return out;
+		}
+		keystring intern() const
+		{
+			if (content == nullptr or content->interned)
+				return *this;
+			return intern(content->str);
+		}
+		bool is_interned() const {
+			return content == nullptr or content->interned;
+		}
 
 		bool empty() const {
-			return hash == get_empty_hash() && (content == nullptr || content->empty());
+			return content == nullptr;
 		}
 		std::size_t size() const {
-			return content == nullptr ? 0 : content->size();
+			return content == nullptr ? 0 : content->str.size();
 		}
 		std::size_t get_hash() const {
-			return hash;
+			return content == nullptr ? empty_hash() : content->hash;
 		}
 		const std::string& get_content() const {
 			static const std::string empty;
 			if (content == nullptr)
 				return empty;
-			return *content;
+			return content->str;
 		}
 		const std::string& operator*() const {
 			return get_content();
 		}
 		const char* c_str() const {
-			return content == nullptr ? "" : content->c_str();
+			return get_content().c_str();
 		}
 		const char* data() const {
-			return content == nullptr ? "" : content->data();
+			return get_content().data();
 		}
 
 		const_interator begin() const
 		{
-			if (content == nullptr)
-				return {};
-			return content->begin();
+			return get_content().begin();
 		}
 		const_interator end() const
 		{
-			if (content == nullptr)
-				return {};
-			return content->end();
+			return get_content().end();
 		}
 
 		bool operator == (const keystring& str) const {
-			if (this == &str)
+			if (content == str.content)
 				return true;
-			if (hash != str.hash)
+			if (content == nullptr or str.content == nullptr)
 				return false;
-			if (content == nullptr)
-				return str.content == nullptr || str.content->empty();
-			if (str.content == nullptr)
-				return content->empty();
-			return *content == *str.content;
+			if (content->hash != str.content->hash)
+				return false;
+			if (content->interned and str.content->interned)
+				return false;
+			return content->str == str.content->str;
+		}
+		bool operator == (const keystring_literal& other) const {
+			if (get_hash() != other.hash or size() != other.size)
+				return false;
+			return std::memcmp(data(), other.str, other.size) == 0;
 		}
 		bool operator == (const std::string& other) const {
-			if (content == nullptr)
-				return other == "";
-			return *content == other;
+			return get_content() == other;
 		}
 		bool operator == (const char* other) const {
-			if ((content == nullptr or content->empty())
-			    and (other == nullptr or *other == '\x0'))
-				return true;
-			if (other == nullptr or content == nullptr)
-				return false;
-			return *content == other;
+			if (other == nullptr)
+				return empty();
+			return get_content() == other;
 		}
 		template <typename Other>
 		bool operator != (const Other& other) const {
 			return not (*this == other);
 		}
 
+		//ordered by hash; strings with the same hash are ordered by content
 		bool operator < (const keystring& str) const {
-			return hash < str.hash;
+			if (get_hash() != str.get_hash())
+				return get_hash() < str.get_hash();
+			if (content == str.content)
+				return false;
+			return get_content() < str.get_content();
 		}
 
 		keystring operator + (const keystring& str) const {
-			return keystring {*content + *str.content};
+			return keystring {get_content() + str.get_content()};
 		}
 		keystring operator + (const char* str) const {
 			if (str == nullptr or *str == '\x0')
 				return *this;
-			return keystring {*content + str};
+			return keystring {get_content() + str};
 		}
 		template <typename Other>
 		keystring operator + (const Other& other) const {
-			return keystring {*content + other};
+			return keystring {get_content() + other};
 		}
 
 		template <typename Other, typename = typename utils::disable_if<std::is_same<Other, keystring>::value>::type>
@@ -158,20 +259,15 @@ namespace utils
 		friend keystring operator + (const char* left, const keystring& right) {
 			if (left == nullptr or *left == '\x0')
 				return right;
-			return keystring {left + *right.content};
+			return keystring {left + right.get_content()};
 		}
 		template <typename Other>
 		friend keystring operator + (const Other& left, const keystring& right)
 		{
-			return keystring {left + *right.content};
+			return keystring {left + right.get_content()};
 		}
 	};
 
-	inline std::size_t get_to_string_size(const keystring& arg)
-	{
-		return arg.size();
-	}
-
 	inline keystring to_string(const keystring& arg)
 	{
 		return arg;
@@ -179,13 +275,30 @@ namespace utils
 }
 }
 
+namespace pisk
+{
+	constexpr utils::keystring_literal operator"" _ks(const char* str, const std::size_t size)
+	{
+		return {str, size, utils::calc_keystring_hash(str, size)};
+	}
+}
+
 namespace std
 {
 	template<>
 	struct hash < pisk::utils::keystring >
 	{
-		std::size_t operator()(const pisk::utils::keystring& key) {
+		std::size_t operator()(const pisk::utils::keystring& key) const {
 			return key.get_hash();
 		}
+		std::size_t operator()(const pisk::utils::keystring_literal& key) const {
+			return key.hash;
+		}
+		std::size_t operator()(const std::string& key) const {
+			return pisk::utils::calc_keystring_hash(key.data(), key.size());
+		}
+		std::size_t operator()(const char* key) const {
+			return key == nullptr ? pisk::utils::calc_keystring_hash("", 0) : pisk::utils::calc_keystring_hash(key, std::strlen(key));
+		}
 	};
 }
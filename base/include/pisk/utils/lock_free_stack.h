@@ -13,13 +13,21 @@
 
 #pragma once
 
+#include "../defines.h"
+
+#include <cstddef>
 #include <atomic>
-#include <thread>
 
 namespace pisk
 {
 namespace utils
 {
+	//Lock-free LIFO for any count of threads.
+	//A popped node is neither reused nor deleted while another thread is inside pop(): it waits in the retired list,
+	//the last thread leaving pop() recycles the retired nodes. So a thread never reads a deleted node and never
+	//mistakes a node which was popped and pushed again for the one it has read (ABA).
+	//Free nodes are kept for the next pushes up to `max_free_nodes`, the others are deleted.
+	//If pop() is never left by all threads at once the retired nodes wait for the quiet moment.
 	template <typename type>
 	class lock_free_stack
 	{
@@ -27,14 +35,23 @@ namespace utils
 
 		struct node_t
 		{
-			node_t* next;
+			std::atomic<node_t*> next;
 			value_t value;
 		};
 
 		std::atomic<node_t*> root{nullptr};
 		std::atomic<node_t*> free_nodes{nullptr};
+		std::atomic<node_t*> retired{nullptr};
+		std::atomic<std::size_t> readers{0};
+		std::atomic<std::size_t> free_count{0};
+		const std::size_t max_free_nodes;
 
 	public:
+		constexpr static std::size_t default_max_free_nodes = 256;
+
+		explicit lock_free_stack(const std::size_t max_free_nodes = default_max_free_nodes):
+			max_free_nodes(max_free_nodes)
+		{}
 
 		~lock_free_stack()
 		{
@@ -42,117 +59,147 @@ namespace utils
 			shrink();
 		}
 
-		void clear()
+		void clear() threadsafe
 		{
 			value_t tmp;
 			while (pop(tmp))
 				;
 		}
 
+		//Deletes the free nodes; no other thread may use the stack meanwhile
 		void shrink()
 		{
-			release_free_nodes();
+			delete_nodes(free_nodes.exchange(nullptr));
+			delete_nodes(retired.exchange(nullptr));
+			free_count = 0;
+		}
+
+		std::size_t free_nodes_count() const threadsafe
+		{
+			return free_count.load(std::memory_order_relaxed);
 		}
 
-		void push(const value_t& value)
+		void push(const value_t& value) threadsafe
 		{
 			push(value_t{value});
 		}
 
-		void push(value_t&& value)
+		void push(value_t&& value) threadsafe
 		{
 			node_t* new_root = allocate_node(std::move(value));
-			push(new_root);
+			push(root, new_root);
 		}
 
-		bool pop(value_t& value)
+		bool pop(value_t& value) threadsafe
 		{
-			node_t* ptr = pop();
-			if (ptr == nullptr)
-				return false;
-
-			value = std::move(ptr->value);
-			deallocate_node(ptr);
-			return true;
+			++readers;
+			node_t* ptr = pop(root);
+			if (ptr != nullptr)
+				value = std::move(ptr->value);
+			leave(ptr);
+			return ptr != nullptr;
 		}
 
 	private:
-		void push(node_t* ptr)
+		static void push(std::atomic<node_t*>& list, node_t* ptr)
 		{
-			for (;;)
-			{
-				node_t* node = root.load();
-				ptr->next = node;
-				if (root.compare_exchange_weak(node, ptr))
-					return;
-
-				std::this_thread::yield();
-			}
+			push(list, ptr, ptr);
 		}
 
-		node_t* pop()
+		static void push(std::atomic<node_t*>& list, node_t* first, node_t* last)
 		{
-			for (;;)
-			{
-				node_t* node = root.load();
-				if (node == nullptr)
-					return nullptr;
+			node_t* node = list.load();
+			do
+				last->next.store(node, std::memory_order_relaxed);
+			while (not list.compare_exchange_weak(node, first));
+		}
 
-				if (root.compare_exchange_weak(node, node->next))
-					return node;
+		//the caller has to be counted in `readers`: the node read here may be popped by other thread
+		static node_t* pop(std::atomic<node_t*>& list)
+		{
+			node_t* node = list.load();
+			while (node != nullptr and not list.compare_exchange_weak(node, node->next.load(std::memory_order_relaxed)))
+				;
+			return node;
+		}
 
-				std::this_thread::yield();
+		//The last reader takes the retired nodes; nobody can hold a pointer to them any more
+		void leave(node_t* popped)
+		{
+			if (readers.load() == 1)
+			{
+				node_t* nodes = retired.load() == nullptr ? nullptr : retired.exchange(nullptr);
+				if (--readers == 0)
+					recycle_nodes(nodes);
+				else if (nodes != nullptr)
+					retire_nodes(nodes);
+				//other readers have come after `popped` was unlinked
+				if (popped != nullptr)
+					recycle_node(popped);
+			}
+			else
+			{
+				if (popped != nullptr)
+					push(retired, popped);
+				--readers;
 			}
 		}
 
 	private:
 		node_t* allocate_node(value_t&& value)
 		{
-			for (;;)
+			node_t* node = nullptr;
+			if (free_nodes.load() != nullptr)
 			{
-				node_t* node = free_nodes.load();
-				if (node == nullptr)
-					return new node_t{nullptr, std::move(value)};
-
-				if (free_nodes.compare_exchange_weak(node, node->next))
-					return new (node) node_t{nullptr, std::move(value)};
-
-				std::this_thread::yield();
+				++readers;
+				node = pop(free_nodes);
+				leave(nullptr);
 			}
+			if (node == nullptr)
+				return new node_t{{nullptr}, std::move(value)};
+
+			free_count.fetch_sub(1, std::memory_order_relaxed);
+			node->value = std::move(value);
+			return node;
 		}
 
-		void deallocate_node(node_t* ptr)
+		void recycle_node(node_t* ptr)
 		{
-			for (;;)
-			{
-				node_t* node = free_nodes.load();
-				ptr->next = node;
-				if (free_nodes.compare_exchange_weak(node, ptr))
-					return;
+			if (free_count.fetch_add(1, std::memory_order_relaxed) < max_free_nodes)
+				return push(free_nodes, ptr);
 
-				std::this_thread::yield();
-			}
+			free_count.fetch_sub(1, std::memory_order_relaxed);
+			delete ptr;
 		}
 
-		void release_free_nodes()
+		void recycle_nodes(node_t* nodes)
 		{
-			for (;;)
+			while (nodes != nullptr)
 			{
-				node_t* node = free_nodes.load();
-				if (node == nullptr)
-					return;
+				node_t* next = nodes->next.load(std::memory_order_relaxed);
+				recycle_node(nodes);
+				nodes = next;
+			}
+		}
 
-				if (free_nodes.compare_exchange_weak(node, node->next))
-				{
-					delete node;
-					continue;
-				}
+		void retire_nodes(node_t* nodes)
+		{
+			node_t* last = nodes;
+			while (node_t* next = last->next.load(std::memory_order_relaxed))
+				last = next;
+			push(retired, nodes, last);
+		}
 
-				std::this_thread::yield();
+		static void delete_nodes(node_t* nodes)
+		{
+			while (nodes != nullptr)
+			{
+				node_t* next = nodes->next.load(std::memory_order_relaxed);
+				delete nodes;
+				nodes = next;
 			}
 		}
 	};
 
 }//namespace utils
 }//namespace pisk
-
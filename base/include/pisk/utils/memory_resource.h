@@ -0,0 +1,265 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "noncopyable.h"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <new>
+
+namespace pisk
+{
+namespace utils
+{
+	//The same idea as std::pmr::memory_resource (not available for C++14)
+	class memory_resource
+	{
+	public:
+		constexpr static std::size_t max_align = alignof(std::max_align_t);
+
+		virtual ~memory_resource() {}
+
+		virtual void* allocate(const std::size_t bytes, const std::size_t alignment = max_align) = 0;
+		virtual void deallocate(void* ptr, const std::size_t bytes, const std::size_t alignment = max_align) noexcept = 0;
+
+		bool is_equal(const memory_resource& other) const noexcept
+		{
+			return this == &other;
+		}
+	};
+
+	class new_delete_resource_impl :
+		public memory_resource
+	{
+	public:
+		virtual void* allocate(const std::size_t bytes, const std::size_t) final override
+		{
+			return ::operator new(bytes);
+		}
+		virtual void deallocate(void* ptr, const std::size_t, const std::size_t) noexcept final override
+		{
+			::operator delete(ptr);
+		}
+	};
+
+	inline memory_resource* new_delete_resource() noexcept
+	{
+		static new_delete_resource_impl resource;
+		return &resource;
+	}
+
+	//Arena: memory is taken from the upstream by growing chunks; deallocate() does nothing;
+	//everything is returned to the upstream by release() or by the destructor.
+	//Not threadsafe: one arena per a builder (for example a patch prepared during an engine tick)
+	class monotonic_resource :
+		public memory_resource,
+		public noncopyable,
+		public nonmoveable
+	{
+		struct chunk
+		{
+			chunk* next;
+			std::size_t size;
+		};
+		constexpr static std::size_t header_size = (sizeof(chunk) + max_align - 1) / max_align * max_align;
+
+		memory_resource* upstream;
+		const std::size_t initial_size;
+		std::size_t next_size;
+		chunk* chunks = nullptr;
+		char* current = nullptr;
+		std::size_t left = 0;
+
+	public:
+		explicit monotonic_resource(const std::size_t initial_size = 4096, memory_resource* upstream = new_delete_resource()):
+			upstream(upstream),
+			initial_size(std::max<std::size_t>(initial_size, max_align)),
+			next_size(this->initial_size)
+		{}
+		virtual ~monotonic_resource()
+		{
+			release();
+		}
+
+		memory_resource* upstream_resource() const
+		{
+			return upstream;
+		}
+
+		void release() noexcept
+		{
+			while (chunks != nullptr)
+			{
+				chunk* next = chunks->next;
+				upstream->deallocate(chunks, chunks->size);
+				chunks = next;
+			}
+			current = nullptr;
+			left = 0;
+			next_size = initial_size;
+		}
+
+		virtual void* allocate(const std::size_t bytes, const std::size_t alignment) final override
+		{
+			const std::size_t padding = (alignment - reinterpret_cast<std::size_t>(current) % alignment) % alignment;
+			if (current == nullptr or padding + bytes > left)
+				return allocate_from_new_chunk(bytes, alignment);
+			void* out = current + padding;
+			current += padding + bytes;
+			left -= padding + bytes;
+			return out;
+		}
+		virtual void deallocate(void*, const std::size_t, const std::size_t) noexcept final override
+		{}
+
+	private:
+		void* allocate_from_new_chunk(const std::size_t bytes, const std::size_t alignment)
+		{
+			const std::size_t size = std::max(next_size, header_size + bytes + alignment);
+			chunk* c = static_cast<chunk*>(upstream->allocate(size));
+			c->next = chunks;
+			c->size = size;
+			chunks = c;
+			next_size = size * 2;
+
+			current = reinterpret_cast<char*>(c) + header_size;
+			left = size - header_size;
+			return allocate(bytes, alignment);
+		}
+	};
+
+	//std::allocator interface over memory_resource; the resource follows the container on move and swap
+	template <typename T>
+	class resource_allocator
+	{
+		template <typename>
+		friend class resource_allocator;
+
+		memory_resource* resource;
+
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		resource_allocator(memory_resource* resource = new_delete_resource()) noexcept:
+			resource(resource)
+		{}
+		template <typename U>
+		resource_allocator(const resource_allocator<U>& other) noexcept:
+			resource(other.resource)
+		{}
+
+		memory_resource* get_resource() const noexcept
+		{
+			return resource;
+		}
+
+		T* allocate(const std::size_t count)
+		{
+			return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+		}
+		void deallocate(T* ptr, const std::size_t count) noexcept
+		{
+			resource->deallocate(ptr, count * sizeof(T), alignof(T));
+		}
+
+		template <typename U>
+		bool operator == (const resource_allocator<U>& other) const noexcept
+		{
+			return resource->is_equal(*other.resource);
+		}
+		template <typename U>
+		bool operator != (const resource_allocator<U>& other) const noexcept
+		{
+			return not (*this == other);
+		}
+	};
+
+	//Types which are constructible from `memory_resource&` take the resource of their container
+	//(like the uses-allocator construction of std::pmr)
+	template <typename T>
+	struct uses_memory_resource :
+		std::is_constructible<T, memory_resource&>
+	{};
+
+	template <typename T>
+	void assign_constructed(T&)
+	{}
+	template <typename T, typename Arg>
+	void assign_constructed(T& value, Arg&& arg)
+	{
+		value = std::forward<Arg>(arg);
+	}
+	template <typename T, typename Arg1, typename Arg2, typename ... TArgs>
+	void assign_constructed(T& value, Arg1&& arg1, Arg2&& arg2, TArgs&& ... args)
+	{
+		value = T(std::forward<Arg1>(arg1), std::forward<Arg2>(arg2), std::forward<TArgs>(args)...);
+	}
+
+	//Single objects which remember the resource they were allocated from
+	namespace details
+	{
+		struct object_header
+		{
+			memory_resource* resource;
+		};
+		constexpr std::size_t object_header_size = (sizeof(object_header) + memory_resource::max_align - 1) / memory_resource::max_align * memory_resource::max_align;
+
+		inline object_header* header_of(const void* object)
+		{
+			return reinterpret_cast<object_header*>(const_cast<char*>(static_cast<const char*>(object)) - object_header_size);
+		}
+	}
+
+	template <typename T, typename ... TArgs>
+	T* new_object(memory_resource& resource, TArgs&& ... args)
+	{
+		static_assert(alignof(T) <= memory_resource::max_align, "over-aligned types are not supported");
+		void* memory = resource.allocate(details::object_header_size + sizeof(T));
+		static_cast<details::object_header*>(memory)->resource = &resource;
+		void* object = static_cast<char*>(memory) + details::object_header_size;
+		try
+		{
+			return new (object) T(std::forward<TArgs>(args)...);
+		}
+		catch (...)
+		{
+			resource.deallocate(memory, details::object_header_size + sizeof(T));
+			throw;
+		}
+	}
+
+	template <typename T>
+	memory_resource& object_resource(const T* object) noexcept
+	{
+		return *details::header_of(object)->resource;
+	}
+
+	template <typename T>
+	void delete_object(T* object) noexcept
+	{
+		if (object == nullptr)
+			return;
+		details::object_header* header = details::header_of(object);
+		object->~T();
+		header->resource->deallocate(header, details::object_header_size + sizeof(T));
+	}
+}
+}
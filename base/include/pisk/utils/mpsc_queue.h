@@ -0,0 +1,368 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "noncopyable.h"
+
+#include <condition_variable>
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <mutex>
+
+namespace pisk
+{
+namespace utils
+{
+namespace details
+{
+	//Sleeping of the single consumer: producers touch the mutex only when the consumer waits
+	class consumer_waiter
+	{
+		std::mutex guard;
+		std::condition_variable signal;
+		std::atomic<bool> waiting {false};
+		bool woken = false;
+
+	public:
+		//producer side, after the item is published
+		void notify()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (not waiting.load(std::memory_order_relaxed))
+				return;
+			std::unique_lock<std::mutex> lock(guard);
+			signal.notify_one();
+		}
+
+		//interrupts the current or the next wait
+		void wakeup()
+		{
+			std::unique_lock<std::mutex> lock(guard);
+			woken = true;
+			signal.notify_one();
+		}
+
+		//returns true if the data is ready: false on timeout or wakeup()
+		template <typename Ready, typename Rep, typename Period>
+		bool wait(const std::chrono::duration<Rep, Period>& timeout, Ready&& ready)
+		{
+			std::unique_lock<std::mutex> lock(guard);
+			waiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			signal.wait_for(lock, timeout, [this, &ready]() {
+				return woken or ready();
+			});
+			waiting.store(false, std::memory_order_relaxed);
+			woken = false;
+			return ready();
+		}
+	};
+
+	template <typename Data>
+	class item_storage
+	{
+		typename std::aligned_storage<sizeof(Data), alignof(Data)>::type storage;
+
+	public:
+		template <typename Value>
+		void construct(Value&& value)
+		{
+			new (&storage) Data(std::forward<Value>(value));
+		}
+		Data take()
+		{
+			Data& data = *reinterpret_cast<Data*>(&storage);
+			Data out(std::move(data));
+			data.~Data();
+			return out;
+		}
+		void destroy()
+		{
+			reinterpret_cast<Data*>(&storage)->~Data();
+		}
+	};
+}//namespace details
+
+	//Unbounded lock-free queue for many producers and one consumer (D. Vyukov's intrusive MPSC list).
+	//push() is one exchange; pop(), pop_all(), wait_pop(), wait() and empty() are for the consumer thread only.
+	//A push is visible to the consumer once the producer links its node, so the queue may look empty
+	//for a moment while a preempted producer is between the exchange and the link.
+	template <typename Data>
+	class mpsc_queue :
+		public noncopyable,
+		public nonmoveable
+	{
+		struct node
+		{
+			std::atomic<node*> next {nullptr};
+			details::item_storage<Data> item;
+		};
+
+		//the producers' and the consumer's ends are kept on different cache lines
+		std::atomic<node*> head;
+		char head_padding[64];
+		node* tail;
+		details::consumer_waiter waiter;
+
+	public:
+		mpsc_queue():
+			head(new node),
+			tail(head.load())
+		{}
+
+		~mpsc_queue()
+		{
+			while (node* next = tail->next.load(std::memory_order_relaxed))
+			{
+				delete tail;
+				tail = next;
+				tail->item.destroy();
+			}
+			delete tail;
+		}
+
+		void push(Data&& data) threadsafe
+		{
+			link(new_node(std::move(data)));
+		}
+		void push(const Data& data) threadsafe
+		{
+			link(new_node(data));
+		}
+
+		bool pop(Data& out)
+		{
+			node* next = tail->next.load(std::memory_order_acquire);
+			if (next == nullptr)
+				return false;
+			out = next->item.take();
+			delete tail;
+			tail = next;
+			return true;
+		}
+
+		//Moves all the available items to the end of `out`; returns the count of them
+		std::size_t pop_all(std::vector<Data>& out)
+		{
+			std::size_t count = 0;
+			for (node* next = tail->next.load(std::memory_order_acquire); next != nullptr; next = tail->next.load(std::memory_order_acquire))
+			{
+				out.emplace_back(next->item.take());
+				delete tail;
+				tail = next;
+				++count;
+			}
+			return count;
+		}
+
+		//Waits for an item up to `timeout` or until wakeup()
+		template <typename Rep, typename Period>
+		bool wait_pop(Data& out, const std::chrono::duration<Rep, Period>& timeout)
+		{
+			if (pop(out))
+				return true;
+			wait(timeout);
+			return pop(out);
+		}
+
+		//Waits for an item without taking it; false on timeout or wakeup()
+		template <typename Rep, typename Period>
+		bool wait(const std::chrono::duration<Rep, Period>& timeout)
+		{
+			return waiter.wait(timeout, [this]() {
+				return not empty();
+			});
+		}
+
+		void wakeup() threadsafe
+		{
+			waiter.wakeup();
+		}
+
+		bool empty() const
+		{
+			return tail->next.load(std::memory_order_acquire) == nullptr;
+		}
+
+	private:
+		template <typename Value>
+		static node* new_node(Value&& value)
+		{
+			std::unique_ptr<node> out(new node);
+			out->item.construct(std::forward<Value>(value));
+			return out.release();
+		}
+
+		void link(node* item)
+		{
+			node* prev = head.exchange(item, std::memory_order_acq_rel);
+			prev->next.store(item, std::memory_order_release);
+			waiter.notify();
+		}
+	};
+
+	//Bounded lock-free queue for many producers and one consumer: a ring of slots with sequence numbers.
+	//push() fails when the ring is full; nothing is allocated after the construction.
+	template <typename Data>
+	class bounded_mpsc_queue :
+		public noncopyable,
+		public nonmoveable
+	{
+		struct slot
+		{
+			std::atomic<std::size_t> sequence;
+			details::item_storage<Data> item;
+		};
+
+		std::unique_ptr<slot[]> slots;
+		const std::size_t mask;
+		std::atomic<std::size_t> tail {0};
+		char tail_padding[64];
+		std::size_t head = 0;
+		details::consumer_waiter waiter;
+
+	public:
+		//the capacity is rounded up to a power of two
+		explicit bounded_mpsc_queue(const std::size_t capacity):
+			slots(new slot[round_capacity(capacity)]),
+			mask(round_capacity(capacity) - 1)
+		{
+			for (std::size_t index = 0; index <= mask; ++index)
+				slots[index].sequence.store(index, std::memory_order_relaxed);
+		}
+
+		~bounded_mpsc_queue()
+		{
+			while (ready())
+			{
+				slots[head & mask].item.destroy();
+				++head;
+			}
+		}
+
+		std::size_t capacity() const
+		{
+			return mask + 1;
+		}
+
+		bool push(Data&& data) threadsafe
+		{
+			return emplace(std::move(data));
+		}
+		bool push(const Data& data) threadsafe
+		{
+			return emplace(data);
+		}
+
+		bool pop(Data& out)
+		{
+			if (not ready())
+				return false;
+			slot& item = slots[head & mask];
+			out = item.item.take();
+			item.sequence.store(head + mask + 1, std::memory_order_release);
+			++head;
+			return true;
+		}
+
+		std::size_t pop_all(std::vector<Data>& out)
+		{
+			std::size_t count = 0;
+			while (ready())
+			{
+				slot& item = slots[head & mask];
+				out.emplace_back(item.item.take());
+				item.sequence.store(head + mask + 1, std::memory_order_release);
+				++head;
+				++count;
+			}
+			return count;
+		}
+
+		template <typename Rep, typename Period>
+		bool wait_pop(Data& out, const std::chrono::duration<Rep, Period>& timeout)
+		{
+			if (pop(out))
+				return true;
+			wait(timeout);
+			return pop(out);
+		}
+
+		template <typename Rep, typename Period>
+		bool wait(const std::chrono::duration<Rep, Period>& timeout)
+		{
+			return waiter.wait(timeout, [this]() {
+				return ready();
+			});
+		}
+
+		void wakeup() threadsafe
+		{
+			waiter.wakeup();
+		}
+
+		bool empty() const
+		{
+			return not ready();
+		}
+
+	private:
+		static std::size_t round_capacity(const std::size_t capacity)
+		{
+			std::size_t out = 2;
+			while (out < capacity)
+				out *= 2;
+			return out;
+		}
+
+		bool ready() const
+		{
+			return slots[head & mask].sequence.load(std::memory_order_acquire) == head + 1;
+		}
+
+		template <typename Value>
+		bool emplace(Value&& value)
+		{
+			std::size_t position = tail.load(std::memory_order_relaxed);
+			while (true)
+			{
+				slot& item = slots[position & mask];
+				const std::size_t sequence = item.sequence.load(std::memory_order_acquire);
+				const std::intptr_t lag = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+				if (lag == 0)
+				{
+					if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						item.item.construct(std::forward<Value>(value));
+						item.sequence.store(position + 1, std::memory_order_release);
+						waiter.notify();
+						return true;
+					}
+				}
+				else if (lag < 0)
+					return false;
+				else
+					position = tail.load(std::memory_order_relaxed);
+			}
+		}
+	};
+
+}//namespace utils
+}//namespace pisk
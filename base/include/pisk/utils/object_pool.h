@@ -0,0 +1,130 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "noncopyable.h"
+#include "lock_free_stack.h"
+
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+#include <atomic>
+#include <memory>
+#include <new>
+
+namespace pisk
+{
+namespace utils
+{
+	//Recycles memory of objects between threads without the global allocator:
+	//make() constructs an object in a kept block, the deleter of the pointer destroys the object and keeps the block.
+	//Up to `capacity` blocks are kept, the others are deleted. The pool have to outlive its objects.
+	template <typename type>
+	class object_pool :
+		public noncopyable,
+		public nonmoveable
+	{
+		using block_t = typename std::aligned_storage<sizeof(type), alignof(type)>::type;
+
+		lock_free_stack<void*> blocks;
+		std::atomic<std::size_t> kept {0};
+		const std::size_t max_blocks;
+
+	public:
+		class deleter
+		{
+			object_pool* pool = nullptr;
+
+		public:
+			deleter() = default;
+			explicit deleter(object_pool* pool):
+				pool(pool)
+			{}
+
+			void operator()(type* object) const
+			{
+				pool->release(object);
+			}
+		};
+		using pointer = std::unique_ptr<type, deleter>;
+
+		constexpr static std::size_t default_capacity = 64;
+
+		explicit object_pool(const std::size_t capacity = default_capacity):
+			blocks(capacity),
+			max_blocks(capacity)
+		{}
+
+		~object_pool()
+		{
+			void* block = nullptr;
+			while (blocks.pop(block))
+				delete static_cast<block_t*>(block);
+		}
+
+		std::size_t capacity() const
+		{
+			return max_blocks;
+		}
+
+		//count of the kept blocks
+		std::size_t size() const threadsafe
+		{
+			return kept.load(std::memory_order_relaxed);
+		}
+
+		template <typename ... TArgs>
+		pointer make(TArgs&& ... args) threadsafe
+		{
+			void* block = take_block();
+			try
+			{
+				return pointer(new (block) type(std::forward<TArgs>(args)...), deleter(this));
+			}
+			catch (...)
+			{
+				put_block(block);
+				throw;
+			}
+		}
+
+	private:
+		void release(type* object) threadsafe
+		{
+			object->~type();
+			put_block(object);
+		}
+
+		void* take_block()
+		{
+			void* block = nullptr;
+			if (not blocks.pop(block))
+				return new block_t;
+			kept.fetch_sub(1, std::memory_order_relaxed);
+			return block;
+		}
+
+		void put_block(void* block)
+		{
+			if (kept.fetch_add(1, std::memory_order_relaxed) < max_blocks)
+				return blocks.push(block);
+
+			kept.fetch_sub(1, std::memory_order_relaxed);
+			delete static_cast<block_t*>(block);
+		}
+	};
+
+}//namespace utils
+}//namespace pisk
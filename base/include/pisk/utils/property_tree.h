@@ -15,12 +15,17 @@
 #pragma once
 
 #include "keystring.h"
+#include "flat_map.h"
+#include "flat_array.h"
+#include "memory_resource.h"
 #include "../infrastructure/Exception.h"
 
 #include <assert.h>
 #include <cstring>
-#include <deque>
-#include <map>
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace pisk
 {
@@ -35,6 +40,31 @@ namespace utils
 	class PropertyIteratorTypeException : public infrastructure::Exception
 	{};
 
+	namespace details
+	{
+		//Heap storage of a property. Copies of the property share the storage until one of them is changed:
+		//the changed copy clones its own storage (one level; the nested storages stay shared).
+		//A storage is not shareable while mutable references to its items may be alive: the non-const
+		//operator[], begin() and end() make it so until seal(); replace() and apply_patch() keep no references,
+		//so they leave a shareable storage shareable.
+		//`markers` tells if the subtree contains patch markers; it is kept for a shareable storage only.
+		template <typename T>
+		struct property_storage
+		{
+			std::atomic<std::size_t> refs;
+			bool shareable;
+			bool markers = false;
+			T value;
+
+			template <typename ... TArgs>
+			explicit property_storage(TArgs&& ... args):
+				refs(1),
+				shareable(true),
+				value(std::forward<TArgs>(args)...)
+			{}
+		};
+	}
+
 	template <typename dict_iterator, typename arr_iterator, typename valuetype>
 	class property_base_iterator
 	{
@@ -62,14 +92,14 @@ namespace utils
 			arr(arr),
 			_type(iter_type::_array)
 		{}
-		keystring get_key() const {
+		const keystring& get_key() const {
 			if (_type == iter_type::_dictionary)
 				return dict->first;
 			throw PropertyIteratorTypeException();
 		}
 		std::size_t get_index() const {
 			if (_type == iter_type::_array)
-				return arr->first;
+				return arr.index();
 			throw PropertyIteratorTypeException();
 		}
 		explicit operator valuetype& ()
@@ -77,7 +107,7 @@ namespace utils
 			if (_type == iter_type::_dictionary)
 				return dict->second;
 			if (_type == iter_type::_array)
-				return arr->second;
+				return *arr;
 			throw PropertyIteratorTypeException();
 		}
 		explicit operator const valuetype& () const
@@ -85,7 +115,7 @@ namespace utils
 			if (_type == iter_type::_dictionary)
 				return dict->second;
 			if (_type == iter_type::_array)
-				return arr->second;
+				return *arr;
 			throw PropertyIteratorTypeException();
 		}
 		valuetype* operator->()
@@ -93,7 +123,7 @@ namespace utils
 			if (_type == iter_type::_dictionary)
 				return &dict->second;
 			if (_type == iter_type::_array)
-				return &arr->second;
+				return &*arr;
 			throw PropertyIteratorTypeException();
 		}
 		valuetype* operator->() const
@@ -101,7 +131,7 @@ namespace utils
 			if (_type == iter_type::_dictionary)
 				return &dict->second;
 			if (_type == iter_type::_array)
-				return &arr->second;
+				return &*arr;
 			throw PropertyIteratorTypeException();
 		}
 		valuetype& operator*() const
@@ -109,7 +139,7 @@ namespace utils
 			if (_type == iter_type::_dictionary)
 				return dict->second;
 			if (_type == iter_type::_array)
-				return arr->second;
+				return *arr;
 			throw PropertyIteratorTypeException();
 		}
 		property_base_iterator& operator ++()
@@ -150,6 +180,10 @@ namespace utils
 		}
 	};
 
+	//Copy of a property is O(1): the string, dictionary and array storages are shared between copies
+	//(if they use the same memory_resource) and a non-const access clones only the touched path.
+	//Mutable references returned by the property stay valid as usual; const references taken
+	//from a shared storage are related to the content before the next mutation of the owner.
 	class property
 	{
 	public:
@@ -165,8 +199,8 @@ namespace utils
 			_dictionary,
 			_array,
 		};
-		using dictionary = std::map<keystring, property>;
-		using array = std::map<std::size_t, property>;
+		using dictionary = flat_map<keystring, property>;
+		using array = flat_array<property>;
 
 		using property_iterator = property_base_iterator<dictionary::iterator, array::iterator, property>;
 		using property_const_iterator = property_base_iterator<dictionary::const_iterator, array::const_iterator, const property>;
@@ -175,15 +209,16 @@ namespace utils
 		type _type;
 		union t_union
 		{
+			memory_resource* _resource;
 			bool _bool;
 			int _int;
 			long _long;
 			float _float;
 			double _double;
-			keystring* _string;
-			dictionary* _dictionary;
-			array* _array;
-		}_union;
+			details::property_storage<keystring>* _string;
+			details::property_storage<dictionary>* _dictionary;
+			details::property_storage<array>* _array;
+		}_union = {nullptr};
 
 		void check_type(const type newtype) const
 		{
@@ -201,31 +236,138 @@ namespace utils
 			{
 				switch (_type)
 				{
-					case type::_string:     _union._string->~keystring(); break;
-					case type::_dictionary: _union._dictionary->clear();  break;
-					case type::_array:      _union._array->clear();       break;
+					case type::_dictionary: if (is_unique(_union._dictionary)) return clear_storage(_union._dictionary); break;
+					case type::_array:      if (is_unique(_union._array))      return clear_storage(_union._array);      break;
 					default: break;
 				};
 			}
-			else
+			memory_resource& resource = get_resource();
+			reset();
+			switch (newtype)
 			{
-				switch (_type)
-				{
-					case type::_string:     delete _union._string;     break;
-					case type::_dictionary: delete _union._dictionary; break;
-					case type::_array:      delete _union._array;      break;
-					default: break;
-				};
-				_type = newtype;
-				switch (_type)
-				{
-					case type::_none:       _union._string = nullptr;              break;
-					case type::_string:     _union._string = new keystring();      break;
-					case type::_dictionary: _union._dictionary = new dictionary(); break;
-					case type::_array:      _union._array = new array();           break;
-					default: break;
-				};
+				case type::_string:     _union._string = make_storage<keystring>(resource);                 break;
+				case type::_dictionary: _union._dictionary = make_storage<dictionary>(resource, &resource); break;
+				case type::_array:      _union._array = make_storage<array>(resource, &resource);           break;
+				default: break;
+			};
+			_type = newtype;
+		}
+		void reset() noexcept
+		{
+			memory_resource& resource = get_resource();
+			switch (_type)
+			{
+				case type::_string:     release(_union._string);     break;
+				case type::_dictionary: release(_union._dictionary); break;
+				case type::_array:      release(_union._array);      break;
+				default: break;
+			};
+			_type = type::_none;
+			_union._resource = &resource;
+		}
+
+		template <typename T, typename ... TArgs>
+		static details::property_storage<T>* make_storage(memory_resource& resource, TArgs&& ... args)
+		{
+			return new_object<details::property_storage<T>>(resource, std::forward<TArgs>(args)...);
+		}
+		static details::property_storage<keystring>* clone_storage(memory_resource& resource, const keystring& value)
+		{
+			return make_storage<keystring>(resource, value);
+		}
+		template <typename T>
+		static details::property_storage<T>* clone_storage(memory_resource& resource, const T& value)
+		{
+			return mark_storage(make_storage<T>(resource, value, &resource));
+		}
+		//the items of a new storage are shared or cloned storages, so they know their markers already
+		template <typename T>
+		static details::property_storage<T>* mark_storage(details::property_storage<T>* storage) noexcept
+		{
+			storage->markers = items_have_markers(storage->value);
+			return storage;
+		}
+		template <typename T>
+		static details::property_storage<T>* acquire(details::property_storage<T>* storage) noexcept
+		{
+			storage->refs.fetch_add(1, std::memory_order_relaxed);
+			return storage;
+		}
+		template <typename T>
+		static void release(details::property_storage<T>* storage) noexcept
+		{
+			if (storage->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete_object(storage);
+		}
+		template <typename T>
+		static bool is_unique(const details::property_storage<T>* storage) noexcept
+		{
+			return storage->refs.load(std::memory_order_acquire) == 1;
+		}
+		template <typename T>
+		static void clear_storage(details::property_storage<T>* storage) noexcept
+		{
+			storage->value.clear();
+			storage->shareable = true;
+			storage->markers = false;
+		}
+		//the storage becomes owned by this property only; references to its items may be handed out after that
+		template <typename T>
+		static T& unshare(details::property_storage<T>*& storage)
+		{
+			if (not is_unique(storage))
+			{
+				details::property_storage<T>* copy = clone_storage(object_resource(storage), storage->value);
+				release(storage);
+				storage = copy;
 			}
+			storage->shareable = false;
+			return storage->value;
+		}
+		dictionary& mutable_dictionary() {
+			return unshare(_union._dictionary);
+		}
+		array& mutable_array() {
+			return unshare(_union._array);
+		}
+
+		void set_storage(details::property_storage<keystring>* storage) noexcept
+		{
+			reset();
+			_union._string = storage;
+			_type = type::_string;
+		}
+		void set_storage(details::property_storage<dictionary>* storage) noexcept
+		{
+			reset();
+			_union._dictionary = storage;
+			_type = type::_dictionary;
+		}
+		void set_storage(details::property_storage<array>* storage) noexcept
+		{
+			reset();
+			_union._array = storage;
+			_type = type::_array;
+		}
+		//the storage of another property is shared if it is possible, otherwise it is cloned into the own resource
+		template <typename T>
+		property& assign_storage(details::property_storage<T>* other)
+		{
+			memory_resource& resource = get_resource();
+			if (other->shareable and object_resource(other).is_equal(resource))
+				set_storage(acquire(other));
+			else
+				set_storage(clone_storage(resource, other->value));
+			return *this;
+		}
+		template <typename Value>
+		property& assign_string(Value&& value)
+		{
+			if (is_string() and is_unique(_union._string))
+				_union._string->value = keystring(std::forward<Value>(value));
+			else
+				set_storage(make_storage<keystring>(get_resource(), std::forward<Value>(value)));
+			return *this;
 		}
 
 	public:
@@ -237,8 +379,20 @@ namespace utils
 		type get_type() const {
 			return _type;
 		}
+		//resource of the own heap storage; nested properties created by the tree take it as well.
+		//scalars do not keep a resource: they use the default one when turn into a container
+		memory_resource& get_resource() const {
+			switch (_type)
+			{
+				case type::_none:       return _union._resource != nullptr ? *_union._resource : *new_delete_resource();
+				case type::_string:     return object_resource(_union._string);
+				case type::_dictionary: return object_resource(_union._dictionary);
+				case type::_array:      return object_resource(_union._array);
+				default:                return *new_delete_resource();
+			}
+		}
 		~property() {
-			set_type(type::_none);
+			reset();
 		}
 		property() :
 			_type(type::_none)
@@ -248,6 +402,13 @@ namespace utils
 			_type(type::_none)
 		{
 		}
+		//the tree will be allocated from the resource, so it can be released at once (a patch of an engine tick);
+		//the resource have to outlive the property and all its copies made by moving
+		explicit property(memory_resource& resource) :
+			_type(type::_none)
+		{
+			_union._resource = &resource;
+		}
 		property(const bool value) :
 			_type(type::_bool)
 		{
@@ -276,55 +437,47 @@ namespace utils
 		property(const char* value) :
 			_type(type::_string)
 		{
-			_union._string = new keystring(value);
+			_union._string = make_storage<keystring>(*new_delete_resource(), value);
 		}
 		property(const std::string& value) :
 			_type(type::_string)
 		{
-			_union._string = new keystring(value);
+			_union._string = make_storage<keystring>(*new_delete_resource(), value);
 		}
 		property(std::string&& value) :
 			_type(type::_string)
 		{
-			_union._string = new keystring(std::move(value));
+			_union._string = make_storage<keystring>(*new_delete_resource(), std::move(value));
 		}
 		property(const keystring& value) :
 			_type(type::_string)
 		{
-			_union._string = new keystring(value);
+			_union._string = make_storage<keystring>(*new_delete_resource(), value);
 		}
 		property(keystring&& value) :
 			_type(type::_string)
 		{
-			_union._string = new keystring(std::move(value));
+			_union._string = make_storage<keystring>(*new_delete_resource(), std::move(value));
 		}
 		property(const dictionary& values) :
-			_type(type::_none)
+			_type(type::_dictionary)
 		{
-			set_type(type::_dictionary);
-			assert(_union._dictionary != nullptr);
-			*_union._dictionary = values;
+			_union._dictionary = clone_storage(*new_delete_resource(), values);
 		}
 		property(dictionary&& values) :
-			_type(type::_none)
+			_type(type::_dictionary)
 		{
-			set_type(type::_dictionary);
-			assert(_union._dictionary != nullptr);
-			_union._dictionary->swap(values);
+			_union._dictionary = mark_storage(make_storage<dictionary>(*values.get_resource(), std::move(values)));
 		}
 		property(const array& values) :
-			_type(type::_none)
+			_type(type::_array)
 		{
-			set_type(type::_array);
-			assert(_union._array != nullptr);
-			*_union._array = values;
+			_union._array = clone_storage(*new_delete_resource(), values);
 		}
 		property(array&& values) :
-			_type(type::_none)
+			_type(type::_array)
 		{
-			set_type(type::_array);
-			assert(_union._array != nullptr);
-			_union._array->swap(values);
+			_union._array = mark_storage(make_storage<array>(*values.get_resource(), std::move(values)));
 		}
 		property(const property& prop) :
 			_type(type::_none)
@@ -341,44 +494,44 @@ namespace utils
 		property_iterator begin() {
 			check_type_iteratable();
 			if (is_dictionary())
-				return property_iterator(_union._dictionary->begin());
+				return property_iterator(mutable_dictionary().begin());
 			if (is_array())
-				return property_iterator(_union._array->begin());
+				return property_iterator(mutable_array().begin());
 			return property_iterator();
 		}
 		property_const_iterator begin() const {
 			check_type_iteratable();
 			if (is_dictionary())
-				return property_const_iterator(_union._dictionary->cbegin());
+				return property_const_iterator(_union._dictionary->value.cbegin());
 			if (is_array())
-				return property_const_iterator(_union._array->cbegin());
+				return property_const_iterator(_union._array->value.cbegin());
 			return property_const_iterator();
 		}
 		property_iterator end() {
 			check_type_iteratable();
 			if (is_dictionary())
-				return property_iterator(_union._dictionary->end());
+				return property_iterator(mutable_dictionary().end());
 			if (is_array())
-				return property_iterator(_union._array->end());
+				return property_iterator(mutable_array().end());
 			return property_iterator();
 		}
 		property_const_iterator end() const {
 			check_type_iteratable();
 			if (is_dictionary())
-				return property_const_iterator(_union._dictionary->cend());
+				return property_const_iterator(_union._dictionary->value.cend());
 			if (is_array())
-				return property_const_iterator(_union._array->cend());
+				return property_const_iterator(_union._array->value.cend());
 			return property_const_iterator();
 		}
 		std::size_t size() const {
 			if (is_none())
 				return 0;
 			if (is_string())
-				return _union._string->size();
+				return _union._string->value.size();
 			if (is_dictionary())
-				return _union._dictionary->size();
+				return _union._dictionary->value.size();
 			if (is_array())
-				return _union._array->size();
+				return _union._array->value.size();
 			throw PropertyCastException();
 		}
 		void clear() {
@@ -412,48 +565,37 @@ namespace utils
 			return as_array();
 		}
 		property& operator [](const char* key) { 
-			return (*this)[keystring(key)];
+			return get_dictionary_item(key);
 		}
 		const property& operator [](const char* key) const {
-			return (*this)[keystring(key)];
+			return get_dictionary_item(key);
 		}
 		property& operator [](const std::string& key) { 
-			return (*this)[keystring(key)];
+			return get_dictionary_item(key);
 		}
 		const property& operator [](const std::string& key) const {
-			return (*this)[keystring(key)];
+			return get_dictionary_item(key);
+		}
+		property& operator [](const keystring_literal& key) { 
+			return get_dictionary_item(key);
+		}
+		const property& operator [](const keystring_literal& key) const {
+			return get_dictionary_item(key);
 		}
 		property& operator [](const keystring& key) { 
-			if (is_none())
-				set_type(type::_dictionary);
-			else
-				check_type(type::_dictionary);
-			assert(_union._dictionary != nullptr);
-			return (*_union._dictionary)[key];
+			return get_dictionary_item(key);
 		}
-		const property& operator [](const keystring& key) const
-		{
-			if (is_none())
-				return none_property();
-			check_type(type::_dictionary);
-			assert(_union._dictionary != nullptr);
-			const auto& it = _union._dictionary->find(key);
-			if (it == _union._dictionary->end())
-				return none_property();
-			return it->second;
+		const property& operator [](const keystring& key) const {
+			return get_dictionary_item(key);
 		}
 		property& operator [](const std::size_t key)
 		{
-			if (is_none())
-				set_type(type::_array);
-			else
-				check_type(type::_array);
-			assert(_union._array != nullptr);
-			if (key > _union._array->size() + 0xffffff)//do not increase too much!!!
+			array& items = prepare_array();
+			if (key > items.size() + 0xffffff)//do not increase too much!!!
 				throw infrastructure::InvalidArgumentException();
-			while (key > _union._array->size())
-				(*_union._array)[_union._array->size()];
-			return (*_union._array)[key];
+			if (key >= items.extent())
+				items.resize(key + 1);
+			return items.at(key);
 		}
 		const property& operator [](const std::size_t key) const
 		{
@@ -461,14 +603,51 @@ namespace utils
 				return none_property();
 			check_type(type::_array);
 			assert(_union._array != nullptr);
-			if (key > _union._array->size() + 0xffffff)//do not access too far!!!
+			const array& items = _union._array->value;
+			if (key > items.size() + 0xffffff)//do not access too far!!!
 				throw infrastructure::InvalidArgumentException();
-			const auto& it = _union._array->find(key);
-			if (it == _union._array->end())
+			if (not items.contains(key))
 				return none_property();
-			return it->second;
+			return *items.get(key);
+		}
+
+		//Array building. A none property turns into an empty array. Items are appended past the last
+		//index (holes included), so indexes of the existing items do not change.
+		//reserve() preallocates the index and the pool slots of the flat_array: filling it up to `count` items
+		//does not grow them, but the items are not one contiguous block (see flat_array).
+		void reserve(const std::size_t count)
+		{
+			prepare_array().reserve(count);
+		}
+		property& push_back(const property& value)
+		{
+			return prepare_array().emplace_back(value);
+		}
+		property& push_back(property&& value)
+		{
+			return prepare_array().emplace_back(std::move(value));
+		}
+		template <typename Iterator>
+		void append(Iterator begin, const Iterator end)
+		{
+			array& items = prepare_array();
+			items.reserve(items.extent() + static_cast<std::size_t>(std::distance(begin, end)));
+			for (; begin != end; ++begin)
+				items.emplace_back(*begin);
+		}
+
+	private:
+		array& prepare_array()
+		{
+			if (is_none())
+				set_type(type::_array);
+			else
+				check_type(type::_array);
+			assert(_union._array != nullptr);
+			return mutable_array();
 		}
 
+	public:
 		property& operator=(const std::nullptr_t&)
 		{
 			set_type(type::_none);
@@ -500,30 +679,20 @@ namespace utils
 			return *this;
 		}
 		property& operator=(const char* value) {
-			set_type(type::_string);
-			new (_union._string) keystring(value);
-			return *this;
+			return assign_string(value);
 		}
 		property& operator=(const std::string& value) {
-			set_type(type::_string);
-			new (_union._string) keystring(value);
-			return *this;
+			return assign_string(value);
 		}
 		property& operator=(const keystring& value) {
-			set_type(type::_string);
-			new (_union._string) keystring(value);
-			return *this;
+			return assign_string(value);
 		}
 		property& operator=(const dictionary& properties) {
-			set_type(type::_dictionary);
-			assert(_union._dictionary != nullptr);
-			*_union._dictionary = properties;
+			set_storage(clone_storage(get_resource(), properties));
 			return *this;
 		}
 		property& operator=(const array& properties) {
-			set_type(type::_array);
-			assert(_union._array != nullptr);
-			*_union._array = properties;
+			set_storage(clone_storage(get_resource(), properties));
 			return *this;
 		}
 		property& operator=(const property& property) {
@@ -536,9 +705,9 @@ namespace utils
 				case type::_long: return *this = property._union._long;
 				case type::_float: return *this = property._union._float;
 				case type::_double: return *this = property._union._double;
-				case type::_string: return *this = property.as_keystring_cref();
-				case type::_dictionary: return *this = property.as_dictionary_cref();
-				case type::_array: return *this = property.as_array_cref();
+				case type::_string: return assign_storage(property._union._string);
+				case type::_dictionary: return assign_storage(property._union._dictionary);
+				case type::_array: return assign_storage(property._union._array);
 
 				default: assert(!"Unsupported property_tree type"); return *this;
 			};
@@ -546,6 +715,8 @@ namespace utils
 		property& operator=(property&& property) {
 			if (this == &property)
 				return *this;
+			if (not get_resource().is_equal(property.get_resource()))
+				return *this = static_cast<const utils::property&>(property);
 			std::swap(_type, property._type);
 			std::swap(_union, property._union);
 			return *this;
@@ -560,9 +731,9 @@ namespace utils
 				case type::_long: return _union._long == property._union._long;
 				case type::_float: return _union._float == property._union._float;
 				case type::_double: return _union._double == property._union._double;
-				case type::_string: return *_union._string == *property._union._string;
-				case type::_dictionary: return *_union._dictionary == *property._union._dictionary;
-				case type::_array: return *_union._array == *property._union._array;
+				case type::_string: return _union._string == property._union._string or _union._string->value == property._union._string->value;
+				case type::_dictionary: return _union._dictionary == property._union._dictionary or _union._dictionary->value == property._union._dictionary->value;
+				case type::_array: return _union._array == property._union._array or _union._array->value == property._union._array->value;
 
 				default: assert(!"Unsupported property_tree type"); return false;
 			}
@@ -632,60 +803,162 @@ namespace utils
 			return as_array_cref();
 		}
 
+		//the value if the property has type T, nullptr otherwise; T is one of the scalar types,
+		//keystring, dictionary or array. The pointer is valid until the next change of the property
+		template <typename T>
+		const T* try_as() const noexcept {
+			return try_get(type_tag<T>());
+		}
+
+		//the value if the property has type T, the fallback otherwise
+		template <typename T>
+		T get_or(const T& fallback) const {
+			const T* value = try_as<T>();
+			return value != nullptr ? *value : fallback;
+		}
+		keystring get_or(const keystring_literal& fallback) const {
+			const keystring* value = try_as<keystring>();
+			return value != nullptr ? *value : keystring(fallback);
+		}
+		std::string get_or(const std::string& fallback) const {
+			const keystring* value = try_as<keystring>();
+			return value != nullptr ? value->get_content() : fallback;
+		}
+
 	private:
+		template <typename T>
+		struct type_tag
+		{};
+
+		const bool* try_get(type_tag<bool>) const noexcept {
+			return _type == type::_bool ? &_union._bool : nullptr;
+		}
+		const int* try_get(type_tag<int>) const noexcept {
+			return _type == type::_int ? &_union._int : nullptr;
+		}
+		const long* try_get(type_tag<long>) const noexcept {
+			return _type == type::_long ? &_union._long : nullptr;
+		}
+		const float* try_get(type_tag<float>) const noexcept {
+			return _type == type::_float ? &_union._float : nullptr;
+		}
+		const double* try_get(type_tag<double>) const noexcept {
+			return _type == type::_double ? &_union._double : nullptr;
+		}
+		const keystring* try_get(type_tag<keystring>) const noexcept {
+			return _type == type::_string ? &_union._string->value : nullptr;
+		}
+		const dictionary* try_get(type_tag<dictionary>) const noexcept {
+			return _type == type::_dictionary ? &_union._dictionary->value : nullptr;
+		}
+		const array* try_get(type_tag<array>) const noexcept {
+			return _type == type::_array ? &_union._array->value : nullptr;
+		}
+
+
+		//the key is not converted to keystring until a new item is inserted
+		template <typename Key>
+		property& get_dictionary_item(const Key& key)
+		{
+			if (is_none())
+				set_type(type::_dictionary);
+			else
+				check_type(type::_dictionary);
+			assert(_union._dictionary != nullptr);
+			return mutable_dictionary()[key];
+		}
+		template <typename Key>
+		const property& get_dictionary_item(const Key& key) const
+		{
+			if (is_none())
+				return none_property();
+			check_type(type::_dictionary);
+			assert(_union._dictionary != nullptr);
+			const dictionary& items = _union._dictionary->value;
+			const auto& it = items.find(key);
+			if (it == items.end())
+				return none_property();
+			return it->second;
+		}
+
 		const keystring& as_keystring_cref() const {
 			check_type(type::_string);
 			assert(_union._string != nullptr);
-			return *_union._string;
+			return _union._string->value;
 		}
 		const dictionary& as_dictionary_cref() const {
 			check_type(type::_dictionary);
 			assert(_union._dictionary != nullptr);
-			return *_union._dictionary;
+			return _union._dictionary->value;
 		}
 		const array& as_array_cref() const {
 			check_type(type::_array);
 			assert(_union._array != nullptr);
-			return *_union._array;
+			return _union._array->value;
 		}
 
 	public:
 		bool contains(const char* key) const {
-			return contains(keystring(key));
+			return contains_key(key);
 		}
 		bool contains(const std::string& key) const {
-			return contains(keystring(key));
+			return contains_key(key);
+		}
+		bool contains(const keystring_literal& key) const {
+			return contains_key(key);
 		}
 		bool contains(const keystring& key) const {
+			return contains_key(key);
+		}
+
+	private:
+		template <typename Key>
+		bool contains_key(const Key& key) const {
 			if (is_none())
 				return false;
 			check_type(type::_dictionary);
-			return _union._dictionary->find(key) != _union._dictionary->end();
+			const dictionary& items = _union._dictionary->value;
+			return items.find(key) != items.end();
 		}
 
+	public:
+
+		//remove() is const by history, but it changes the content: the storage is unshared as by any other change
 		void remove(const std::size_t key) const {
-			UNUSED(key);
 			check_type(type::_array);
-			if (key > _union._array->size())
+			const array& items = _union._array->value;
+			if (key > items.size())
 				throw PropertyOutOfRangeException();
-			auto it = _union._array->find(key);
-			if (it == _union._array->end())
+			if (not items.contains(key))
 				throw PropertyOutOfRangeException();
-			auto prev = it++;
-			while (it != _union._array->end())
-			{
-				prev->second = std::move(it->second);
-				prev = it;
-				++it;
-			}
-			_union._array->erase(prev);
+			const_cast<property*>(this)->mutable_array().erase(key);
 		}
 		void remove(const keystring& key) const {
 			check_type(type::_dictionary);
-			auto it = _union._dictionary->find(key);
-			if (it == _union._dictionary->end())
+			if (not contains_key(key))
 				throw PropertyOutOfRangeException();
-			_union._dictionary->erase(it);
+			const_cast<property*>(this)->mutable_dictionary().erase(key);
+		}
+
+		//Allows copies to share the storage of the tree again after the non-const operator[], begin() or end().
+		//Call it when no mutable references into the tree are kept anymore (for example the tree is going
+		//to be published as a const patch, see EngineStrategyBase::push_changes()); until then every copy
+		//of the tree clones the storages touched by that access
+		void seal() noexcept {
+			if (is_dictionary() and not _union._dictionary->shareable)
+			{
+				for (auto& item : _union._dictionary->value)
+					item.second.seal();
+				_union._dictionary->shareable = true;
+				mark_storage(_union._dictionary);
+			}
+			else if (is_array() and not _union._array->shareable)
+			{
+				for (auto& item : _union._array->value)
+					item.seal();
+				_union._array->shareable = true;
+				mark_storage(_union._array);
+			}
 		}
 
 		void replace(const property& admixture)
@@ -698,11 +971,124 @@ namespace utils
 			replace(*this, std::move(admixture));
 		}
 
+		//Merges `admixture` into `original`: dictionaries and arrays by items, other values are overwritten
 		static void replace(property& original, const property& admixture)
 		{
+			merge<false>(original, admixture);
+		}
+
+		static void replace(property& original, property&& admixture)
+		{
+			merge<false>(original, std::move(admixture));
+		}
+
+		//replace() for the patches of diff() and compact(): the single key dictionaries {"$delete": true}
+		//and {"$set": <value>} are patch markers (see make_deletion() and make_overwrite()), not data.
+		//replace() keeps merging such dictionaries as they are
+		static void apply_patch(property& original, const property& patch)
+		{
+			merge<true>(original, patch);
+		}
+
+		static void apply_patch(property& original, property&& patch)
+		{
+			merge<true>(original, std::move(patch));
+		}
+
+		using replace_item = std::pair<property*, const property*>;
+
+		//replace() split by the items of a dictionary: the dictionary `original` itself is changed here
+		//(the slots of the items are inserted), the returned items are left to replace(*item.first, *item.second).
+		//They are independent, so the result is the same for any order and for several threads; the pointers
+		//are valid until `original` or `admixture` is changed.
+		//Nothing is returned when both are not plain dictionaries: the whole replace() is done here then
+		static std::vector<replace_item> replace_items(property& original, const property& admixture)
+		{
+			return merge_items<false>(original, admixture);
+		}
+
+		//replace_items() for apply_patch(): the deletions are done here, the returned items are left
+		//to apply_patch(*item.first, *item.second)
+		static std::vector<replace_item> patch_items(property& original, const property& patch)
+		{
+			return merge_items<true>(original, patch);
+		}
+
+		//Patch markers. apply_patch() removes an item marked by make_deletion() and sets an item
+		//to the value of make_overwrite() whatever the former type was (none included).
+		//Markers are single key dictionaries, so a patch stays a plain tree for json and binary forms.
+		//The results of make_deletion(), make_overwrite(), diff() and compact() are sealed, so the trees
+		//they are inserted to know that the markers are inside without a walk
+		static property make_deletion()
+		{
+			property marker;
+			marker[deletion_key()] = true;
+			marker.seal();
+			return marker;
+		}
+		static property make_overwrite(const property& value)
+		{
+			property marker;
+			marker[overwrite_key()] = value;
+			marker.seal();
+			return marker;
+		}
+		bool is_deletion() const {
+			if (not is_marker(deletion_key()))
+				return false;
+			const property& value = operator[](deletion_key());
+			return value.is_bool() and value.as_bool();
+		}
+		bool is_overwrite() const {
+			return is_marker(overwrite_key());
+		}
+
+		//The minimal patch which turns `before` into `after` by apply_patch(); none if they are equal.
+		//Unchanged items are not in the patch and shared subtrees are skipped without a walk.
+		static property diff(const property& before, const property& after)
+		{
+			property out = diff_patch(before, after);
+			out.seal();
+			return out;
+		}
+
+		//One patch with the same effect as apply_patch() by `first` and then by `second`
+		static property compact(const property& first, const property& second)
+		{
+			property out = compact_patch(first, second);
+			out.seal();
+			return out;
+		}
+
+		//Patches are merged in the order of the range
+		template <typename Iterator>
+		static property compact(Iterator begin, const Iterator end)
+		{
+			property out;
+			for (; begin != end; ++begin)
+				out = compact_patch(out, *begin);
+			out.seal();
+			return out;
+		}
+
+	private:
+		//replace() if not `patch`, apply_patch() otherwise
+		template <bool patch>
+		static void merge(property& original, const property& admixture)
+		{
+			if (patch and admixture.is_deletion())
+			{
+				original.clear();
+				return;
+			}
+			if (patch and admixture.is_overwrite())
+			{
+				original = admixture[overwrite_key()];
+				return;
+			}
 			if (original.is_none())
 			{
-				original = admixture;
+				original = patch and has_markers(admixture) ? without_markers(admixture) : admixture;
 				return;
 			}
 			if (admixture.is_none())
@@ -712,27 +1098,57 @@ namespace utils
 
 			if (original.get_type() != admixture.get_type())
 				throw PropertyCastException();
+			if (original.is_dictionary() and original._union._dictionary == admixture._union._dictionary)
+				return;
+			if (original.is_array() and original._union._array == admixture._union._array)
+				return;
 
 			if (original.is_dictionary())
 			{
+				const bool shareable = original._union._dictionary->shareable;
+				bool markers = false;
 				for (auto it = admixture.begin(); it != admixture.end(); ++it)
-					replace(original[it.get_key()], *it);
+					if (patch and it->is_deletion())
+						erase_item(original, it.get_key());
+					else
+						markers = merge_item<patch>(original[it.get_key()], *it) or markers;
+				reshare(original._union._dictionary, shareable, markers);
 				return;
 			}
 			if (original.is_array())
 			{
+				const bool shareable = original._union._array->shareable;
+				bool markers = false;
+				if (patch)
+					erase_marked_items(original, admixture);
 				for (auto it = admixture.begin(); it != admixture.end(); ++it)
-					replace(original[it.get_index()], *it);
+					if (not (patch and it->is_deletion()))
+						markers = merge_item<patch>(original[it.get_index()], *it) or markers;
+				reshare(original._union._array, shareable, markers);
 				return;
 			}
 			original = admixture;
 		}
 
-		static void replace(property& original, property&& admixture)
+		template <bool patch>
+		static void merge(property& original, property&& admixture)
 		{
+			if (patch and admixture.is_deletion())
+			{
+				original.clear();
+				return;
+			}
+			if (patch and admixture.is_overwrite())
+			{
+				original = std::move(admixture[overwrite_key()]);
+				return;
+			}
 			if (original.is_none())
 			{
-				original = std::move(admixture);
+				if (patch and has_markers(admixture))
+					original = without_markers(admixture);
+				else
+					original = std::move(admixture);
 				return;
 			}
 			if (admixture.is_none())
@@ -745,18 +1161,296 @@ namespace utils
 
 			if (original.is_dictionary())
 			{
+				const bool shareable = original._union._dictionary->shareable;
+				bool markers = false;
 				for (auto it = admixture.begin(); it != admixture.end(); ++it)
-					replace(original[it.get_key()], std::move(*it));
+					if (patch and it->is_deletion())
+						erase_item(original, it.get_key());
+					else
+						markers = merge_item<patch>(original[it.get_key()], std::move(*it)) or markers;
+				reshare(original._union._dictionary, shareable, markers);
 				return;
 			}
 			if (original.is_array())
 			{
+				const bool shareable = original._union._array->shareable;
+				bool markers = false;
+				if (patch)
+					erase_marked_items(original, admixture);
 				for (auto it = admixture.begin(); it != admixture.end(); ++it)
-					replace(original[it.get_index()], std::move(*it));
+					if (not (patch and it->is_deletion()))
+						markers = merge_item<patch>(original[it.get_index()], std::move(*it)) or markers;
+				reshare(original._union._array, shareable, markers);
 				return;
 			}
 			original = std::move(admixture);
 		}
+
+		//merges an item and tells if it has patch markers after that (for the markers bit of its container)
+		template <bool patch, typename Admixture>
+		static bool merge_item(property& item, Admixture&& admixture)
+		{
+			merge<patch>(item, std::forward<Admixture>(admixture));
+			return has_markers(item);
+		}
+
+		//A merge keeps no references into the storages it changes, so a storage which was shareable before
+		//the merge is shareable again after it; the items of the storage have been merged the same way.
+		//The markers bit may only grow: a merge does not walk the items it has not touched
+		template <typename T>
+		static void reshare(details::property_storage<T>* storage, const bool shareable, const bool markers) noexcept
+		{
+			if (not shareable or storage->shareable)
+				return;
+			storage->shareable = true;
+			storage->markers = storage->markers or markers;
+		}
+
+		template <bool patch>
+		static std::vector<replace_item> merge_items(property& original, const property& admixture)
+		{
+			const bool splittable = original.is_dictionary() and admixture.is_dictionary()
+				and not (patch and (admixture.is_deletion() or admixture.is_overwrite()))
+				and original._union._dictionary != admixture._union._dictionary;
+			if (not splittable)
+			{
+				merge<patch>(original, admixture);
+				return {};
+			}
+			for (auto it = admixture.begin(); it != admixture.end(); ++it)
+				if (patch and it->is_deletion())
+					erase_item(original, it.get_key());
+				else
+					original[it.get_key()];
+
+			dictionary& items = original.mutable_dictionary();
+			std::vector<replace_item> out;
+			out.reserve(admixture.size());
+			for (auto it = admixture.begin(); it != admixture.end(); ++it)
+				if (not (patch and it->is_deletion()))
+					out.emplace_back(&items[it.get_key()], &*it);
+			return out;
+		}
+
+		static property diff_patch(const property& before, const property& after)
+		{
+			if (after.is_none())
+				return before.is_none() ? property() : make_deletion();
+			if (before.is_none())
+				return after;
+			if (before.get_type() != after.get_type())
+				return make_overwrite(after);
+			if (before.is_dictionary())
+				return diff_dictionary(before, after);
+			if (before.is_array())
+				return diff_array(before, after);
+			if (before == after)
+				return property();
+			return after;
+		}
+
+		static property compact_patch(const property& first, const property& second)
+		{
+			if (second.is_none())
+				return first;
+			if (second.is_deletion() or second.is_overwrite())
+				return second;
+			if (first.is_none())
+				return second;
+			if (first.is_deletion())
+				return make_overwrite(without_markers(second));
+			if (first.is_overwrite())
+			{
+				property value = first[overwrite_key()];
+				if (value.is_none())
+					value = without_markers(second);
+				else
+					apply_patch(value, second);
+				return make_overwrite(value);
+			}
+			if (first.get_type() != second.get_type())
+				throw PropertyCastException();
+
+			if (first.is_dictionary())
+			{
+				property out = first;
+				for (auto it = second.begin(); it != second.end(); ++it)
+					out[it.get_key()] = compact_item(first[it.get_key()], *it);
+				return out;
+			}
+			if (first.is_array())
+			{
+				property out = first;
+				for (auto it = second.begin(); it != second.end(); ++it)
+					out[it.get_index()] = compact_item(first[it.get_index()], *it);
+				return out;
+			}
+			return second;
+		}
+
+		static constexpr keystring_literal deletion_key() {
+			return "$delete"_ks;
+		}
+		static constexpr keystring_literal overwrite_key() {
+			return "$set"_ks;
+		}
+		bool is_marker(const keystring_literal& key) const {
+			return is_dictionary() and _union._dictionary->value.size() == 1 and contains_key(key);
+		}
+
+		static void erase_item(property& original, const keystring& key)
+		{
+			if (original.contains_key(key))
+				original.mutable_dictionary().erase(key);
+		}
+		//Deletions go before the other items of the patch and never shift indexes:
+		//a deleted item in the middle turns into a hole, the deleted tail shortens the array
+		static void erase_marked_items(property& original, const property& admixture)
+		{
+			const array& marks = admixture._union._array->value;
+			for (std::size_t index = marks.extent(); index-- > 0; )
+			{
+				if (not marks.contains(index) or not marks.get(index)->is_deletion())
+					continue;
+				if (not original._union._array->value.contains(index))
+					continue;
+				array& items = original.mutable_array();
+				if (index + 1 == items.extent())
+					items.pop_back();
+				else
+					items.reset(index);
+			}
+		}
+
+		static property diff_dictionary(const property& before, const property& after)
+		{
+			property out;
+			if (before._union._dictionary == after._union._dictionary)
+				return out;
+			for (auto it = after.begin(); it != after.end(); ++it)
+			{
+				if (not before.contains_key(it.get_key()))
+					out[it.get_key()] = *it;
+				else if (it->is_none())
+				{
+					if (not before[it.get_key()].is_none())
+						out[it.get_key()] = make_overwrite(*it);
+				}
+				else
+				{
+					property item = diff_patch(before[it.get_key()], *it);
+					if (not item.is_none())
+						out[it.get_key()] = std::move(item);
+				}
+			}
+			for (auto it = before.begin(); it != before.end(); ++it)
+				if (not after.contains_key(it.get_key()))
+					out[it.get_key()] = make_deletion();
+			return out;
+		}
+
+		//Only trailing items are marked for deletion; an array which gets a hole in the middle
+		//or keeps a hole in the deleted tail is overwritten as a whole
+		static property diff_array(const property& before, const property& after)
+		{
+			property out;
+			if (before._union._array == after._union._array)
+				return out;
+			const array& old_items = before._union._array->value;
+			const array& new_items = after._union._array->value;
+			for (std::size_t index = 0; index < new_items.extent(); ++index)
+			{
+				const bool was = old_items.contains(index);
+				if (not new_items.contains(index))
+				{
+					if (was)
+						return make_overwrite(after);
+					continue;
+				}
+				const property& item = *new_items.get(index);
+				if (not was)
+					out[index] = item;
+				else if (item.is_none())
+				{
+					if (not old_items.get(index)->is_none())
+						out[index] = make_overwrite(item);
+				}
+				else
+				{
+					property changes = diff_patch(*old_items.get(index), item);
+					if (not changes.is_none())
+						out[index] = std::move(changes);
+				}
+			}
+			for (std::size_t index = new_items.extent(); index < old_items.extent(); ++index)
+			{
+				if (not old_items.contains(index))
+					return make_overwrite(after);
+				out[index] = make_deletion();
+			}
+			return out;
+		}
+
+		//none in a container patch creates the absent item, so it does not cancel an earlier deletion
+		static property compact_item(const property& first, const property& second)
+		{
+			if (second.is_none() and first.is_deletion())
+				return make_overwrite(second);
+			return compact_patch(first, second);
+		}
+
+		//A shareable storage keeps the answer; a mutable one is walked
+		static bool has_markers(const property& patch)
+		{
+			if (patch.is_deletion() or patch.is_overwrite())
+				return true;
+			if (patch.is_dictionary())
+				return patch._union._dictionary->shareable ? patch._union._dictionary->markers : items_have_markers(patch._union._dictionary->value);
+			if (patch.is_array())
+				return patch._union._array->shareable ? patch._union._array->markers : items_have_markers(patch._union._array->value);
+			return false;
+		}
+		static bool items_have_markers(const dictionary& items)
+		{
+			for (const auto& item : items)
+				if (has_markers(item.second))
+					return true;
+			return false;
+		}
+		static bool items_have_markers(const array& items)
+		{
+			for (const auto& item : items)
+				if (has_markers(item))
+					return true;
+			return false;
+		}
+
+		//The value which the patch gives to an absent item
+		static property without_markers(const property& patch)
+		{
+			if (patch.is_deletion())
+				return property();
+			if (patch.is_overwrite())
+				return patch[overwrite_key()];
+			if (not has_markers(patch))
+				return patch;
+			property out;
+			if (patch.is_dictionary())
+			{
+				out = dictionary {};
+				for (auto it = patch.begin(); it != patch.end(); ++it)
+					if (not it->is_deletion())
+						out[it.get_key()] = without_markers(*it);
+			}
+			else
+			{
+				out = array {};
+				for (auto it = patch.begin(); it != patch.end(); ++it)
+					if (not it->is_deletion())
+						out[it.get_index()] = without_markers(*it);
+			}
+			return out;
+		}
 	};
 }
 }
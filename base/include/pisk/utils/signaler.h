@@ -21,6 +21,8 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <atomic>
+#include <vector>
 #include <deque>
 #include <mutex>
 #include <set>
@@ -53,38 +55,22 @@ namespace utils
 
 namespace details {
 
-	template <typename Signaler, typename EventHandler>
+	//Removes the handler by the identity of its entry, so equal handlers are independent
+	template <typename Signaler, typename Entry>
 	class subscribtion : public utils::subscribtion {
 		std::weak_ptr<Signaler> signaler;
-		EventHandler handler;
+		std::shared_ptr<Entry> entry;
 
 	public:
-		subscribtion() = default;
-		subscribtion(const subscribtion& sub) = delete;
-		subscribtion operator =(subscribtion&&) = delete;
-
-		subscribtion(std::weak_ptr<Signaler> signaler, const EventHandler& handler) :
+		subscribtion(std::weak_ptr<Signaler> signaler, std::shared_ptr<Entry> entry) :
 			signaler(signaler),
-			handler(handler)
-		{
-			subscribe();
-		}
+			entry(std::move(entry))
+		{}
 		~subscribtion()
 		{
-			unsubscribe();
-		}
-	private:
-		void subscribe()
-		{
-			if (handler != nullptr)
+			if (entry != nullptr)
 				if (auto ptr = signaler.lock())
-					(*ptr) += this->handler;
-		}
-		void unsubscribe()
-		{
-			if (handler != nullptr)
-				if (auto ptr = signaler.lock())
-					(*ptr) -= this->handler;
+					ptr->remove(entry.get());
 		}
 	};
 
@@ -96,8 +82,16 @@ namespace details {
 	struct eventhandler<void> {
 		using type = std::function<void ()>;
 	};
+
+	template <typename EventHandler>
+	bool is_same_handler(const EventHandler& left, const EventHandler& right)
+	{
+		return left.target_type() == right.target_type() &&
+			left.template target<EventHandler>() == right.template target<EventHandler>();
+	}
 }
 
+	//Not threadsafe signaler: handlers may subscribe, unsubscribe and emit from handlers
 	template <typename TEvent>
 	class light_signaler : public noncopyable
 	{
@@ -108,59 +102,106 @@ namespace details {
 		{
 			handlers.emplace_back(handler);
 		}
+		//Is erased at once; under emit the entry is erased when the outer emit finishes
 		void unsubscribe(const eventhandler& handler) noexcept
 		{
 			for (auto iter = handlers.begin(); iter != handlers.end(); ++iter)
 			{
-				if (iter->target_type() == handler.target_type() &&
-					iter->template target<eventhandler>() == handler.template target<eventhandler>())
+				if (*iter != nullptr && details::is_same_handler(*iter, handler))
+				{
 					*iter = nullptr;
+					dirty = true;
+				}
 			}
+			clean_if_idle();
 		}
 		template <typename T = TEvent, typename E = typename utils::disable_if<std::is_void<T>::value, T>::type>
 		void emit(const E& event) const
 		{
-			for (const eventhandler& handler : handlers)
-				if (handler != nullptr)
-					handler(event);
+			emission guard(*this);
+			//handlers subscribed under emit get the next event; a deque keeps references on emplace_back
+			const std::size_t count = handlers.size();
+			for (std::size_t index = 0; index < count; ++index)
+				if (handlers[index] != nullptr)
+					handlers[index](event);
 		}
 		template <typename T = TEvent, typename R = std::enable_if_t<std::is_void<T>::value>>
 		R emit() const
 		{
-			for (const eventhandler& handler : handlers)
-				if (handler != nullptr)
-					handler();
+			emission guard(*this);
+			const std::size_t count = handlers.size();
+			for (std::size_t index = 0; index < count; ++index)
+				if (handlers[index] != nullptr)
+					handlers[index]();
 		}
 		template <typename T = TEvent, typename E = typename utils::disable_if<std::is_void<T>::value, T>::type>
 		void remit(const E& event) const
 		{
-			for (const eventhandler& handler : iterators::backwards(handlers))
-				if (handler != nullptr)
-					handler(event);
+			emission guard(*this);
+			for (std::size_t index = handlers.size(); index != 0; --index)
+				if (handlers[index - 1] != nullptr)
+					handlers[index - 1](event);
 		}
 		template <typename T = TEvent, typename R = std::enable_if_t<std::is_void<T>::value>>
 		R remit() const
 		{
-			for (const eventhandler& handler : iterators::backwards(handlers))
-				if (handler != nullptr)
-					handler();
+			emission guard(*this);
+			for (std::size_t index = handlers.size(); index != 0; --index)
+				if (handlers[index - 1] != nullptr)
+					handlers[index - 1]();
 		}
 		void clear() noexcept
 		{
 			for (auto iter = handlers.begin(); iter != handlers.end(); ++iter)
 				*iter = nullptr;
+			dirty = true;
+			clean_if_idle();
 		}
 		void clean() noexcept
 		{
 			auto newend = std::remove(handlers.begin(), handlers.end(), nullptr);
 			handlers.erase(newend, handlers.end());
+			dirty = false;
+		}
+		std::size_t size() const noexcept
+		{
+			return handlers.size();
+		}
+
+	private:
+		class emission
+		{
+			const light_signaler& owner;
+		public:
+			explicit emission(const light_signaler& owner):
+				owner(owner)
+			{
+				++owner.emitting;
+			}
+			~emission()
+			{
+				--owner.emitting;
+				owner.clean_if_idle();
+			}
+		};
+
+		void clean_if_idle() const noexcept
+		{
+			if (emitting == 0 && dirty)
+				const_cast<light_signaler*>(this)->clean();
 		}
 
 	private:
 		std::deque<eventhandler> handlers;
+		mutable std::size_t emitting = 0;
+		bool dirty = false;
 	};
 
 namespace details {
+	//Emit is lock-free and does not allocate: it walks an immutable snapshot of the subscribers.
+	//Every change publishes a new snapshot; an old one is deleted when no emit can read it.
+	//An unsubscribed handler is not called by the emits after, including the current emit of this thread;
+	//an emit running in other thread may still be finishing the call.
 	template <typename TEvent>
 	class signaler : public std::enable_shared_from_this<signaler<TEvent>>
 	{
@@ -168,83 +209,220 @@ namespace details {
 		using signalerptr = std::shared_ptr<signaler<TEvent>>;
 		using eventhandler = typename details::eventhandler<TEvent>::type;
 
+	private:
+		template <typename Target>
+		struct entry
+		{
+			const Target target;
+			std::atomic<bool> active {true};
+
+			explicit entry(const Target& target):
+				target(target)
+			{}
+		};
+		using handler_entry = entry<eventhandler>;
+		using chain_entry = entry<signalerptr>;
+
+		struct snapshot
+		{
+			std::vector<std::shared_ptr<handler_entry>> handlers;
+			std::vector<std::shared_ptr<chain_entry>> signalers;
+		};
+		using snapshots = std::vector<const snapshot*>;
+
+		class reading
+		{
+			const signaler& owner;
+		public:
+			explicit reading(const signaler& owner):
+				owner(owner)
+			{
+				++owner.readers;
+			}
+			~reading()
+			{
+				if (--owner.readers == 0 and owner.has_retired.load())
+					owner.reclaim();
+			}
+		};
+
+		std::atomic<const snapshot*> current {new snapshot};
+		mutable std::atomic<std::size_t> readers {0};
+		mutable std::atomic<bool> has_retired {false};
+		mutable std::mutex guard;
+		mutable snapshots retired;
+
+	public:
+		signaler() = default;
+		signaler(const signaler&) = delete;
+		signaler& operator=(const signaler&) = delete;
+
+		~signaler()
+		{
+			delete current.load();
+			for (const snapshot* old : retired)
+				delete old;
+		}
+
 		auto_unsubscriber subscribe(const eventhandler& handler) threadsafe noexcept {
-			using _subscribtion = details::subscribtion<signaler, eventhandler>;
-			return std::make_shared<_subscribtion>(this->shared_from_this(), handler);
+			using _subscribtion = details::subscribtion<signaler, handler_entry>;
+			if (handler == nullptr)
+				return std::make_shared<_subscribtion>(this->shared_from_this(), nullptr);
+			return std::make_shared<_subscribtion>(this->shared_from_this(), add(handler));
 		}
 
 		void operator += (const signalerptr& sign) threadsafe noexcept
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			signalers.insert(sign);
+			update([&sign](snapshot& next) {
+				for (const auto& chained : next.signalers)
+					if (chained->target == sign)
+						return;
+				next.signalers.emplace_back(std::make_shared<chain_entry>(sign));
+			});
 		}
 		void operator -= (const signalerptr& sign) threadsafe noexcept
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			signalers.erase(sign);
+			update([&sign](snapshot& next) {
+				remove_if(next.signalers, [&sign](const chain_entry& chained) {
+					return chained.target == sign;
+				});
+			});
 		}
 		void operator += (const eventhandler& handler) threadsafe noexcept
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			impl.subscribe(handler);
+			add(handler);
 		}
 		void operator -= (const eventhandler& handler) threadsafe noexcept
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			impl.unsubscribe(handler);
+			update([&handler](snapshot& next) {
+				remove_if(next.handlers, [&handler](const handler_entry& subscribed) {
+					return details::is_same_handler(subscribed.target, handler);
+				});
+			});
+		}
+		void remove(const handler_entry* subscribed) threadsafe noexcept
+		{
+			update([subscribed](snapshot& next) {
+				remove_if(next.handlers, [subscribed](const handler_entry& item) {
+					return &item == subscribed;
+				});
+			});
 		}
 		template <typename T = TEvent, typename E = typename utils::disable_if<std::is_void<T>::value, T>::type>
 		void emit(const E& event) const threadsafe
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			impl.emit(event);
-			auto copy_signalers = signalers;
-			for (const auto& signaler : copy_signalers)
-				if (signalers.find(signaler) != signalers.end())
-					signaler->emit(event);
+			reading guard(*this);
+			const snapshot* list = current.load();
+			for (const auto& subscribed : list->handlers)
+				if (subscribed->active.load())
+					subscribed->target(event);
+			for (const auto& chained : list->signalers)
+				if (chained->active.load())
+					chained->target->emit(event);
 		}
 		template <typename T = TEvent, typename R = std::enable_if_t<std::is_void<T>::value>>
 		R emit() const threadsafe
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			impl.emit();
-			auto copy_signalers = signalers;
-			for (const auto& signaler : copy_signalers)
-				if (signalers.find(signaler) != signalers.end())
-					signaler->emit();
+			reading guard(*this);
+			const snapshot* list = current.load();
+			for (const auto& subscribed : list->handlers)
+				if (subscribed->active.load())
+					subscribed->target();
+			for (const auto& chained : list->signalers)
+				if (chained->active.load())
+					chained->target->emit();
 		}
 		template <typename T = TEvent, typename E = typename utils::disable_if<std::is_void<T>::value, T>::type>
 		void remit(const E& event) const threadsafe
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			auto copy_signalers = signalers;
-			for (const auto& signaler : iterators::backwards(copy_signalers))
-				if (signalers.find(signaler) != signalers.end())
-					signaler->remit(event);
-			impl.remit(event);
+			reading guard(*this);
+			const snapshot* list = current.load();
+			for (const auto& chained : iterators::backwards(list->signalers))
+				if (chained->active.load())
+					chained->target->remit(event);
+			for (const auto& subscribed : iterators::backwards(list->handlers))
+				if (subscribed->active.load())
+					subscribed->target(event);
 		}
 		template <typename T = TEvent, typename R = std::enable_if_t<std::is_void<T>::value>>
 		R remit() const threadsafe
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			auto copy_signalers = signalers;
-			for (const auto& signaler : iterators::backwards(copy_signalers))
-				if (signalers.find(signaler) != signalers.end())
-					signaler->remit();
-			impl.remit();
+			reading guard(*this);
+			const snapshot* list = current.load();
+			for (const auto& chained : iterators::backwards(list->signalers))
+				if (chained->active.load())
+					chained->target->remit();
+			for (const auto& subscribed : iterators::backwards(list->handlers))
+				if (subscribed->active.load())
+					subscribed->target();
 		}
 		void clear() threadsafe noexcept
 		{
-			std::lock_guard<std::recursive_mutex> lock(guard);
-			impl.clear();
-			signalers.clear();
+			update([](snapshot& next) {
+				remove_if(next.handlers, [](const handler_entry&) {
+					return true;
+				});
+				remove_if(next.signalers, [](const chain_entry&) {
+					return true;
+				});
+			});
 		}
 
 	private:
+		std::shared_ptr<handler_entry> add(const eventhandler& handler) noexcept
+		{
+			auto subscribed = std::make_shared<handler_entry>(handler);
+			update([&subscribed](snapshot& next) {
+				next.handlers.push_back(subscribed);
+			});
+			return subscribed;
+		}
+
+		//the removed entries are deactivated at once: emits which are running skip them
+		template <typename Entries, typename Predicate>
+		static void remove_if(Entries& entries, Predicate&& predicate)
+		{
+			auto newend = std::remove_if(entries.begin(), entries.end(), [&predicate](const auto& item) {
+				if (not predicate(*item))
+					return false;
+				item->active = false;
+				return true;
+			});
+			entries.erase(newend, entries.end());
+		}
+
+		template <typename Change>
+		void update(Change&& change) noexcept
+		{
+			snapshots garbage;
+			{
+				std::lock_guard<std::mutex> lock(guard);
+				std::unique_ptr<snapshot> next(new snapshot(*current.load()));
+				change(*next);
+				retired.push_back(current.exchange(next.release()));
+				if (readers.load() == 0)
+					garbage.swap(retired);
+				has_retired = not retired.empty();
+			}
+			//entries may own the last references to other signalers: they are released out of the lock
+			for (const snapshot* old : garbage)
+				delete old;
+		}
 
-		mutable std::recursive_mutex guard;
-		light_signaler<TEvent> impl;
-		std::set <signalerptr> signalers;
+		//a reader which comes after the check reads the current snapshot, which is never retired
+		void reclaim() const noexcept
+		{
+			snapshots garbage;
+			{
+				std::unique_lock<std::mutex> lock(guard, std::try_to_lock);
+				if (not lock.owns_lock() or readers.load() != 0)
+					return;
+				garbage.swap(retired);
+				has_retired = false;
+			}
+			for (const snapshot* old : garbage)
+				delete old;
+		}
 	};
 }
 
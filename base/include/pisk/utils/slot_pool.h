@@ -0,0 +1,211 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+#include "memory_resource.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <new>
+
+namespace pisk
+{
+namespace utils
+{
+	//Storage of objects which never move after construction.
+	//Slots are carved from slabs of geometrically growing size, so N objects cost O(log N) allocations;
+	//destroyed slots are reused by the next create(). Slabs are taken from the given memory_resource.
+	template <typename type>
+	class slot_pool
+	{
+		struct slab
+		{
+			slab* next;
+			std::size_t capacity;
+			std::size_t used;
+		};
+		struct free_slot
+		{
+			free_slot* next;
+		};
+
+		constexpr static std::size_t min_slab_capacity = 4;
+
+		//type may be incomplete at the point of declaration of the pool (recursive containers)
+		constexpr static std::size_t slot_align()
+		{
+			return alignof(type) > alignof(free_slot) ? alignof(type) : alignof(free_slot);
+		}
+		constexpr static std::size_t slot_size()
+		{
+			return ((sizeof(type) > sizeof(free_slot) ? sizeof(type) : sizeof(free_slot)) + slot_align() - 1) / slot_align() * slot_align();
+		}
+		constexpr static std::size_t slab_align()
+		{
+			return alignof(slab) > slot_align() ? alignof(slab) : slot_align();
+		}
+		constexpr static std::size_t header_size()
+		{
+			return (sizeof(slab) + slot_align() - 1) / slot_align() * slot_align();
+		}
+
+		memory_resource* resource;
+		slab* slabs = nullptr;
+		free_slot* free_slots = nullptr;
+		std::size_t free_count = 0;
+		std::size_t total_capacity = 0;
+
+	public:
+		explicit slot_pool(memory_resource* resource = new_delete_resource()):
+			resource(resource)
+		{}
+		slot_pool(const slot_pool&) = delete;
+		slot_pool& operator=(const slot_pool&) = delete;
+
+		slot_pool(slot_pool&& other) noexcept:
+			resource(other.resource)
+		{
+			swap(other);
+		}
+		slot_pool& operator=(slot_pool&& other) noexcept
+		{
+			slot_pool tmp(std::move(other));
+			swap(tmp);
+			return *this;
+		}
+
+		//owner have to destroy all alive objects before
+		~slot_pool()
+		{
+			release();
+		}
+
+		void swap(slot_pool& other) noexcept
+		{
+			std::swap(resource, other.resource);
+			std::swap(slabs, other.slabs);
+			std::swap(free_slots, other.free_slots);
+			std::swap(free_count, other.free_count);
+			std::swap(total_capacity, other.total_capacity);
+		}
+
+		memory_resource* get_resource() const
+		{
+			return resource;
+		}
+
+		std::size_t capacity() const
+		{
+			return total_capacity;
+		}
+
+		//guarantee that next `count` calls of create() will not allocate
+		void reserve(const std::size_t count)
+		{
+			if (count > available())
+				allocate_slab(count - available());
+		}
+
+		template <typename ... TArgs>
+		type* create(TArgs&& ... args)
+		{
+			void* memory = take_slot();
+			try
+			{
+				return new (memory) type(std::forward<TArgs>(args)...);
+			}
+			catch (...)
+			{
+				put_slot(memory);
+				throw;
+			}
+		}
+
+		void destroy(type* object) noexcept
+		{
+			object->~type();
+			put_slot(object);
+		}
+
+		//owner have to destroy all alive objects before
+		void release() noexcept
+		{
+			while (slabs != nullptr)
+			{
+				slab* next = slabs->next;
+				resource->deallocate(slabs, header_size() + slabs->capacity * slot_size(), slab_align());
+				slabs = next;
+			}
+			free_slots = nullptr;
+			free_count = 0;
+			total_capacity = 0;
+		}
+
+	private:
+		static void* slot(slab* s, const std::size_t index)
+		{
+			return reinterpret_cast<char*>(s) + header_size() + index * slot_size();
+		}
+
+		std::size_t available() const
+		{
+			return free_count + (slabs == nullptr ? 0 : slabs->capacity - slabs->used);
+		}
+
+		void allocate_slab(const std::size_t required)
+		{
+			const std::size_t capacity = std::max(std::max(min_slab_capacity, total_capacity), required);
+			slab* s = static_cast<slab*>(resource->allocate(header_size() + capacity * slot_size(), slab_align()));
+			s->capacity = capacity;
+			s->used = 0;
+
+			//the rest of the current slab is not lost: pass it to the free list
+			if (slabs != nullptr)
+				while (slabs->used != slabs->capacity)
+					put_slot(slot(slabs, slabs->used++));
+
+			s->next = slabs;
+			slabs = s;
+			total_capacity += capacity;
+		}
+
+		void* take_slot()
+		{
+			if (free_slots != nullptr)
+			{
+				free_slot* slot = free_slots;
+				free_slots = slot->next;
+				--free_count;
+				return slot;
+			}
+			if (slabs == nullptr or slabs->used == slabs->capacity)
+				allocate_slab(1);
+			return slot(slabs, slabs->used++);
+		}
+
+		void put_slot(void* memory) noexcept
+		{
+			free_slot* slot = static_cast<free_slot*>(memory);
+			slot->next = free_slots;
+			free_slots = slot;
+			++free_count;
+		}
+	};
+
+	template <typename type>
+	constexpr std::size_t slot_pool<type>::min_slab_capacity;
+}
+}
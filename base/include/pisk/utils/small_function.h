@@ -0,0 +1,217 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include "../defines.h"
+
+#include <type_traits>
+#include <functional>
+#include <cstddef>
+#include <utility>
+#include <new>
+
+namespace pisk
+{
+namespace utils
+{
+	template <typename Signature, std::size_t Capacity = 48>
+	class small_function;
+
+	//Move-only callable which keeps a callee up to `Capacity` bytes inside (no allocation);
+	//a bigger callee or one which may throw on moving is kept on the heap
+	template <typename Result, typename ... TArgs, std::size_t Capacity>
+	class small_function<Result (TArgs...), Capacity>
+	{
+		using storage_t = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+
+		struct operations
+		{
+			Result (*invoke)(storage_t& storage, TArgs&& ... args);
+			//move-constructs the callee into `to` and destroys the one in `from`
+			void (*relocate)(storage_t& from, storage_t& to) noexcept;
+			void (*destroy)(storage_t& storage) noexcept;
+		};
+
+		template <typename Callee>
+		struct inplace
+		{
+			static Callee& get(storage_t& storage)
+			{
+				return *reinterpret_cast<Callee*>(&storage);
+			}
+			static Result invoke(storage_t& storage, TArgs&& ... args)
+			{
+				return static_cast<Result>(get(storage)(std::forward<TArgs>(args)...));
+			}
+			static void relocate(storage_t& from, storage_t& to) noexcept
+			{
+				new (&to) Callee(std::move(get(from)));
+				get(from).~Callee();
+			}
+			static void destroy(storage_t& storage) noexcept
+			{
+				get(storage).~Callee();
+			}
+			static const operations* table()
+			{
+				static const operations out = {&invoke, &relocate, &destroy};
+				return &out;
+			}
+		};
+
+		template <typename Callee>
+		struct allocated
+		{
+			static Callee*& get(storage_t& storage)
+			{
+				return *reinterpret_cast<Callee**>(&storage);
+			}
+			static Result invoke(storage_t& storage, TArgs&& ... args)
+			{
+				return static_cast<Result>((*get(storage))(std::forward<TArgs>(args)...));
+			}
+			static void relocate(storage_t& from, storage_t& to) noexcept
+			{
+				new (&to) Callee*(get(from));
+			}
+			static void destroy(storage_t& storage) noexcept
+			{
+				delete get(storage);
+			}
+			static const operations* table()
+			{
+				static const operations out = {&invoke, &relocate, &destroy};
+				return &out;
+			}
+		};
+
+		template <typename Signature>
+		static bool is_null(const std::function<Signature>& callee)
+		{
+			return callee == nullptr;
+		}
+		template <typename Callee>
+		static bool is_null(Callee* callee)
+		{
+			return callee == nullptr;
+		}
+		template <typename Callee>
+		static bool is_null(const Callee&)
+		{
+			return false;
+		}
+
+		storage_t storage;
+		const operations* ops = nullptr;
+
+	public:
+		template <typename Callee>
+		constexpr static bool is_inplace()
+		{
+			return sizeof(Callee) <= Capacity and alignof(Callee) <= alignof(storage_t) and std::is_nothrow_move_constructible<Callee>::value;
+		}
+
+		small_function() noexcept = default;
+
+		small_function(std::nullptr_t) noexcept
+		{}
+
+		template <typename Callee, typename = std::enable_if_t<not std::is_same<std::decay_t<Callee>, small_function>::value>>
+		small_function(Callee&& callee)
+		{
+			using callee_t = std::decay_t<Callee>;
+			if (is_null(callee))
+				return;
+			construct<callee_t>(std::forward<Callee>(callee), std::integral_constant<bool, is_inplace<callee_t>()>());
+		}
+
+		small_function(small_function&& other) noexcept
+		{
+			take(other);
+		}
+
+		small_function& operator=(small_function&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				take(other);
+			}
+			return *this;
+		}
+
+		small_function& operator=(std::nullptr_t) noexcept
+		{
+			reset();
+			return *this;
+		}
+
+		~small_function()
+		{
+			reset();
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return ops != nullptr;
+		}
+
+		void swap(small_function& other) noexcept
+		{
+			small_function tmp(std::move(other));
+			other = std::move(*this);
+			*this = std::move(tmp);
+		}
+
+		Result operator()(TArgs ... args)
+		{
+			if (ops == nullptr)
+				throw std::bad_function_call();
+			return ops->invoke(storage, std::forward<TArgs>(args)...);
+		}
+
+	private:
+		template <typename Callee, typename Value>
+		void construct(Value&& callee, std::true_type)
+		{
+			new (&storage) Callee(std::forward<Value>(callee));
+			ops = inplace<Callee>::table();
+		}
+		template <typename Callee, typename Value>
+		void construct(Value&& callee, std::false_type)
+		{
+			new (&storage) Callee*(new Callee(std::forward<Value>(callee)));
+			ops = allocated<Callee>::table();
+		}
+
+		void take(small_function& other) noexcept
+		{
+			if (other.ops == nullptr)
+				return;
+			other.ops->relocate(other.storage, storage);
+			ops = other.ops;
+			other.ops = nullptr;
+		}
+
+		void reset() noexcept
+		{
+			if (ops == nullptr)
+				return;
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	};
+
+}//namespace utils
+}//namespace pisk
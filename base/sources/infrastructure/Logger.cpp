@@ -13,9 +13,25 @@
 
 #include <pisk/infrastructure/Logger.h>
 
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
 #include <atomic>
+#include <thread>
+#include <chrono>
 #include <mutex>
 
+#ifndef _WIN32
+#	include <cerrno>
+#	include <signal.h>
+#	include <unistd.h>
+#endif
+
 namespace pisk
 {
 namespace infrastructure
@@ -23,8 +39,477 @@ namespace infrastructure
 	static std::mutex guard;
 	static std::unique_ptr<LogStorage> storage;
 	static std::atomic<Logger::Level> filtered_level = {Logger::Level::Information};
+	static std::atomic<Logger::Level> traced_level = {Logger::Level::Silent};
+	static std::atomic<Logger::Level> trace_level = {Logger::Level::Debug};
+	//LogStorage::get_crash_descriptor() of the storage; it is read by the signal handler, which takes no locks
+	static std::atomic<int> crash_descriptor = {-1};
 
-	bool Logger::is_level_filtered(const Level check_level) threadsafe noexcept
+	namespace
+	{
+		struct record
+		{
+			std::atomic<std::size_t> sequence;
+			Logger::Level level;
+			std::string tag;
+			//strings of the slots keep their capacity, so a warmed up ring does not allocate
+			std::vector<std::string> messages;
+			std::size_t count;
+		};
+
+		//Bounded ring of records for many producers and one consumer (the writer thread).
+		//A producer claims a position by CAS on `tail`, fills the slot and publishes it by the sequence number
+		//of the slot; the consumer releases the slot for the next lap the same way.
+		class record_ring
+		{
+			std::unique_ptr<record[]> slots;
+			std::size_t mask = 0;
+			alignas(64) std::atomic<std::size_t> tail {0};
+			alignas(64) std::size_t head = 0;
+
+		public:
+			void reset(const std::size_t capacity)
+			{
+				std::size_t size = 2;
+				while (size < capacity)
+					size *= 2;
+				slots.reset(new record[size]);
+				mask = size - 1;
+				for (std::size_t index = 0; index < size; ++index)
+					slots[index].sequence.store(index, std::memory_order_relaxed);
+				tail.store(0, std::memory_order_relaxed);
+				head = 0;
+			}
+
+			template <typename Fill>
+			bool try_push(Fill&& fill)
+			{
+				std::size_t position = tail.load(std::memory_order_relaxed);
+				while (true)
+				{
+					record& slot = slots[position & mask];
+					const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+					const std::intptr_t lag = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+					if (lag == 0)
+					{
+						if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						{
+							fill(slot);
+							slot.sequence.store(position + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if (lag < 0)
+						return false;
+					else
+						position = tail.load(std::memory_order_relaxed);
+				}
+			}
+
+			//consumer side
+			record* front()
+			{
+				record& slot = slots[head & mask];
+				if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+					return nullptr;
+				return &slot;
+			}
+			void pop()
+			{
+				slots[head & mask].sequence.store(head + mask + 1, std::memory_order_release);
+				++head;
+			}
+
+			std::size_t claimed() const
+			{
+				return tail.load(std::memory_order_acquire);
+			}
+
+			//Visits the published records without popping them; lock-free, it is used by the signal handler
+			//while the consumer may be stopped in the middle of a batch
+			template <typename Visit>
+			void visit_published(Visit&& visit) const
+			{
+				const std::size_t end = claimed();
+				for (std::size_t position = head; position != end; ++position)
+				{
+					const record& slot = slots[position & mask];
+					if (slot.sequence.load(std::memory_order_acquire) == position + 1)
+						visit(slot);
+				}
+			}
+		};
+
+		class async_writer
+		{
+			record_ring ring;
+			Logger::OverflowPolicy policy = Logger::OverflowPolicy::Drop;
+
+			std::atomic<bool> active {false};
+			std::atomic<int> producers {0};
+			std::atomic<bool> stopping {false};
+			std::thread thread;
+
+			std::mutex wake_guard;
+			std::condition_variable wake;
+			std::atomic<bool> sleeping {false};
+			std::condition_variable written_signal;
+			std::atomic<std::size_t> written {0};
+			std::atomic<std::size_t> dropped {0};
+
+			constexpr static std::chrono::milliseconds idle_timeout {20};
+			constexpr static std::chrono::milliseconds flush_timeout {1000};
+
+		public:
+			~async_writer()
+			{
+				stop();
+			}
+
+			void start(const std::size_t capacity, const Logger::OverflowPolicy new_policy)
+			{
+				stop();
+				ring.reset(capacity);
+				policy = new_policy;
+				written = 0;
+				dropped = 0;
+				stopping = false;
+				thread = std::thread([this]() {
+					run();
+				});
+				active = true;
+			}
+
+			void stop()
+			{
+				if (not active.exchange(false))
+					return;
+				while (producers.load() != 0)
+					std::this_thread::yield();
+				{
+					std::unique_lock<std::mutex> lock(wake_guard);
+					stopping = true;
+				}
+				wake.notify_one();
+				if (thread.get_id() == std::this_thread::get_id())
+					thread.detach();
+				else
+					thread.join();
+			}
+
+			//false if the asynchronous mode is off: the caller stores the record itself
+			template <typename Fill>
+			bool push(Fill&& fill)
+			{
+				producers.fetch_add(1);
+				if (not active.load())
+				{
+					producers.fetch_sub(1);
+					return false;
+				}
+				while (not ring.try_push(fill))
+				{
+					if (policy == Logger::OverflowPolicy::Drop or thread.get_id() == std::this_thread::get_id())
+					{
+						dropped.fetch_add(1, std::memory_order_relaxed);
+						break;
+					}
+					wakeup();
+					std::this_thread::yield();
+				}
+				producers.fetch_sub(1);
+				wakeup();
+				return true;
+			}
+
+			//Writes the records which are not stored yet to `descriptor` by write(2): async-signal-safe,
+			//no lock and no allocation. A record being stored by the writer thread may be written twice
+			void write_pending(const int descriptor) const
+			{
+#ifndef _WIN32
+				if (descriptor < 0 or not active.load())
+					return;
+				ring.visit_published([descriptor](const record& slot) {
+					for (std::size_t index = 0; index < slot.count and index < slot.messages.size(); ++index)
+					{
+						write_all(descriptor, slot.tag.data(), slot.tag.size());
+						write_all(descriptor, ": ", 2);
+						write_all(descriptor, slot.messages[index].data(), slot.messages[index].size());
+						write_all(descriptor, "\n", 1);
+					}
+				});
+#else
+				(void)descriptor;
+#endif
+			}
+
+			void flush()
+			{
+				producers.fetch_add(1);
+				if (active.load() and thread.get_id() != std::this_thread::get_id())
+				{
+					const std::size_t target = ring.claimed();
+					std::unique_lock<std::mutex> lock(wake_guard);
+					sleeping = false;
+					wake.notify_one();
+					written_signal.wait_for(lock, flush_timeout, [this, target]() {
+						return written.load() >= target;
+					});
+				}
+				producers.fetch_sub(1);
+			}
+
+		private:
+#ifndef _WIN32
+			static void write_all(const int descriptor, const char* data, std::size_t size)
+			{
+				while (size != 0)
+				{
+					const ssize_t written = ::write(descriptor, data, size);
+					if (written < 0 and errno == EINTR)
+						continue;
+					if (written <= 0)
+						return;
+					data += written;
+					size -= static_cast<std::size_t>(written);
+				}
+			}
+#endif
+
+			void wakeup()
+			{
+				if (sleeping.load() and sleeping.exchange(false))
+				{
+					std::unique_lock<std::mutex> lock(wake_guard);
+					wake.notify_one();
+				}
+			}
+
+			void run()
+			{
+				while (true)
+				{
+					if (write_batch() != 0)
+						continue;
+					std::unique_lock<std::mutex> lock(wake_guard);
+					if (stopping)
+						break;
+					sleeping = true;
+					if (ring.front() == nullptr)
+						wake.wait_for(lock, idle_timeout);
+					sleeping = false;
+				}
+				write_batch();
+			}
+
+			std::size_t write_batch()
+			{
+				std::size_t count = 0;
+				{
+					std::unique_lock<std::mutex> lock(guard);
+					for (record* item = ring.front(); item != nullptr; item = ring.front())
+					{
+						if (storage != nullptr)
+						{
+							if (item->count == 1)
+								storage->store(item->level, item->tag, item->messages.front());
+							else
+								storage->store(item->level, item->tag, item->messages);
+						}
+						ring.pop();
+						++count;
+					}
+					const std::size_t lost = dropped.exchange(0, std::memory_order_relaxed);
+					if (storage != nullptr and lost != 0)
+						storage->store(Logger::Level::Warning, "logger", std::to_string(lost) + " log records are dropped: the ring is full");
+					if (storage != nullptr and (count != 0 or lost != 0))
+						storage->flush();
+				}
+				if (count != 0)
+				{
+					std::unique_lock<std::mutex> lock(wake_guard);
+					written.fetch_add(count);
+					written_signal.notify_all();
+				}
+				return count;
+			}
+		};
+
+		constexpr std::chrono::milliseconds async_writer::idle_timeout;
+		constexpr std::chrono::milliseconds async_writer::flush_timeout;
+
+		async_writer writer;
+
+		//Set when the pending records are written on a crash: std::terminate ends by abort(),
+		//so SIGABRT comes after the terminate handler and must not write the records again
+		std::atomic<bool> crash_written {false};
+
+		std::terminate_handler previous_terminate = nullptr;
+
+		void flush_on_terminate()
+		{
+			//not a signal handler: the writer thread stores the records as usual
+			if (not crash_written.exchange(true))
+				writer.flush();
+			if (previous_terminate != nullptr)
+				previous_terminate();
+			std::abort();
+		}
+
+#ifndef _WIN32
+		const int crash_signals[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+		struct sigaction previous_actions[std::extent<decltype(crash_signals)>::value];
+
+		//The handler installed before gets the signal: it is restored and the signal is raised again;
+		//the raised signal is blocked until this handler returns. A fault repeats on the return anyway
+		void chain_signal(const int number)
+		{
+			for (std::size_t index = 0; index < std::extent<decltype(crash_signals)>::value; ++index)
+			{
+				if (crash_signals[index] != number)
+					continue;
+				struct sigaction previous = previous_actions[index];
+				//an ignored fault would repeat forever
+				if (not (previous.sa_flags & SA_SIGINFO) and previous.sa_handler == SIG_IGN)
+					previous.sa_handler = SIG_DFL;
+				sigaction(number, &previous, nullptr);
+			}
+			raise(number);
+		}
+
+		void write_on_signal(const int number, siginfo_t*, void*)
+		{
+			const int saved_errno = errno;
+			if (not crash_written.exchange(true))
+				writer.write_pending(crash_descriptor.load());
+			chain_signal(number);
+			errno = saved_errno;
+		}
+#endif
+
+		void stop_on_exit()
+		{
+			writer.stop();
+		}
+
+		//Owner of the trace storage. Writers neither lock nor count themselves (a record costs tens of ns),
+		//so a replaced storage is kept until the exit: it is replaced once or twice per process.
+		class trace_sink
+		{
+			std::mutex guard;
+			std::atomic<TraceStorage*> storage {nullptr};
+			std::vector<std::unique_ptr<TraceStorage>> retired;
+
+			//ids of the interned strings by the hash of the content; reset when the storage is changed
+			//(storages are not deleted, so the address identifies the storage)
+			struct intern_cache
+			{
+				struct entry
+				{
+					std::uint64_t hash;
+					std::uint32_t id;
+				};
+				const TraceStorage* owner;
+				entry entries[256];
+			};
+			static thread_local intern_cache cache;
+
+		public:
+			~trace_sink()
+			{
+				delete storage.exchange(nullptr);
+			}
+
+			bool is_set() const
+			{
+				return storage.load() != nullptr;
+			}
+
+			void reset(std::unique_ptr<TraceStorage> new_storage)
+			{
+				std::unique_lock<std::mutex> lock(guard);
+				std::unique_ptr<TraceStorage> old(storage.exchange(new_storage.release()));
+				if (old != nullptr)
+					retired.push_back(std::move(old));
+			}
+
+			void write(const Logger::Level level, const char* tag, const char* format, const std::size_t format_size, TraceRecord& record)
+			{
+				if (TraceStorage* current = storage.load(std::memory_order_acquire))
+				{
+					record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+					record.level = static_cast<std::uint8_t>(level);
+					record.tag = intern(*current, tag, std::strlen(tag));
+					record.format = intern(*current, format, format_size);
+					current->write(record);
+				}
+			}
+
+		private:
+			//the strings are hashed by words: it is the most of the cost of a traced record
+			static std::uint64_t hash_text(const char* text, const std::size_t size)
+			{
+				const std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+				std::uint64_t hash = size * multiplier;
+				std::size_t index = 0;
+				for (; index + sizeof(std::uint64_t) <= size; index += sizeof(std::uint64_t))
+				{
+					std::uint64_t word;
+					std::memcpy(&word, text + index, sizeof(word));
+					hash = (hash ^ word) * multiplier;
+					hash ^= hash >> 29;
+				}
+				std::uint64_t tail = 0;
+				for (; index < size; ++index)
+					tail = (tail << 8) | static_cast<unsigned char>(text[index]);
+				hash = (hash ^ tail) * multiplier;
+				return hash ^ (hash >> 32);
+			}
+
+			static std::uint32_t intern(TraceStorage& current, const char* text, const std::size_t size)
+			{
+				if (cache.owner != &current)
+				{
+					std::fill(std::begin(cache.entries), std::end(cache.entries), intern_cache::entry {0, 0});
+					cache.owner = &current;
+				}
+				//zero marks an empty entry
+				const std::uint64_t hash = hash_text(text, size) | 1;
+
+				intern_cache::entry& item = cache.entries[hash % countof(cache.entries)];
+				if (item.hash != hash)
+					item = {hash, current.intern(text, size)};
+				return item.id;
+			}
+		};
+
+		thread_local trace_sink::intern_cache trace_sink::cache;
+
+		trace_sink tracer;
+
+		void update_traced_level()
+		{
+			traced_level = tracer.is_set() ? trace_level.load() : Logger::Level::Silent;
+		}
+
+		void fill_record(record& slot, const Logger::Level level, const std::string& tag, const std::string& message)
+		{
+			slot.level = level;
+			slot.tag.assign(tag);
+			slot.messages.resize(1);
+			slot.messages.front().assign(message);
+			slot.count = 1;
+		}
+		void fill_record(record& slot, const Logger::Level level, const std::string& tag, const std::vector<std::string>& messages)
+		{
+			slot.level = level;
+			slot.tag.assign(tag);
+			slot.messages.resize(messages.size());
+			std::copy(messages.begin(), messages.end(), slot.messages.begin());
+			slot.count = messages.size();
+		}
+	}
+
+	bool Logger::is_level_filtered_at_runtime(const Level check_level) threadsafe noexcept
 	{
 		return check_level > filtered_level;
 	}
@@ -34,24 +519,98 @@ namespace infrastructure
 		filtered_level = new_level;
 	}
 
+	bool Logger::is_level_traced_at_runtime(const Level check_level) threadsafe noexcept
+	{
+		return check_level <= traced_level;
+	}
+
+	void Logger::set_trace_level(const Level new_level) threadsafe noexcept
+	{
+		trace_level = new_level;
+		update_traced_level();
+	}
+
+	void Logger::set_trace_storage(std::unique_ptr<TraceStorage> storage) threadsafe noexcept
+	{
+		tracer.reset(std::move(storage));
+		update_traced_level();
+	}
+
+	void Logger::trace(const Level level, const char* tag, const char* format, const std::size_t format_size, TraceRecord& record) threadsafe noexcept
+	{
+		tracer.write(level, tag, format, format_size, record);
+	}
+
 	void Logger::set_log_storage(std::unique_ptr<LogStorage> _storage) threadsafe noexcept
 	{
 		std::unique_lock<std::mutex> lock(guard);
 		storage = std::move(_storage);
+		crash_descriptor = storage == nullptr ? -1 : storage->get_crash_descriptor();
+	}
+
+	void Logger::start_async(const std::size_t capacity, const OverflowPolicy policy) threadsafe noexcept
+	{
+		static std::once_flag registered;
+		std::call_once(registered, []() {
+			std::atexit(&stop_on_exit);
+		});
+		writer.start(capacity, policy);
+	}
+
+	void Logger::install_crash_handlers() threadsafe noexcept
+	{
+		static std::once_flag installed;
+		std::call_once(installed, []() {
+			previous_terminate = std::set_terminate(&flush_on_terminate);
+#ifndef _WIN32
+			struct sigaction action;
+			std::memset(&action, 0, sizeof(action));
+			action.sa_sigaction = &write_on_signal;
+			action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+			sigemptyset(&action.sa_mask);
+			for (std::size_t index = 0; index < std::extent<decltype(crash_signals)>::value; ++index)
+				sigaction(crash_signals[index], &action, &previous_actions[index]);
+#endif
+		});
+	}
+
+	void Logger::stop_async() threadsafe noexcept
+	{
+		writer.stop();
+	}
+
+	void Logger::flush() threadsafe noexcept
+	{
+		writer.flush();
 	}
 
 	void Logger::log(const Level level, const std::string& tag, const std::string& message) threadsafe noexcept
 	{
+		const bool queued = writer.push([&](record& slot) {
+			fill_record(slot, level, tag, message);
+		});
+		if (queued)
+			return;
 		std::unique_lock<std::mutex> lock(guard);
 		if (storage != nullptr)
+		{
 			storage->store(level, tag, message);
+			storage->flush();
+		}
 	}
 	void Logger::log(const Level level, const std::string& tag, const std::vector<std::string>& messages) threadsafe noexcept
 	{
+		const bool queued = writer.push([&](record& slot) {
+			fill_record(slot, level, tag, messages);
+		});
+		if (queued)
+			return;
 		std::unique_lock<std::mutex> lock(guard);
 		if (storage != nullptr)
+		{
 			storage->store(level, tag, messages);
+			storage->flush();
+		}
 	}
 }
 }
-
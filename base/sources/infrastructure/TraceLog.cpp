@@ -0,0 +1,255 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/infrastructure/TraceLog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace pisk
+{
+namespace infrastructure
+{
+	namespace
+	{
+		constexpr char trace_magic[8] = {'P', 'I', 'S', 'K', 'T', 'R', 'C', '\x0'};
+		constexpr std::uint32_t trace_version = 2;
+
+		std::size_t round_records(const std::size_t records)
+		{
+			std::size_t out = 1;
+			while (out < records)
+				out *= 2;
+			return out;
+		}
+
+		std::size_t align_offset(const std::size_t offset)
+		{
+			return (offset + alignof(TraceRecord) - 1) / alignof(TraceRecord) * alignof(TraceRecord);
+		}
+
+		std::atomic<std::uint64_t>& as_atomic(std::uint64_t& sequence)
+		{
+			static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(sequence), "The sequence is accessed as atomic");
+			return reinterpret_cast<std::atomic<std::uint64_t>&>(sequence);
+		}
+
+		template <typename Value>
+		Value read_value(const std::uint8_t* data)
+		{
+			Value out;
+			std::memcpy(&out, data, sizeof(out));
+			return out;
+		}
+
+		struct argument_value
+		{
+			std::int64_t signed_value;
+			std::uint64_t unsigned_value;
+			double floating_value;
+			bool boolean_value;
+			char character_value;
+			const void* pointer_value;
+			std::string string_value;
+		};
+	}
+
+	std::size_t TraceRing::block_size(const std::size_t records, const std::size_t strings) noexcept
+	{
+		return align_offset(sizeof(TraceHeader) + strings) + round_records(records) * sizeof(TraceRecord);
+	}
+
+	TraceRing::TraceRing(void* block, const std::size_t record_count, const std::size_t strings_capacity)
+	{
+		if (block == nullptr or record_count == 0)
+			throw InvalidArgumentException();
+
+		const std::size_t count = round_records(record_count);
+		header = static_cast<TraceHeader*>(block);
+		std::memset(block, 0, block_size(record_count, strings_capacity));
+		std::memcpy(header->magic, trace_magic, sizeof(trace_magic));
+		header->version = trace_version;
+		header->record_size = sizeof(TraceRecord);
+		header->records = count;
+		header->strings_offset = sizeof(TraceHeader);
+		header->strings_capacity = strings_capacity;
+		header->strings_size = 0;
+		header->records_offset = align_offset(sizeof(TraceHeader) + strings_capacity);
+		header->steady_origin = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		header->system_origin = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+		strings = static_cast<char*>(block) + header->strings_offset;
+		records = reinterpret_cast<TraceRecord*>(static_cast<char*>(block) + header->records_offset);
+		mask = count - 1;
+	}
+
+	std::uint32_t TraceRing::intern(const char* text, const std::size_t size) noexcept
+	{
+		std::unique_lock<std::mutex> lock(guard);
+		const std::string key(text, size);
+		const auto found = interned.find(key);
+		if (found != interned.end())
+			return found->second;
+
+		const std::uint64_t offset = header->strings_size;
+		const std::uint32_t length = static_cast<std::uint32_t>(size);
+		if (offset + sizeof(length) + size > header->strings_capacity)
+			return unknown_string;
+		std::memcpy(strings + offset, &length, sizeof(length));
+		std::memcpy(strings + offset + sizeof(length), text, size);
+		header->strings_size = offset + sizeof(length) + size;
+
+		const std::uint32_t id = static_cast<std::uint32_t>(offset);
+		interned.emplace(key, id);
+		return id;
+	}
+
+	void TraceRing::write(TraceRecord& record) noexcept
+	{
+		const std::uint64_t sequence = next.fetch_add(1, std::memory_order_relaxed);
+		TraceRecord& slot = records[sequence & mask];
+		//the sequences around the payload differ while the slot is being written or while a writer which
+		//lapped the ring writes the slot too; the reader keeps only the slots with the equal sequences
+		as_atomic(slot.sequence).store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		const std::size_t payload = offsetof(TraceRecord, end_sequence) - sizeof(record.sequence);
+		std::memcpy(reinterpret_cast<char*>(&slot) + sizeof(slot.sequence), reinterpret_cast<const char*>(&record) + sizeof(record.sequence), payload);
+		as_atomic(slot.end_sequence).store(sequence + 1, std::memory_order_release);
+	}
+
+	TraceReader::TraceReader(const char* data, const std::size_t size):
+		block(data, data + size)
+	{
+		header = reinterpret_cast<const TraceHeader*>(block.data());
+		if (size < sizeof(TraceHeader) or std::memcmp(header->magic, trace_magic, sizeof(trace_magic)) != 0)
+			throw TraceFormatException();
+		if (header->version != trace_version or header->record_size != sizeof(TraceRecord))
+			throw TraceFormatException();
+		if (header->records == 0 or (header->records & (header->records - 1)) != 0)
+			throw TraceFormatException();
+		if (header->strings_offset + header->strings_capacity > header->records_offset or header->strings_size > header->strings_capacity)
+			throw TraceFormatException();
+		if (header->records_offset + header->records * sizeof(TraceRecord) > size)
+			throw TraceFormatException();
+	}
+
+	std::vector<TraceReader::Line> TraceReader::read() const
+	{
+		const TraceRecord* records = reinterpret_cast<const TraceRecord*>(block.data() + header->records_offset);
+		std::vector<const TraceRecord*> valid;
+		for (std::uint64_t index = 0; index < header->records; ++index)
+		{
+			const TraceRecord& record = records[index];
+			if (record.sequence == 0 or record.sequence != record.end_sequence or ((record.sequence - 1) & (header->records - 1)) != index)
+				continue;
+			if (record.level > static_cast<std::uint8_t>(Logger::Level::Spam) or record.size > sizeof(record.arguments))
+				continue;
+			valid.push_back(&record);
+		}
+		std::sort(valid.begin(), valid.end(), [](const TraceRecord* left, const TraceRecord* right) {
+			return left->sequence < right->sequence;
+		});
+
+		std::vector<Line> out;
+		out.reserve(valid.size());
+		for (const TraceRecord* record : valid)
+			out.push_back({
+				record->sequence,
+				header->system_origin + (record->timestamp - header->steady_origin),
+				record->thread,
+				static_cast<Logger::Level>(record->level),
+				get_string(record->tag),
+				format(get_string(record->format), *record)
+			});
+		return out;
+	}
+
+	std::string TraceReader::get_string(const std::uint32_t id) const
+	{
+		const std::uint64_t length_size = sizeof(std::uint32_t);
+		if (id == TraceRing::unknown_string or id + length_size > header->strings_size)
+			return "?";
+		const char* entry = block.data() + header->strings_offset + id;
+		const std::uint64_t length = read_value<std::uint32_t>(reinterpret_cast<const std::uint8_t*>(entry));
+		if (id + length_size + length > header->strings_size)
+			return "?";
+		return std::string(entry + length_size, length);
+	}
+
+	std::string TraceReader::format(const std::string& format, const TraceRecord& record)
+	{
+		using namespace utils::string::details;
+
+		std::vector<argument_value> values(record.count);
+		std::vector<argument> arguments;
+		arguments.reserve(record.count);
+
+		const std::size_t size = std::min<std::size_t>(record.size, sizeof(record.arguments));
+		std::size_t position = 0;
+		for (argument_value& value : values)
+		{
+			if (position >= size)
+				break;
+			const TraceArgument type = static_cast<TraceArgument>(record.arguments[position++]);
+			const std::uint8_t* data = record.arguments + position;
+			const std::size_t rest = size - position;
+			std::size_t used = sizeof(std::uint64_t);
+			switch (type)
+			{
+			case TraceArgument::Signed:
+				if (rest >= used)
+					arguments.push_back(make_argument(value.signed_value = read_value<std::int64_t>(data)));
+				break;
+			case TraceArgument::Unsigned:
+				if (rest >= used)
+					arguments.push_back(make_argument(value.unsigned_value = read_value<std::uint64_t>(data)));
+				break;
+			case TraceArgument::Floating:
+				if (rest >= used)
+					arguments.push_back(make_argument(value.floating_value = read_value<double>(data)));
+				break;
+			case TraceArgument::Pointer:
+				if (rest >= used)
+					arguments.push_back(make_argument(value.pointer_value = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(read_value<std::uint64_t>(data)))));
+				break;
+			case TraceArgument::Boolean:
+				used = 1;
+				if (rest >= used)
+					arguments.push_back(make_argument(value.boolean_value = data[0] != 0));
+				break;
+			case TraceArgument::Character:
+				used = 1;
+				if (rest >= used)
+					arguments.push_back(make_argument(value.character_value = static_cast<char>(data[0])));
+				break;
+			case TraceArgument::String:
+				used = rest == 0 ? 1 : 1 + std::min<std::size_t>(data[0], rest - 1);
+				if (rest != 0)
+				{
+					value.string_value.assign(reinterpret_cast<const char*>(data) + 1, used - 1);
+					arguments.push_back(make_argument(value.string_value));
+				}
+				break;
+			default:
+				used = size;
+			}
+			position += used;
+		}
+
+		buffer out;
+		utils::string::details::format(out, format.data(), format.data() + format.size(), arguments.data(), arguments.data() + arguments.size());
+		return std::string(out.data(), out.size());
+	}
+}
+}
@@ -71,6 +71,7 @@ namespace tools
 //				components::Description {"service", "logger", "", "logger_factory"},
 				components::Description {"service", "resource_manager", "system", "get_resource_manager_factory"},
 				components::Description {"resource_loader", "property_tree_loader", "system", "get_property_tree_loader_factory"},
+				components::Description {"resource_loader", "binary_property_tree_loader", "system", "get_binary_property_tree_loader_factory"},
 				components::Description {"service", "engine_component_factory", "system", "get_engine_component_factory_factory"},
 				components::Description {"service", "events_manager", "system", "get_events_manager_factory"},
 			};
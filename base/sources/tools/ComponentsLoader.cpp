@@ -72,8 +72,8 @@ namespace components
 		std::vector<std::string> out;
 		for(const auto& libname : desc["dependencies"].as_array())
 		{
-			if (libname.second.is_string())
-				out.push_back(libname.second.as_string());
+			if (libname.is_string())
+				out.push_back(libname.as_string());
 			else
 				logger::warning("component_loader", "Unexpected type of 'dependency'; skip it");
 		}
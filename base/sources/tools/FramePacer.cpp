@@ -0,0 +1,122 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/tools/FramePacer.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __linux__
+#	include <cerrno>
+#	include <time.h>
+#else
+#	include <thread>
+#endif
+
+namespace pisk
+{
+namespace tools
+{
+	void sleep_until(const std::chrono::steady_clock::time_point time)
+	{
+#ifdef __linux__
+		//steady_clock of libstdc++ and libc++ is CLOCK_MONOTONIC
+		const auto since_epoch = time.time_since_epoch();
+		const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+		timespec deadline;
+		deadline.tv_sec = static_cast<time_t>(seconds.count());
+		deadline.tv_nsec = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count());
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+			;
+#else
+		std::this_thread::sleep_until(time);
+#endif
+	}
+
+	FramePacer::FramePacer(const Clock::duration interval, const FrameOverrun overrun, const std::size_t max_catch_up) :
+		interval(std::max(interval, Clock::duration(1))),
+		overrun(overrun),
+		max_catch_up(max_catch_up)
+	{}
+
+	std::size_t FramePacer::advance(const Clock::time_point now)
+	{
+		if (not started)
+		{
+			started = true;
+			frame = now;
+			return 1;
+		}
+
+		frame += interval;
+		if (now < frame)
+			return 1;
+
+		//the tick is late: the frame moves to the last slot before `now`
+		const auto missed = static_cast<std::size_t>((now - frame) / interval);
+		frame += interval * missed;
+		if (overrun == FrameOverrun::Skip)
+			return 1;
+		return 1 + std::min(missed, max_catch_up);
+	}
+
+	std::size_t FramePacer::wait_next_frame()
+	{
+		const std::size_t updates = advance(Clock::now());
+		sleep_until(frame);
+		return updates;
+	}
+
+	void TickStatistics::tick(const Clock::time_point now)
+	{
+		if (last_tick == Clock::time_point())
+		{
+			last_tick = now;
+			return;
+		}
+		const auto period = now - last_tick;
+		last_tick = now;
+
+		++count;
+		total += period;
+		min = std::min(min, period);
+
+		if (periods.size() < window)
+			periods.push_back(period);
+		else
+			periods[next_period] = period;
+		next_period = (next_period + 1) % window;
+	}
+
+	TickStatistics::Clock::duration TickStatistics::get_min() const
+	{
+		return count == 0 ? Clock::duration::zero() : min;
+	}
+
+	TickStatistics::Clock::duration TickStatistics::get_average() const
+	{
+		return count == 0 ? Clock::duration::zero() : total / static_cast<Clock::rep>(count);
+	}
+
+	TickStatistics::Clock::duration TickStatistics::get_percentile(const double percent) const
+	{
+		if (periods.empty())
+			return Clock::duration::zero();
+		std::vector<Clock::duration> sorted(periods);
+		const auto rank = static_cast<std::size_t>(std::ceil(percent * sorted.size() / 100.));
+		const auto nth = sorted.begin() + (std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1);
+		std::nth_element(sorted.begin(), nth, sorted.end());
+		return *nth;
+	}
+}
+}
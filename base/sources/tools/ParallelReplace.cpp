@@ -0,0 +1,152 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/tools/ParallelReplace.h>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace pisk
+{
+namespace tools
+{
+	namespace
+	{
+		using items_t = std::vector<utils::property::replace_item>;
+		using merge_t = void (*)(utils::property&, const utils::property&);
+		using split_t = items_t (*)(utils::property&, const utils::property&);
+
+		//The items are taken by chunks by the caller and by the helpers on the pool; a helper which starts
+		//when all the chunks are taken exits at once, so the caller waits for the merges, not for the helpers
+		struct parallel_merge
+		{
+			const items_t items;
+			const merge_t merge;
+			const std::size_t chunk_size;
+			const std::size_t chunks_count;
+			std::atomic<std::size_t> next_chunk {0};
+
+			std::mutex guard;
+			std::condition_variable done_signal;
+			std::size_t done_chunks = 0;
+			std::exception_ptr error;
+
+			parallel_merge(items_t&& items, const merge_t merge, const std::size_t chunk_size):
+				items(std::move(items)),
+				merge(merge),
+				chunk_size(chunk_size),
+				chunks_count((this->items.size() + chunk_size - 1) / chunk_size)
+			{}
+
+			void run()
+			{
+				for (std::size_t chunk = next_chunk++; chunk < chunks_count; chunk = next_chunk++)
+				{
+					std::exception_ptr chunk_error;
+					const std::size_t end = std::min(items.size(), (chunk + 1) * chunk_size);
+					for (std::size_t index = chunk * chunk_size; index < end; ++index)
+					{
+						try
+						{
+							merge(*items[index].first, *items[index].second);
+						}
+						catch (...)
+						{
+							if (chunk_error == nullptr)
+								chunk_error = std::current_exception();
+						}
+					}
+
+					std::unique_lock<std::mutex> lock(guard);
+					if (chunk_error != nullptr and error == nullptr)
+						error = chunk_error;
+					if (++done_chunks == chunks_count)
+						done_signal.notify_all();
+				}
+			}
+
+			void wait()
+			{
+				std::unique_lock<std::mutex> lock(guard);
+				done_signal.wait(lock, [this]() {
+					return done_chunks == chunks_count;
+				});
+				if (error != nullptr)
+					std::rethrow_exception(error);
+			}
+		};
+
+		void merge_items_parallel(items_t&& items, const merge_t merge, ThreadPool& pool)
+		{
+			if (items.empty())
+				return;
+			//a few chunks per worker: the subtrees of the children are not of the same size
+			const std::size_t helpers = pool.threads_count();
+			const std::size_t chunk_size = std::max<std::size_t>(16, items.size() / ((helpers + 1) * 4));
+			auto task = std::make_shared<parallel_merge>(std::move(items), merge, chunk_size);
+			for (std::size_t index = 0; index < std::min(helpers, task->chunks_count - 1); ++index)
+				pool.post([task]() {
+					task->run();
+				}, ThreadPool::Priority::High);
+			task->run();
+			task->wait();
+		}
+
+		bool is_large(const utils::property& admixture, const std::size_t threshold)
+		{
+			if (not admixture.is_dictionary())
+				return false;
+			const utils::property& children = admixture["children"_ks];
+			return children.is_dictionary() and children.size() >= threshold;
+		}
+
+		void merge_parallel(utils::property& original, const utils::property& admixture, const merge_t merge, const split_t split, ThreadPool& pool, const std::size_t threshold)
+		{
+			if (not is_large(admixture, threshold) or not original.get_resource().is_equal(*utils::new_delete_resource()))
+				return merge(original, admixture);
+
+			const utils::property& children = admixture["children"_ks];
+			for (const auto& item : split(original, admixture))
+				if (item.second != &children)
+					merge(*item.first, *item.second);
+				else
+					merge_items_parallel(split(*item.first, *item.second), merge, pool);
+		}
+	}
+
+	void replace_parallel(utils::property& original, const utils::property& admixture, ThreadPool& pool, const std::size_t threshold)
+	{
+		merge_parallel(original, admixture, &utils::property::replace, &utils::property::replace_items, pool, threshold);
+	}
+
+	void replace_parallel(utils::property& original, const utils::property& admixture)
+	{
+		replace_parallel(original, admixture, ThreadPool::shared());
+	}
+
+	void apply_patch_parallel(utils::property& original, const utils::property& patch, ThreadPool& pool, const std::size_t threshold)
+	{
+		merge_parallel(original, patch, &utils::property::apply_patch, &utils::property::patch_items, pool, threshold);
+	}
+
+	void apply_patch_parallel(utils::property& original, const utils::property& patch)
+	{
+		apply_patch_parallel(original, patch, ThreadPool::shared());
+	}
+}
+}
+
@@ -0,0 +1,258 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/tools/ThreadPool.h>
+
+#include <pisk/infrastructure/Exception.h>
+#include <pisk/infrastructure/Logger.h>
+
+#include <algorithm>
+#include <deque>
+
+namespace pisk
+{
+namespace tools
+{
+	namespace
+	{
+		struct current_worker
+		{
+			const ThreadPool* pool;
+			std::size_t index;
+		};
+		thread_local current_worker current = {nullptr, 0};
+
+		//the timers make a min-heap by the due time
+		template <typename Timer>
+		bool is_later(const Timer& left, const Timer& right)
+		{
+			return left.due > right.due;
+		}
+	}
+
+	constexpr std::size_t ThreadPool::priorities_count;
+	constexpr ThreadPool::Clock::rep ThreadPool::no_timers;
+
+	struct ThreadPool::worker
+	{
+		std::mutex guard;
+		std::deque<Task> queues[priorities_count];
+	};
+
+	ThreadPool& ThreadPool::shared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	std::size_t ThreadPool::default_threads_count()
+	{
+		return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	ThreadPool::ThreadPool(const std::size_t threads_count)
+	{
+		if (threads_count == 0)
+			throw infrastructure::InvalidArgumentException();
+
+		for (std::size_t index = 0; index < threads_count; ++index)
+			workers.emplace_back(new worker);
+		threads.reserve(threads_count);
+		for (std::size_t index = 0; index < threads_count; ++index)
+			threads.emplace_back(&ThreadPool::run, this, index);
+		logger::debug("thread_pool", "Started {} workers: {}", threads_count, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(sleep_guard);
+			stopping = true;
+			wake.notify_all();
+		}
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	std::size_t ThreadPool::threads_count() const
+	{
+		return workers.size();
+	}
+
+	bool ThreadPool::is_worker_thread() const threadsafe
+	{
+		return current.pool == this;
+	}
+
+	void ThreadPool::post(Task task, const Priority priority) threadsafe
+	{
+		if (not task)
+			throw infrastructure::NullPointerException();
+
+		const std::size_t index = is_worker_thread() ? current.index : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+		//counted before it is published: a thief which takes the task at once must not decrement below zero.
+		//pairs with the sleeping worker: either it sees the pending task or we see it sleeping
+		pending.fetch_add(1, std::memory_order_seq_cst);
+		{
+			worker& target = *workers[index];
+			std::unique_lock<std::mutex> lock(target.guard);
+			target.queues[static_cast<std::size_t>(priority)].emplace_back(std::move(task));
+		}
+		if (sleeping.load(std::memory_order_seq_cst) == 0)
+			return;
+		std::unique_lock<std::mutex> lock(sleep_guard);
+		wake.notify_one();
+	}
+
+	void ThreadPool::post_after(const Clock::duration delay, Task task, const Priority priority) threadsafe
+	{
+		if (not task)
+			throw infrastructure::NullPointerException();
+
+		{
+			std::unique_lock<std::mutex> lock(timers_guard);
+			timers.push_back(timer {Clock::now() + delay, priority, std::move(task)});
+			std::push_heap(timers.begin(), timers.end(), is_later<timer>);
+			next_due.store(timers.front().due.time_since_epoch().count(), std::memory_order_release);
+		}
+		//the sleeping workers wait for the former earliest timer
+		std::unique_lock<std::mutex> lock(sleep_guard);
+		wake.notify_all();
+	}
+
+	bool ThreadPool::run_pending_task() threadsafe
+	{
+		if (not is_worker_thread())
+			return false;
+		Task task;
+		if (not take(current.index, task))
+			return false;
+		execute(task);
+		return true;
+	}
+
+	//The own queue is taken from the front, so the tasks which repost themselves do not starve others;
+	//the queues of other workers are taken from the back. The higher priority goes first from any queue.
+	bool ThreadPool::take(const std::size_t index, Task& out)
+	{
+		if (pending.load(std::memory_order_acquire) == 0)
+			return false;
+		for (std::size_t priority = 0; priority < priorities_count; ++priority)
+		{
+			{
+				worker& own = *workers[index];
+				std::unique_lock<std::mutex> lock(own.guard);
+				auto& queue = own.queues[priority];
+				if (not queue.empty())
+				{
+					out = std::move(queue.front());
+					queue.pop_front();
+					pending.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			for (std::size_t offset = 1; offset < workers.size(); ++offset)
+			{
+				worker& victim = *workers[(index + offset) % workers.size()];
+				std::unique_lock<std::mutex> lock(victim.guard, std::try_to_lock);
+				if (not lock.owns_lock())
+					continue;
+				auto& queue = victim.queues[priority];
+				if (queue.empty())
+					continue;
+				out = std::move(queue.back());
+				queue.pop_back();
+				pending.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::post_due_timers()
+	{
+		const Clock::rep due = next_due.load(std::memory_order_acquire);
+		if (due == no_timers or Clock::now().time_since_epoch().count() < due)
+			return;
+
+		std::unique_lock<std::mutex> lock(timers_guard);
+		const Clock::time_point now = Clock::now();
+		while (not timers.empty() and timers.front().due <= now)
+		{
+			std::pop_heap(timers.begin(), timers.end(), is_later<timer>);
+			timer item = std::move(timers.back());
+			timers.pop_back();
+			post(std::move(item.task), item.priority);
+		}
+		next_due.store(timers.empty() ? no_timers : timers.front().due.time_since_epoch().count(), std::memory_order_release);
+	}
+
+	void ThreadPool::run(const std::size_t index)
+	{
+		current = {this, index};
+		Task task;
+		while (true)
+		{
+			post_due_timers();
+			if (take(index, task))
+			{
+				execute(task);
+				continue;
+			}
+			//a task is counted but was locked by the owner or another thief
+			if (pending.load(std::memory_order_acquire) != 0)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(sleep_guard);
+			sleeping.fetch_add(1, std::memory_order_seq_cst);
+			const Clock::rep due = next_due.load(std::memory_order_acquire);
+			//a new earlier timer changes the time to wake up
+			const auto ready = [this, due]() {
+				return stopping or pending.load(std::memory_order_seq_cst) != 0 or next_due.load(std::memory_order_acquire) != due;
+			};
+			if (due == no_timers)
+				wake.wait(lock, ready);
+			else
+				wake.wait_until(lock, Clock::time_point(Clock::duration(due)), ready);
+			sleeping.fetch_sub(1, std::memory_order_relaxed);
+			if (stopping and pending.load(std::memory_order_acquire) == 0)
+				break;
+		}
+		current = {nullptr, 0};
+	}
+
+	void ThreadPool::execute(Task& task)
+	{
+		try
+		{
+			task();
+		}
+		catch (const infrastructure::Exception&)
+		{
+			logger::error("thread_pool", "Task failed: infrastructure exception");
+		}
+		catch (const std::exception& ex)
+		{
+			logger::error("thread_pool", "Task failed: {}", ex.what());
+		}
+		catch (...)
+		{
+			logger::error("thread_pool", "Task failed: unknown exception");
+		}
+		task = nullptr;
+	}
+}
+}
+
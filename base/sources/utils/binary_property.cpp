@@ -0,0 +1,346 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/defines.h>
+#include <pisk/utils/binary_property.h>
+
+#include <pisk/infrastructure/Logger.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <typeinfo>
+#include <cstring>
+#include <vector>
+
+namespace pisk
+{
+namespace utils
+{
+namespace binary
+{
+	namespace
+	{
+		const char magic[4] = {'P', 'S', 'K', 'B'};
+		constexpr std::size_t value_size = 8;
+		constexpr std::size_t entry_size = 4 + value_size;
+		constexpr std::size_t root_offset = header_size - value_size;
+		constexpr std::size_t max_depth = 1024;
+
+		class BinaryFormatException : public infrastructure::Exception
+		{};
+
+		class writer
+		{
+			infrastructure::DataBuffer out;
+			std::unordered_map<keystring, std::uint32_t> string_indexes;
+			std::vector<keystring> strings;
+
+		public:
+			infrastructure::DataBuffer write(const property& root)
+			{
+				out.assign(header_size, 0);
+				std::copy(std::begin(magic), std::end(magic), out.begin());
+				put16(4, format_version);
+				write_value(root_offset, root);
+
+				const std::uint32_t strings_offset = append(4 * strings.size());
+				for (std::size_t index = 0; index < strings.size(); ++index)
+				{
+					const keystring& str = strings[index];
+					const std::uint32_t offset = append(4 + str.size() + 1);
+					put32(offset, static_cast<std::uint32_t>(str.size()));
+					std::copy(str.begin(), str.end(), out.begin() + offset + 4);
+					put32(strings_offset + 4 * index, offset);
+				}
+				put32(8, static_cast<std::uint32_t>(out.size()));
+				put32(12, static_cast<std::uint32_t>(strings.size()));
+				put32(16, strings_offset);
+				return std::move(out);
+			}
+
+		private:
+			//returns the offset of the new zeroed 4-byte aligned block
+			std::uint32_t append(const std::size_t size)
+			{
+				const std::size_t offset = out.size();
+				if (offset + size > UINT32_MAX)
+					throw infrastructure::OutOfRangeException();
+				out.resize(offset + (size + 3) / 4 * 4, 0);
+				return static_cast<std::uint32_t>(offset);
+			}
+			void put16(const std::size_t offset, const std::uint16_t value)
+			{
+				out[offset] = value & 0xff;
+				out[offset + 1] = value >> 8;
+			}
+			void put32(const std::size_t offset, const std::uint32_t value)
+			{
+				for (std::size_t byte = 0; byte < 4; ++byte)
+					out[offset + byte] = (value >> (8 * byte)) & 0xff;
+			}
+			void put64(const std::size_t offset, const std::uint64_t value)
+			{
+				put32(offset, static_cast<std::uint32_t>(value));
+				put32(offset + 4, static_cast<std::uint32_t>(value >> 32));
+			}
+			template <typename T, typename Bits>
+			static Bits bits_of(const T value)
+			{
+				static_assert(sizeof(T) == sizeof(Bits), "Unexpected size of the type");
+				Bits out;
+				std::memcpy(&out, &value, sizeof(out));
+				return out;
+			}
+
+			std::uint32_t string_index(const keystring& str)
+			{
+				const auto& found = string_indexes.emplace(str, static_cast<std::uint32_t>(strings.size()));
+				if (found.second)
+					strings.push_back(str);
+				return found.first->second;
+			}
+
+			void write_value(const std::size_t offset, const property& value)
+			{
+				put32(offset, static_cast<std::uint32_t>(value.get_type()));
+				put32(offset + 4, write_payload(value));
+			}
+			std::uint32_t write_payload(const property& value)
+			{
+				switch (value.get_type())
+				{
+					case property::type::_none:   return 0;
+					case property::type::_bool:   return value.as_bool() ? 1 : 0;
+					case property::type::_int:    return bits_of<int, std::uint32_t>(value.as_int());
+					case property::type::_float:  return bits_of<float, std::uint32_t>(value.as_float());
+					case property::type::_long:
+					{
+						const std::uint32_t offset = append(8);
+						put64(offset, static_cast<std::uint64_t>(static_cast<std::int64_t>(value.as_long())));
+						return offset;
+					}
+					case property::type::_double:
+					{
+						const std::uint32_t offset = append(8);
+						put64(offset, bits_of<double, std::uint64_t>(value.as_double()));
+						return offset;
+					}
+					case property::type::_string: return string_index(value.as_keystring());
+					case property::type::_dictionary: return write_dictionary(value);
+					case property::type::_array: return write_array(value);
+				}
+				throw BinaryFormatException();
+			}
+			std::uint32_t write_dictionary(const property& value)
+			{
+				std::vector<std::pair<keystring, const property*>> items;
+				items.reserve(value.size());
+				for (auto it = value.begin(); it != value.end(); ++it)
+					items.emplace_back(it.get_key(), &*it);
+				std::sort(items.begin(), items.end(), [](const auto& left, const auto& right) {
+					return left.first.get_content() < right.first.get_content();
+				});
+
+				const std::uint32_t offset = append(4 + entry_size * items.size());
+				put32(offset, static_cast<std::uint32_t>(items.size()));
+				for (std::size_t index = 0; index < items.size(); ++index)
+				{
+					const std::size_t entry = offset + 4 + entry_size * index;
+					put32(entry, string_index(items[index].first));
+					write_value(entry + 4, *items[index].second);
+				}
+				return offset;
+			}
+			std::uint32_t write_array(const property& value)
+			{
+				//holes are stored as none
+				std::size_t count = 0;
+				for (auto it = value.begin(); it != value.end(); ++it)
+					count = it.get_index() + 1;
+
+				const std::uint32_t offset = append(4 + value_size * count);
+				put32(offset, static_cast<std::uint32_t>(count));
+				for (auto it = value.begin(); it != value.end(); ++it)
+					write_value(offset + 4 + value_size * it.get_index(), *it);
+				return offset;
+			}
+		};
+
+		class reader
+		{
+			const unsigned char* data;
+			const std::size_t size;
+			std::uint32_t strings_count = 0;
+			std::uint32_t strings_offset = 0;
+			std::vector<keystring> strings;
+
+		public:
+			reader(const void* data, const std::size_t size):
+				data(static_cast<const unsigned char*>(data)),
+				size(size)
+			{}
+
+			property read()
+			{
+				if (not is_binary_property(data, size))
+					throw BinaryFormatException();
+				if (get32(8) != size)
+					throw BinaryFormatException();
+				strings_count = get32(12);
+				strings_offset = get32(16);
+				check(strings_offset, 4 * static_cast<std::size_t>(strings_count));
+				strings.resize(strings_count);
+				return read_value(root_offset, 0);
+			}
+
+		private:
+			void check(const std::size_t offset, const std::size_t count) const
+			{
+				if (offset > size or count > size - offset)
+					throw BinaryFormatException();
+			}
+			std::uint32_t get32(const std::size_t offset) const
+			{
+				check(offset, 4);
+				return static_cast<std::uint32_t>(data[offset])
+					| static_cast<std::uint32_t>(data[offset + 1]) << 8
+					| static_cast<std::uint32_t>(data[offset + 2]) << 16
+					| static_cast<std::uint32_t>(data[offset + 3]) << 24;
+			}
+			std::uint64_t get64(const std::size_t offset) const
+			{
+				return get32(offset) | static_cast<std::uint64_t>(get32(offset + 4)) << 32;
+			}
+			template <typename T, typename Bits>
+			static T from_bits(const Bits bits)
+			{
+				static_assert(sizeof(T) == sizeof(Bits), "Unexpected size of the type");
+				T out;
+				std::memcpy(&out, &bits, sizeof(out));
+				return out;
+			}
+
+			//every string is converted once, the same keys of the tree share one keystring
+			const keystring& get_string(const std::uint32_t index)
+			{
+				if (index >= strings_count)
+					throw BinaryFormatException();
+				keystring& str = strings[index];
+				if (str.empty())
+				{
+					const std::uint32_t offset = get32(strings_offset + 4 * index);
+					const std::uint32_t length = get32(offset);
+					check(offset + 4, length);
+					str = keystring(std::string(reinterpret_cast<const char*>(data + offset + 4), length));
+				}
+				return str;
+			}
+
+			property read_value(const std::size_t offset, const std::size_t depth)
+			{
+				if (depth > max_depth)
+					throw BinaryFormatException();
+				const std::uint32_t tag = get32(offset);
+				const std::uint32_t payload = get32(offset + 4);
+				switch (static_cast<property::type>(tag))
+				{
+					case property::type::_none:   return {};
+					case property::type::_bool:   return payload != 0;
+					case property::type::_int:    return from_bits<int>(payload);
+					case property::type::_float:  return from_bits<float>(payload);
+					case property::type::_long:   return static_cast<long>(static_cast<std::int64_t>(get64(payload)));
+					case property::type::_double: return from_bits<double>(get64(payload));
+					case property::type::_string: return get_string(payload);
+					case property::type::_dictionary: return read_dictionary(payload, depth);
+					case property::type::_array:  return read_array(payload, depth);
+				}
+				throw BinaryFormatException();
+			}
+			property read_dictionary(const std::size_t offset, const std::size_t depth)
+			{
+				const std::uint32_t count = get32(offset);
+				check(offset + 4, entry_size * static_cast<std::size_t>(count));
+				property::dictionary items;
+				items.reserve(count);
+				for (std::size_t index = 0; index < count; ++index)
+				{
+					const std::size_t entry = offset + 4 + entry_size * index;
+					items.emplace(get_string(get32(entry)), read_value(entry + 4, depth + 1));
+				}
+				return property(std::move(items));
+			}
+			property read_array(const std::size_t offset, const std::size_t depth)
+			{
+				const std::uint32_t count = get32(offset);
+				check(offset + 4, value_size * static_cast<std::size_t>(count));
+				property::array items;
+				items.reserve(count);
+				for (std::size_t index = 0; index < count; ++index)
+					items.emplace_back(read_value(offset + 4 + value_size * index, depth + 1));
+				return property(std::move(items));
+			}
+		};
+	}
+
+	bool EXPORT is_binary_property(const void* data, const std::size_t size) threadsafe noexcept
+	{
+		if (data == nullptr or size < header_size)
+			return false;
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		const std::uint16_t version = bytes[4] | bytes[5] << 8;
+		return std::equal(std::begin(magic), std::end(magic), bytes) and version == format_version;
+	}
+
+	utils::property EXPORT parse_binary_to_property(const void* data, const std::size_t size) threadsafe noexcept
+	try
+	{
+		return reader(data, size).read();
+	}
+	catch (const infrastructure::Exception& ex)
+	{
+		logger::error("binary_property", "Failed to parse binary property: {}", typeid(ex).name());
+		return {};
+	}
+	catch (const std::exception& ex)
+	{
+		logger::error("binary_property", "Failed to parse binary property: {}", ex.what());
+		return {};
+	}
+	utils::property EXPORT parse_binary_to_property(const infrastructure::DataBuffer& content) threadsafe noexcept
+	{
+		return parse_binary_to_property(content.data(), content.size());
+	}
+	utils::property EXPORT parse_binary_to_property(const infrastructure::DataStream& data) threadsafe noexcept
+	{
+		const infrastructure::DataBuffer& content = data.readall();
+		return parse_binary_to_property(content);
+	}
+
+	infrastructure::DataBuffer EXPORT to_binary(const utils::property& prop) threadsafe noexcept
+	try
+	{
+		return writer().write(prop);
+	}
+	catch (const infrastructure::Exception& ex)
+	{
+		logger::error("binary_property", "Failed to save binary property: {}", typeid(ex).name());
+		return {};
+	}
+	catch (const std::exception& ex)
+	{
+		logger::error("binary_property", "Failed to save binary property: {}", ex.what());
+		return {};
+	}
+}
+}
+}
@@ -0,0 +1,497 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/defines.h>
+#include <pisk/utils/json_utils.h>
+
+#include <pisk/infrastructure/Logger.h>
+
+#include <typeinfo>
+#include <cstring>
+#include <vector>
+
+namespace pisk
+{
+namespace utils
+{
+namespace json
+{
+namespace details
+{
+	//The structural index: one entry per object or array in the order of the open brackets.
+	//The direct children of a container start at the next entry and follow each other by `next`.
+	struct json_document
+	{
+		struct container
+		{
+			std::uint32_t begin;//offset of the open bracket
+			std::uint32_t end;//offset of the close bracket
+			std::uint32_t next;//index of the first container after this one and its descendants
+		};
+
+		infrastructure::DataBuffer content;
+		std::vector<container> containers;
+
+		const char* data() const
+		{
+			return reinterpret_cast<const char*>(content.data());
+		}
+	};
+}
+
+	namespace
+	{
+		constexpr std::uint32_t npos = UINT32_MAX;
+		constexpr std::size_t stack_limit = 1000;//as parse_json_to_property has
+
+		class JsonStructureException : public infrastructure::Exception
+		{};
+
+		//the bytes which stop the indexer: strings, comments and brackets
+		struct special_table
+		{
+			bool special[256] = {};
+
+			special_table()
+			{
+				for (const unsigned char c : {'"', '/', '{', '}', '[', ']'})
+					special[c] = true;
+			}
+		};
+		const special_table special;
+
+		bool is_space(const char c)
+		{
+			return c == ' ' or c == '\t' or c == '\r' or c == '\n';
+		}
+
+		//`pos` follows the open quote; returns the position after the close quote
+		std::uint32_t skip_string(const char* data, const std::uint32_t size, std::uint32_t pos)
+		{
+			while (true)
+			{
+				const void* found = std::memchr(data + pos, '"', size - pos);
+				if (found == nullptr)
+					throw JsonStructureException();
+				const std::uint32_t quote = static_cast<std::uint32_t>(static_cast<const char*>(found) - data);
+				std::uint32_t slashes = 0;
+				while (quote - slashes > pos and data[quote - slashes - 1] == '\\')
+					++slashes;
+				pos = quote + 1;
+				if (slashes % 2 == 0)
+					return pos;
+			}
+		}
+
+		//`pos` points to the slash
+		std::uint32_t skip_comment(const char* data, const std::uint32_t size, const std::uint32_t pos)
+		{
+			if (pos + 1 >= size)
+				throw JsonStructureException();
+			if (data[pos + 1] == '/')
+			{
+				const void* found = std::memchr(data + pos + 2, '\n', size - pos - 2);
+				return found == nullptr ? size : static_cast<std::uint32_t>(static_cast<const char*>(found) - data) + 1;
+			}
+			if (data[pos + 1] != '*')
+				throw JsonStructureException();
+			for (std::uint32_t current = pos + 2; current < size; )
+			{
+				const void* found = std::memchr(data + current, '*', size - current);
+				if (found == nullptr)
+					break;
+				current = static_cast<std::uint32_t>(static_cast<const char*>(found) - data) + 1;
+				if (current < size and data[current] == '/')
+					return current + 1;
+			}
+			throw JsonStructureException();
+		}
+
+		std::uint32_t skip_spaces(const char* data, const std::uint32_t size, std::uint32_t pos)
+		{
+			while (pos < size)
+			{
+				if (is_space(data[pos]))
+					++pos;
+				else if (data[pos] == '/')
+					pos = skip_comment(data, size, pos);
+				else
+					break;
+			}
+			return pos;
+		}
+
+		bool is_scalar_end(const char c)
+		{
+			return is_space(c) or c == ',' or c == '/' or c == '}' or c == ']';
+		}
+
+		//returns the range of the root value; the text after the root is not indexed as the eager parser ignores it
+		lazy_property build_index(std::shared_ptr<details::json_document> document)
+		{
+			const infrastructure::DataBuffer& content = document->content;
+			if (content.size() >= npos)
+				throw infrastructure::OutOfRangeException();
+			const char* data = document->data();
+			const std::uint32_t size = static_cast<std::uint32_t>(content.size());
+
+			std::uint32_t pos = 0;
+			if (size > 0 and content[0] == 0xEF)
+			{
+				if (size < 3 or content[1] != 0xBB or content[2] != 0xBF)
+					throw JsonStructureException();
+				pos = 3;
+			}
+			const std::uint32_t root = skip_spaces(data, size, pos);
+			if (root == size or (data[root] != '{' and data[root] != '['))
+				return lazy_property(document, root, size, npos);
+
+			std::vector<std::uint32_t> stack;
+			std::vector<details::json_document::container>& containers = document->containers;
+			for (pos = root; pos < size; ++pos)
+			{
+				while (pos < size and not special.special[static_cast<unsigned char>(data[pos])])
+					++pos;
+				if (pos == size)
+					break;
+				switch (data[pos])
+				{
+					case '"':
+						pos = skip_string(data, size, pos + 1) - 1;
+						break;
+					case '/':
+						pos = skip_comment(data, size, pos) - 1;
+						break;
+					case '{':
+					case '[':
+						if (stack.size() > stack_limit)
+							throw infrastructure::OutOfRangeException();
+						stack.push_back(static_cast<std::uint32_t>(containers.size()));
+						containers.push_back({pos, 0, 0});
+						break;
+					default:
+					{
+						details::json_document::container& opened = containers[stack.back()];
+						if ((data[opened.begin] == '{') != (data[pos] == '}'))
+							throw JsonStructureException();
+						opened.end = pos;
+						opened.next = static_cast<std::uint32_t>(containers.size());
+						stack.pop_back();
+						if (stack.empty())
+						{
+							containers.shrink_to_fit();
+							return lazy_property(document, root, pos + 1, 0);
+						}
+					}
+				}
+			}
+			throw JsonStructureException();
+		}
+
+		lazy_property parse(infrastructure::DataBuffer&& content) threadsafe noexcept
+		try
+		{
+			auto document = std::make_shared<details::json_document>();
+			document->content = std::move(content);
+			return build_index(document);
+		}
+		catch (const JsonStructureException&)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", "Broken structure of the document");
+			return {};
+		}
+		catch (const infrastructure::OutOfRangeException&)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", "Exceeded stackLimit in readValue().");
+			return {};
+		}
+		catch (const infrastructure::Exception& ex)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", typeid(ex).name());
+			return {};
+		}
+		catch (const std::exception& ex)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", ex.what());
+			return {};
+		}
+
+		struct member
+		{
+			std::uint32_t key_begin = 0;
+			std::uint32_t key_end = 0;
+			std::uint32_t value_begin = 0;
+			std::uint32_t value_end = 0;
+			std::uint32_t node = npos;
+		};
+
+		//Scans one member of the container closed at `close`, starting from `pos` (after the open bracket or a comma).
+		//Nested containers are skipped by the index: `cursor` is the index of the next nested container.
+		//Returns false at the end of the container.
+		bool scan_member(const details::json_document& document, const bool dictionary, const std::uint32_t close, std::uint32_t& pos, std::uint32_t& cursor, member& out)
+		{
+			const char* data = document.data();
+			pos = skip_spaces(data, close, pos);
+			if (pos >= close)
+				return false;
+			if (dictionary)
+			{
+				if (data[pos] != '"')
+					throw JsonStructureException();
+				out.key_begin = pos;
+				out.key_end = pos = skip_string(data, close, pos + 1);
+				pos = skip_spaces(data, close, pos);
+				if (pos >= close or data[pos] != ':')
+					throw JsonStructureException();
+				pos = skip_spaces(data, close, pos + 1);
+				if (pos >= close)
+					throw JsonStructureException();
+			}
+
+			out.value_begin = pos;
+			out.node = npos;
+			if (data[pos] == '{' or data[pos] == '[')
+			{
+				const details::json_document::container& nested = document.containers[cursor];
+				out.node = cursor;
+				cursor = nested.next;
+				pos = nested.end + 1;
+			}
+			else if (data[pos] == '"')
+				pos = skip_string(data, close, pos + 1);
+			else
+				while (pos < close and not is_scalar_end(data[pos]))
+					++pos;
+			if (pos == out.value_begin)
+				throw JsonStructureException();
+			out.value_end = pos;
+
+			pos = skip_spaces(data, close, pos);
+			if (pos < close)
+			{
+				if (data[pos] != ',')
+					throw JsonStructureException();
+				++pos;
+			}
+			return true;
+		}
+
+		//walks the members of the container until `fn` returns false
+		template <typename Fn>
+		void for_each_member(const details::json_document& document, const std::uint32_t node, Fn&& fn)
+		try
+		{
+			const details::json_document::container& container = document.containers[node];
+			const bool dictionary = document.data()[container.begin] == '{';
+			std::uint32_t pos = container.begin + 1;
+			std::uint32_t cursor = node + 1;
+			member item;
+			while (scan_member(document, dictionary, container.end, pos, cursor, item))
+				if (not fn(item))
+					return;
+		}
+		catch (const JsonStructureException&)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", "Broken member of the container");
+		}
+
+		//the escaped keys are decoded by the regular parser
+		bool is_key_equal(const char* data, const member& item, const char* key, const std::size_t size)
+		{
+			const char* raw = data + item.key_begin + 1;
+			const std::size_t raw_size = item.key_end - item.key_begin - 2;
+			if (std::memchr(raw, '\\', raw_size) == nullptr)
+				return raw_size == size and std::memcmp(raw, key, size) == 0;
+			const std::string& decoded = parse_json_to_property(data + item.key_begin, item.key_end - item.key_begin).as_string();
+			return decoded.size() == size and std::memcmp(decoded.data(), key, size) == 0;
+		}
+	}
+
+	lazy_property::lazy_property(const std::shared_ptr<const details::json_document>& document, const std::uint32_t begin, const std::uint32_t end, const std::uint32_t node):
+		document(document),
+		begin_offset(begin),
+		end_offset(end),
+		node(node)
+	{}
+
+	property::type lazy_property::get_type() const
+	{
+		if (document == nullptr or begin_offset == end_offset)
+			return property::type::_none;
+		const char* data = document->data();
+		switch (data[begin_offset])
+		{
+			case '{':
+			case '[':
+			{
+				//empty containers are none as parse_json_to_property gives
+				const std::uint32_t close = document->containers[node].end;
+				if (skip_spaces(data, close, begin_offset + 1) == close)
+					return property::type::_none;
+				return data[begin_offset] == '{' ? property::type::_dictionary : property::type::_array;
+			}
+			case '"':
+				return property::type::_string;
+			case 't':
+			case 'f':
+				return property::type::_bool;
+			case 'n':
+				return property::type::_none;
+			default:
+				return property::type::_double;
+		}
+	}
+
+	std::size_t lazy_property::size() const
+	{
+		const property::type type = get_type();
+		if (type == property::type::_none)
+			return 0;
+		if (type == property::type::_string)
+			return materialize().size();
+		if (type != property::type::_dictionary and type != property::type::_array)
+			throw PropertyCastException();
+		std::size_t count = 0;
+		for_each_member(*document, node, [&count](const member&) {
+			++count;
+			return true;
+		});
+		return count;
+	}
+
+	lazy_property lazy_property::find(const char* key, const std::size_t size) const
+	{
+		const property::type type = get_type();
+		if (type == property::type::_none)
+			return {};
+		if (type != property::type::_dictionary)
+			throw PropertyCastException();
+		const char* data = document->data();
+		lazy_property out;
+		for_each_member(*document, node, [&](const member& item) {
+			//the last of the duplicated keys wins
+			if (is_key_equal(data, item, key, size))
+				out = lazy_property(document, item.value_begin, item.value_end, item.node);
+			return true;
+		});
+		return out;
+	}
+
+	lazy_property lazy_property::find(const std::size_t index) const
+	{
+		const property::type type = get_type();
+		if (type == property::type::_none)
+			return {};
+		if (type != property::type::_array)
+			throw PropertyCastException();
+		std::size_t current = 0;
+		lazy_property out;
+		for_each_member(*document, node, [&](const member& item) {
+			if (current++ != index)
+				return true;
+			out = lazy_property(document, item.value_begin, item.value_end, item.node);
+			return false;
+		});
+		return out;
+	}
+
+	lazy_property_iterator lazy_property::begin() const
+	{
+		const property::type type = get_type();
+		if (type == property::type::_none)
+			return end();
+		if (type != property::type::_dictionary and type != property::type::_array)
+			throw PropertyCastException();
+		return lazy_property_iterator(document, node);
+	}
+
+	lazy_property_iterator lazy_property::end() const
+	{
+		const property::type type = get_type();
+		if (type != property::type::_none and type != property::type::_dictionary and type != property::type::_array)
+			throw PropertyCastException();
+		return lazy_property_iterator(document, npos);
+	}
+
+	utils::property lazy_property::materialize() const
+	{
+		if (document == nullptr or begin_offset == end_offset)
+			return {};
+		return parse_json_to_property(document->data() + begin_offset, end_offset - begin_offset);
+	}
+
+	lazy_property_iterator::lazy_property_iterator(const std::shared_ptr<const details::json_document>& document, const std::uint32_t node):
+		document(document)
+	{
+		if (node == npos)
+			return;
+		const details::json_document::container& container = document->containers[node];
+		resume = container.begin + 1;
+		close = container.end;
+		cursor = node + 1;
+		dictionary = document->data()[container.begin] == '{';
+		scan();
+	}
+
+	void lazy_property_iterator::scan()
+	try
+	{
+		member item;
+		if (not scan_member(*document, dictionary, close, resume, cursor, item))
+		{
+			position = npos;
+			current = {};
+			return;
+		}
+		position = dictionary ? item.key_begin : item.value_begin;
+		key_begin = item.key_begin;
+		key_end = item.key_end;
+		current = lazy_property(document, item.value_begin, item.value_end, item.node);
+	}
+	catch (const JsonStructureException&)
+	{
+		logger::error("jsoncpp", "Failed to parse json: {}", "Broken member of the container");
+		position = npos;
+		current = {};
+	}
+
+	keystring lazy_property_iterator::get_key() const
+	{
+		if (not dictionary or position == npos)
+			throw PropertyIteratorTypeException();
+		const char* raw = document->data() + key_begin + 1;
+		const std::size_t raw_size = key_end - key_begin - 2;
+		if (std::memchr(raw, '\\', raw_size) == nullptr)
+			return keystring(std::string(raw, raw_size));
+		return parse_json_to_property(raw - 1, raw_size + 2).as_keystring();
+	}
+
+	lazy_property EXPORT parse_json_to_lazy_property(infrastructure::DataBuffer&& content) threadsafe noexcept
+	{
+		return parse(std::move(content));
+	}
+	lazy_property EXPORT parse_json_to_lazy_property(const std::string& document) threadsafe noexcept
+	{
+		return parse(infrastructure::DataBuffer(document.begin(), document.end()));
+	}
+	lazy_property EXPORT parse_json_to_lazy_property(const infrastructure::DataBuffer& content) threadsafe noexcept
+	{
+		return parse(infrastructure::DataBuffer(content));
+	}
+	lazy_property EXPORT parse_json_to_lazy_property(const infrastructure::DataStream& data) threadsafe noexcept
+	{
+		return parse(data.readall());
+	}
+}
+}
+}
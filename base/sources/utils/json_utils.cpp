@@ -16,11 +16,16 @@
 
 #include <pisk/infrastructure/Logger.h>
 
-#include <json/json.h>
-#include <json/reader.h>
-
-#include <memory>
-#include <sstream>
+#include <functional>
+#include <algorithm>
+#include <typeinfo>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <cerrno>
+#include <cmath>
 
 namespace pisk
 {
@@ -28,129 +33,749 @@ namespace utils
 {
 namespace json
 {
-	Json::Value EXPORT load(const std::string& document) threadsafe noexcept
-	try
+	namespace
 	{
-		Json::CharReaderBuilder builder;
-		auto reader = std::unique_ptr<Json::CharReader>(builder.newCharReader());
-		Json::Value root;
-		std::string errors;
-		if (reader->parse(document.data(), document.data() + document.size(), &root, &errors) == false)
+		constexpr std::size_t stack_limit = 1000;//as jsoncpp has
+		constexpr std::size_t chunk_size = 64 * 1024;
+
+		class JsonSyntaxException : public infrastructure::Exception
+		{};
+
+		//Builds the property in place during a single pass, there is no intermediate tree.
+		//The input is read by chunks: `refill` gives the next chunk and returns false at the end of the document.
+		//The semantics follow the former jsoncpp based loader: every number is double, empty objects and arrays
+		//are none, the last of the duplicated keys wins, comments and trailing commas are allowed
+		//and the text after the root value is ignored. A broken document gives the part parsed before the error.
+		class json_parser
+		{
+			using refill_fn = std::function<bool (const char*& begin, const char*& end)>;
+			constexpr static int eof = -1;
+
+			refill_fn refill;
+			const char* chunk = nullptr;
+			const char* current = nullptr;
+			const char* end = nullptr;
+			std::size_t chunk_offset = 0;
+			std::size_t line = 1;
+			std::size_t line_offset = 0;
+			std::string key;
+			std::string token;
+			std::string error;
+
+		public:
+			explicit json_parser(refill_fn refill):
+				refill(std::move(refill))
+			{}
+
+			//returns false and the error description if the document is broken
+			bool parse(property& root, std::string& errors)
+			{
+				try
+				{
+					skip_bom();
+					parse_value(root, 0);
+					return true;
+				}
+				catch (const JsonSyntaxException&)
+				{
+					errors = error;
+					return false;
+				}
+			}
+
+		private:
+			[[noreturn]] void fail(const std::string& message)
+			{
+				const std::size_t position = chunk_offset + (current - chunk);
+				error = utils::string::format("* Line {}, Column {}\n  {}\n", line, position - line_offset + 1, message);
+				throw JsonSyntaxException();
+			}
+
+			void skip_bom()
+			{
+				if (peek() != 0xEF)
+					return;
+				++current;
+				if (get() != 0xBB or get() != 0xBF)
+					fail("Syntax error: value, object or array expected.");
+			}
+
+			bool fill()
+			{
+				do
+				{
+					chunk_offset += end - chunk;
+					if (refill == nullptr or not refill(chunk, end))
+					{
+						refill = nullptr;
+						chunk = current = end = nullptr;
+						return false;
+					}
+					current = chunk;
+				}
+				while (current == end);
+				return true;
+			}
+			int peek()
+			{
+				if (current == end and not fill())
+					return eof;
+				return static_cast<unsigned char>(*current);
+			}
+			int get()
+			{
+				const int c = peek();
+				if (c != eof)
+					++current;
+				return c;
+			}
+			//`next` points to the first char of the new line
+			void new_line(const char* next)
+			{
+				++line;
+				line_offset = chunk_offset + (next - chunk);
+			}
+
+			void skip_spaces()
+			{
+				while (true)
+				{
+					for (; current != end; ++current)
+					{
+						const char c = *current;
+						if (c == '\n')
+							new_line(current + 1);
+						else if (c != ' ' and c != '\t' and c != '\r')
+							break;
+					}
+					if (current == end)
+					{
+						if (not fill())
+							return;
+						continue;
+					}
+					if (*current != '/')
+						return;
+					++current;
+					skip_comment();
+				}
+			}
+			void skip_comment()
+			{
+				const int kind = get();
+				if (kind == '*')
+				{
+					int prev = 0;
+					for (int c = get(); c != eof; prev = c, c = get())
+					{
+						if (c == '\n')
+							new_line(current);
+						else if (c == '/' and prev == '*')
+							return;
+					}
+					fail("Missing '*/' at the end of the comment");
+				}
+				if (kind == '/')
+				{
+					for (int c = get(); c != eof; c = get())
+						if (c == '\n')
+							return new_line(current);
+					return;
+				}
+				fail("Syntax error: value, object or array expected.");
+			}
+
+			void parse_value(property& out, const std::size_t depth)
+			{
+				if (depth > stack_limit)
+					throw infrastructure::OutOfRangeException();
+				skip_spaces();
+				switch (peek())
+				{
+					case '{':
+						++current;
+						return parse_object(out, depth);
+					case '[':
+						++current;
+						return parse_array(out, depth);
+					case '"':
+						++current;
+						parse_string(token);
+						out = token;
+						return;
+					case 't':
+						parse_literal("true");
+						out = true;
+						return;
+					case 'f':
+						parse_literal("false");
+						out = false;
+						return;
+					case 'n':
+						parse_literal("null");
+						out = nullptr;
+						return;
+					case '-': case '0': case '1': case '2': case '3': case '4':
+					case '5': case '6': case '7': case '8': case '9':
+						out = parse_number();
+						return;
+				}
+				fail("Syntax error: value, object or array expected.");
+			}
+			void parse_literal(const char* literal)
+			{
+				for (const char* c = literal; *c != '\0'; ++c)
+					if (get() != *c)
+						fail("Syntax error: value, object or array expected.");
+			}
+
+			void parse_object(property& out, const std::size_t depth)
+			{
+				out = nullptr;
+				skip_spaces();
+				if (peek() == '}')
+				{
+					++current;
+					return;
+				}
+				while (true)
+				{
+					skip_spaces();
+					const int c = get();
+					if (c == '}' and not out.is_none())//trailing comma
+						return;
+					if (c != '"')
+						fail("Missing '}' or object member name");
+					parse_string(key);
+					skip_spaces();
+					if (get() != ':')
+						fail("Missing ':' after object member name");
+					parse_value(out[key], depth + 1);
+					skip_spaces();
+					const int next = get();
+					if (next == '}')
+						return;
+					if (next != ',')
+						fail("Missing ',' or '}' in object declaration");
+				}
+			}
+			void parse_array(property& out, const std::size_t depth)
+			{
+				out = nullptr;
+				skip_spaces();
+				if (peek() == ']')
+				{
+					++current;
+					return;
+				}
+				for (std::size_t index = 0; true; ++index)
+				{
+					skip_spaces();
+					if (index != 0 and peek() == ']')//trailing comma
+					{
+						++current;
+						return;
+					}
+					parse_value(out[index], depth + 1);
+					skip_spaces();
+					const int next = get();
+					if (next == ']')
+						return;
+					if (next != ',')
+						fail("Missing ',' or ']' in array declaration");
+				}
+			}
+
+			void parse_string(std::string& out)
+			{
+				out.clear();
+				while (true)
+				{
+					const char* begin = current;
+					for (; current != end and *current != '"' and *current != '\\'; ++current)
+						if (*current == '\n')
+							new_line(current + 1);
+					out.append(begin, current);
+					if (current == end)
+					{
+						if (not fill())
+							fail("Missing '\"' at the end of the string");
+						continue;
+					}
+					if (*current++ == '"')
+						return;
+					parse_escape(out);
+				}
+			}
+			void parse_escape(std::string& out)
+			{
+				switch (get())
+				{
+					case '"': out += '"'; return;
+					case '/': out += '/'; return;
+					case '\\': out += '\\'; return;
+					case 'b': out += '\b'; return;
+					case 'f': out += '\f'; return;
+					case 'n': out += '\n'; return;
+					case 'r': out += '\r'; return;
+					case 't': out += '\t'; return;
+					case 'u': return append_utf8(out, parse_unicode());
+				}
+				fail("Bad escape sequence in string");
+			}
+			unsigned int parse_unicode()
+			{
+				unsigned int unicode = parse_hex4();
+				if (unicode >= 0xD800 and unicode <= 0xDBFF)
+				{
+					if (get() != '\\' or get() != 'u')
+						fail("expecting another \\u token to begin the second half of a unicode surrogate pair");
+					const unsigned int surrogate = parse_hex4();
+					unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (surrogate & 0x3FF);
+				}
+				return unicode;
+			}
+			unsigned int parse_hex4()
+			{
+				unsigned int out = 0;
+				for (int index = 0; index < 4; ++index)
+				{
+					const int c = get();
+					out *= 16;
+					if (c >= '0' and c <= '9')
+						out += c - '0';
+					else if (c >= 'a' and c <= 'f')
+						out += c - 'a' + 10;
+					else if (c >= 'A' and c <= 'F')
+						out += c - 'A' + 10;
+					else
+						fail("Bad unicode escape sequence in string: hexadecimal digits expected.");
+				}
+				return out;
+			}
+			static void append_utf8(std::string& out, const unsigned int cp)
+			{
+				if (cp <= 0x7F)
+				{
+					out += static_cast<char>(cp);
+				}
+				else if (cp <= 0x7FF)
+				{
+					out += static_cast<char>(0xC0 | (cp >> 6));
+					out += static_cast<char>(0x80 | (cp & 0x3F));
+				}
+				else if (cp <= 0xFFFF)
+				{
+					out += static_cast<char>(0xE0 | (cp >> 12));
+					out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+					out += static_cast<char>(0x80 | (cp & 0x3F));
+				}
+				else if (cp <= 0x10FFFF)
+				{
+					out += static_cast<char>(0xF0 | (cp >> 18));
+					out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+					out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+					out += static_cast<char>(0x80 | (cp & 0x3F));
+				}
+			}
+
+			void take_digits()
+			{
+				for (int c = peek(); c >= '0' and c <= '9'; c = peek())
+				{
+					token += static_cast<char>(c);
+					++current;
+				}
+			}
+			double parse_number()
+			{
+				token.clear();
+				token += static_cast<char>(get());
+				take_digits();
+				bool integer = true;
+				if (peek() == '.')
+				{
+					integer = false;
+					token += static_cast<char>(get());
+					take_digits();
+				}
+				if (peek() == 'e' or peek() == 'E')
+				{
+					integer = false;
+					token += static_cast<char>(get());
+					if (peek() == '+' or peek() == '-')
+						token += static_cast<char>(get());
+					take_digits();
+				}
+				if (integer)
+				{
+					//an integer is converted as jsoncpp does: through the 64-bit integer (so "-0" is 0)
+					const bool negative = token[0] == '-';
+					const std::uint64_t limit = negative ? std::uint64_t(1) << 63 : UINT64_MAX;
+					std::uint64_t value = 0;
+					bool fits = true;//a lone '-' is 0 as well
+					for (std::size_t index = negative ? 1 : 0; fits and index < token.size(); ++index)
+					{
+						const unsigned int digit = token[index] - '0';
+						fits = value <= (limit - digit) / 10;
+						value = value * 10 + digit;
+					}
+					if (fits)
+						return negative and value != 0 ? -static_cast<double>(value) : static_cast<double>(value);
+				}
+				char* token_end = nullptr;
+				errno = 0;
+				const double value = std::strtod(token.c_str(), &token_end);
+				if (token_end != token.c_str() + token.size() or (errno == ERANGE and std::abs(value) == HUGE_VAL))
+					fail("'" + token + "' is not a number.");
+				return value;
+			}
+		};
+
+		utils::property parse(json_parser&& parser) threadsafe noexcept
+		try
 		{
-			logger::error("jsoncpp", "Failed to parse json: {}", errors);
+			utils::property root;
+			std::string errors;
+			if (parser.parse(root, errors) == false)
+				logger::error("jsoncpp", "Failed to parse json: {}", errors);
+			return root;
+		}
+		catch (const infrastructure::OutOfRangeException&)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", "Exceeded stackLimit in readValue().");
+			return {};
+		}
+		catch (const infrastructure::Exception& ex)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", typeid(ex).name());
+			return {};
+		}
+		catch (const std::exception& ex)
+		{
+			logger::error("jsoncpp", "Failed to parse json: {}", ex.what());
+			return {};
+		}
+
+		//returns the original position or DataStream::error if the stream is not seekable
+		std::size_t rewind(infrastructure::DataStream& stream) noexcept
+		try
+		{
+			const std::size_t orig_pos = stream.tell();
+			if (orig_pos == infrastructure::DataStream::error or stream.seek(0, infrastructure::DataStream::Whence::begin) != 0)
+				return infrastructure::DataStream::error;
+			return orig_pos;
+		}
+		catch (const infrastructure::Exception&)
+		{
+			return infrastructure::DataStream::error;
+		}
+
+		utils::property parse(const char* data, const std::size_t size) threadsafe noexcept
+		{
+			bool given = false;
+			return parse(json_parser([&given, data, size](const char*& begin, const char*& end) {
+				if (given)
+					return false;
+				given = true;
+				begin = data;
+				end = data + size;
+				return true;
+			}));
+		}
+
+		//Writes the same text as the former jsoncpp based writer: the keys are sorted, doubles have 17 significant
+		//digits, non-ASCII characters are escaped; none, empty containers and holes of arrays are null.
+		//`Buffer` is std::string or DataBuffer, the text is appended to it.
+		template <typename Buffer>
+		class json_writer
+		{
+			typedef std::pair<const keystring*, const property*> item;
+
+			Buffer& out;
+			const bool pretty;
+			std::size_t depth = 0;
+			std::vector<item> items;//sorted members of the dictionaries being written, shared by all levels
+
+		public:
+			json_writer(Buffer& out, const bool pretty):
+				out(out),
+				pretty(pretty)
+			{
+				items.reserve(32);
+			}
+
+			void write(const property& value)
+			{
+				switch (value.get_type())
+				{
+					case property::type::_none: return append("null");
+					case property::type::_bool: return append(value.as_bool() ? "true" : "false");
+					case property::type::_int: return write_integer(value.as_int());
+					case property::type::_long: return write_integer(static_cast<std::int64_t>(value.as_long()));
+					case property::type::_float: return write_double(value.as_float());
+					case property::type::_double: return write_double(value.as_double());
+					case property::type::_string: return write_string(value.as_keystring().get_content());
+					case property::type::_dictionary: return write_dictionary(value);
+					case property::type::_array: return write_array(value);
+				}
+			}
+
+		private:
+			void append(const char* begin, const char* end)
+			{
+				out.insert(out.end(), begin, end);
+			}
+			void append(const char* str)
+			{
+				append(str, str + std::strlen(str));
+			}
+			void append(const char c)
+			{
+				out.push_back(c);
+			}
+			void new_line()
+			{
+				if (not pretty)
+					return;
+				append('\n');
+				out.insert(out.end(), depth, '\t');
+			}
+
+			void write_integer(const std::int64_t value)
+			{
+				char buffer[24];
+				char* begin = std::end(buffer);
+				std::uint64_t rest = value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+				do
+				{
+					*--begin = static_cast<char>('0' + rest % 10);
+					rest /= 10;
+				}
+				while (rest != 0);
+				if (value < 0)
+					*--begin = '-';
+				append(begin, std::end(buffer));
+			}
+			void write_double(const double value)
+			{
+				if (not std::isfinite(value))
+					return append(std::isnan(value) ? "null" : value < 0 ? "-1e+9999" : "1e+9999");
+				//integral values are printed by %.17g without the exponent up to 1e17; snprintf is much slower
+				if (std::fabs(value) < 1e15 and value == std::trunc(value) and not (value == 0 and std::signbit(value)))
+				{
+					write_integer(static_cast<std::int64_t>(value));
+					return append(".0");
+				}
+				char buffer[32];
+				const int size = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+				std::replace(buffer, buffer + size, ',', '.');//the locale may use the comma
+				append(buffer, buffer + size);
+				if (std::find_if(buffer, buffer + size, [](const char c) { return c == '.' or c == 'e'; }) == buffer + size)
+					append(".0");
+			}
+
+			void write_hex(const unsigned code)
+			{
+				static const char digits[] = "0123456789abcdef";
+				const char buffer[6] = {'\\', 'u', digits[(code >> 12) & 0xf], digits[(code >> 8) & 0xf], digits[(code >> 4) & 0xf], digits[code & 0xf]};
+				append(buffer, buffer + sizeof(buffer));
+			}
+			//invalid sequences are written as U+FFFD
+			static unsigned read_utf8(const unsigned char*& current, const unsigned char* end)
+			{
+				constexpr unsigned replacement = 0xFFFD;
+				const unsigned first = *current;
+				if (first < 0xE0)
+				{
+					if (end - current < 2)
+						return replacement;
+					const unsigned code = ((first & 0x1F) << 6) | (current[1] & 0x3F);
+					current += 1;
+					return code < 0x80 ? replacement : code;
+				}
+				if (first < 0xF0)
+				{
+					if (end - current < 3)
+						return replacement;
+					const unsigned code = ((first & 0x0F) << 12) | ((current[1] & 0x3F) << 6) | (current[2] & 0x3F);
+					current += 2;
+					if (code >= 0xD800 and code <= 0xDFFF)
+						return replacement;
+					return code < 0x800 ? replacement : code;
+				}
+				if (first < 0xF8)
+				{
+					if (end - current < 4)
+						return replacement;
+					const unsigned code = ((first & 0x07) << 18) | ((current[1] & 0x3F) << 12) | ((current[2] & 0x3F) << 6) | (current[3] & 0x3F);
+					current += 3;
+					return code < 0x10000 ? replacement : code;
+				}
+				return replacement;
+			}
+			void write_string(const std::string& str)
+			{
+				append('"');
+				const unsigned char* current = reinterpret_cast<const unsigned char*>(str.data());
+				const unsigned char* end = current + str.size();
+				while (current != end)
+				{
+					//the characters which need no escaping are copied at once
+					const unsigned char* plain = current;
+					while (current != end and *current >= 0x20 and *current < 0x80 and *current != '"' and *current != '\\')
+						++current;
+					append(reinterpret_cast<const char*>(plain), reinterpret_cast<const char*>(current));
+					if (current == end)
+						break;
+					switch (*current)
+					{
+						case '"': append("\\\""); break;
+						case '\\': append("\\\\"); break;
+						case '\b': append("\\b"); break;
+						case '\f': append("\\f"); break;
+						case '\n': append("\\n"); break;
+						case '\r': append("\\r"); break;
+						case '\t': append("\\t"); break;
+						default:
+						{
+							const unsigned code = *current < 0x80 ? *current : read_utf8(current, end);
+							if (code < 0x10000)
+								write_hex(code);
+							else
+							{
+								write_hex(0xD800 + (((code - 0x10000) >> 10) & 0x3FF));
+								write_hex(0xDC00 + ((code - 0x10000) & 0x3FF));
+							}
+						}
+					}
+					++current;
+				}
+				append('"');
+			}
+
+			void write_dictionary(const property& value)
+			{
+				const std::size_t first = items.size();
+				for (auto it = value.begin(); it != value.end(); ++it)
+					items.emplace_back(&it.get_key(), &*it);
+				const std::size_t last = items.size();
+				if (first == last)
+					return append("null");
+				std::sort(items.begin() + first, items.end(), [](const item& left, const item& right) {
+					return left.first->get_content() < right.first->get_content();
+				});
+
+				append('{');
+				++depth;
+				for (std::size_t index = first; index < last; ++index)
+				{
+					if (index != first)
+						append(',');
+					new_line();
+					write_string(items[index].first->get_content());
+					append(pretty ? ": " : ":");
+					write(*items[index].second);
+				}
+				--depth;
+				new_line();
+				append('}');
+				items.resize(first);
+			}
+			void write_array(const property& value)
+			{
+				if (value.begin() == value.end())
+					return append("null");
+				append('[');
+				++depth;
+				std::size_t next = 0;
+				for (auto it = value.begin(); it != value.end(); ++it, ++next)
+				{
+					for (; next < it.get_index(); ++next)
+					{
+						append(next == 0 ? "" : ",");
+						new_line();
+						append("null");
+					}
+					if (next != 0)
+						append(',');
+					new_line();
+					write(*it);
+				}
+				--depth;
+				new_line();
+				append(']');
+			}
+		};
+
+		template <typename Buffer>
+		void write(const utils::property& prop, Buffer& out, const bool pretty) threadsafe noexcept
+		try
+		{
+			json_writer<Buffer>(out, pretty).write(prop);
+		}
+		catch (const infrastructure::Exception& ex)
+		{
+			logger::error("jsoncpp", "Failed to save json to string: {}", typeid(ex).name());
+		}
+		catch (const std::exception& ex)
+		{
+			logger::error("jsoncpp", "Failed to save json to string: {}", ex.what());
 		}
-		return root;
-	}
-	catch (const std::exception& ex)
-	{
-		logger::error("jsoncpp", "Failed to parse json: {}", ex.what());
-		return {};
 	}
 
-	Json::Value EXPORT load(const infrastructure::DataBuffer& content) threadsafe noexcept
+	utils::property EXPORT parse_json_to_property(const std::string& document) threadsafe noexcept
 	{
-		std::string document(content.begin(), content.end());
-		return load(document);
+		return parse(document.data(), document.size());
 	}
-	Json::Value EXPORT load(const infrastructure::DataStream& data) threadsafe noexcept
+	utils::property EXPORT parse_json_to_property(const infrastructure::DataBuffer& content) threadsafe noexcept
 	{
-		const infrastructure::DataBuffer& content = data.readall();
-		return load(content);
+		return parse(reinterpret_cast<const char*>(content.data()), content.size());
 	}
-	std::string save(const Json::Value& value) threadsafe noexcept
-	try
+	utils::property EXPORT parse_json_to_property(const char* data, const std::size_t size) threadsafe noexcept
 	{
-		Json::StreamWriterBuilder builder;
-		builder["indentation"] = "";
-		auto writer = std::unique_ptr<Json::StreamWriter>(builder.newStreamWriter());
-		std::stringstream out;
-		if (const auto res = writer->write(value, &out))
-		{
-			logger::error("jsoncpp", "Failed to save json to string: {}", res);
-		}
-		return out.str();
+		return parse(data, size);
 	}
-	catch (const std::exception& ex)
+	//the stream is read by chunks from the beginning and the position is restored, as readall() does
+	utils::property EXPORT parse_json_to_property(const infrastructure::DataStream& data) threadsafe noexcept
 	{
-		logger::error("jsoncpp", "Failed to save json to string: {}", ex.what());
-		return {};
-	}
+		infrastructure::DataStream& stream = const_cast<infrastructure::DataStream&>(data);
+		const std::size_t orig_pos = rewind(stream);
+		if (orig_pos == infrastructure::DataStream::error)
+			return parse_json_to_property(data.readall());
 
-	utils::property convert(const Json::Value& jroot) threadsafe noexcept
-	{
-		utils::property out;
-		switch (jroot.type())
+		infrastructure::DataBuffer chunk;
+		utils::property out = parse(json_parser([&stream, &chunk](const char*& begin, const char*& end) {
+			const std::size_t count = stream.read(chunk_size, chunk);
+			if (count == 0 or count == infrastructure::DataStream::error)
+				return false;
+			begin = reinterpret_cast<const char*>(chunk.data());
+			end = begin + count;
+			return true;
+		}));
+		try
 		{
-			case Json::nullValue:
-			break;
-			case Json::intValue:
-			case Json::uintValue:
-			case Json::realValue:
-				out = jroot.asDouble();
-			break;
-			case Json::stringValue:
-				out = jroot.asString();
-			break;
-			case Json::booleanValue:
-				out = jroot.asBool();
-			break;
-			case Json::objectValue:
-				for (const auto& member : jroot.getMemberNames())
-					out[member] = convert(jroot[member]);
-			break;
-			case Json::arrayValue:
-				for (Json::ArrayIndex index = 0; index < jroot.size(); ++index)
-					out[index] = convert(jroot[index]);
-			break;
-		};
-		return out;
-	}
-	Json::Value convert(const utils::property& root) threadsafe noexcept
-	{
-		Json::Value out;
-		if (root.is_none()) {
-		} else if (root.is_dictionary()) {
-			for (auto it = root.begin(); it != root.end(); ++it)
-				out[it.get_key().c_str()] = convert(*it);
-		} else if (root.is_array()) {
-			for (auto it = root.begin(); it != root.end(); ++it)
-				out[static_cast<Json::ArrayIndex>(it.get_index())] = convert(*it);
-		} else if (root.is_bool()) {
-			out = root.as_bool();
-		} else if (root.is_int()) {
-			out = root.as_int();
-		} else if (root.is_long()) {
-			out = static_cast<Json::Value::Int64>(root.as_long());
-		} else if (root.is_float()) {
-			out = root.as_float();
-		} else if (root.is_double()) {
-			out = root.as_double();
-		} else if (root.is_string()) {
-			out = root.as_string();
+			stream.seek(orig_pos, infrastructure::DataStream::Whence::begin);
 		}
+		catch (const infrastructure::Exception&)
+		{}
 		return out;
 	}
 
-	utils::property EXPORT parse_json_to_property(const std::string& document) threadsafe noexcept
-	{
-		Json::Value jroot = load(document);
-		return convert(jroot);
-	}
-	utils::property EXPORT parse_json_to_property(const infrastructure::DataBuffer& content) threadsafe noexcept
+	void EXPORT write(const utils::property& prop, std::string& out, const bool pretty) threadsafe noexcept
 	{
-		Json::Value jroot = load(content);
-		return convert(jroot);
+		write<std::string>(prop, out, pretty);
 	}
-	utils::property EXPORT parse_json_to_property(const infrastructure::DataStream& data) threadsafe noexcept
+	void EXPORT write(const utils::property& prop, infrastructure::DataBuffer& out, const bool pretty) threadsafe noexcept
 	{
-		Json::Value jroot = load(data);
-		return convert(jroot);
+		write<infrastructure::DataBuffer>(prop, out, pretty);
 	}
 
 	std::string EXPORT to_string(const utils::property& prop) threadsafe noexcept
 	{
-		Json::Value jroot = convert(prop);
-		return save(jroot);
+		std::string out;
+		write(prop, out, false);
+		return out;
 	}
 }
 }
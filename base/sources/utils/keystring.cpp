@@ -0,0 +1,63 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/defines.h>
+#include <pisk/utils/keystring.h>
+
+#include <unordered_map>
+#include <mutex>
+
+namespace pisk
+{
+namespace utils
+{
+namespace details
+{
+	namespace
+	{
+		//the table is split into shards by hash to keep the contention low
+		constexpr std::size_t shards_count = 64;
+
+		struct intern_shard
+		{
+			std::mutex guard;
+			std::unordered_multimap<std::size_t, const keystring_content*> contents;
+		};
+
+		intern_shard& get_shard(const std::size_t hash)
+		{
+			static intern_shard shards[shards_count];
+			return shards[hash % shards_count];
+		}
+	}
+
+	const keystring_content* EXPORT intern_keystring(const char* str, const std::size_t size, const std::size_t hash) threadsafe
+	{
+		if (size == 0)
+			return nullptr;
+
+		intern_shard& shard = get_shard(hash);
+		std::lock_guard<std::mutex> lock(shard.guard);
+
+		const auto& range = shard.contents.equal_range(hash);
+		for (auto iter = range.first; iter != range.second; ++iter)
+			if (iter->second->str.compare(0, std::string::npos, str, size) == 0)
+				return iter->second;
+
+		const keystring_content* content = new keystring_content(hash, true, std::string(str, size));
+		shard.contents.emplace(hash, content);
+		return content;
+	}
+}
+}
+}
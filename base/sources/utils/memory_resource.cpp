@@ -0,0 +1,23 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+
+#include <pisk/utils/memory_resource.h>
+
+namespace pisk
+{
+namespace utils
+{
+	constexpr std::size_t memory_resource::max_align;
+}
+}
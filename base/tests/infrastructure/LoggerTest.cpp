@@ -14,7 +14,10 @@
 #include <pisk/bdd.h>
 #include <pisk/infrastructure/Logger.h>
 
+#include <exception>
 #include <functional>
+#include <thread>
+#include <vector>
 
 using namespace igloo;
 
@@ -28,18 +31,25 @@ LogMessage lastmessage;
 
 using logger = pisk::infrastructure::Logger;
 
+std::size_t flushes = 0;
+std::size_t stored = 0;
+
 class TestLogStorage : public pisk::infrastructure::LogStorage {
 
 	virtual void store(const pisk::infrastructure::Logger::Level level, const std::string& tag, const std::string& message) noexcept override final {
 		lastmessage.level = level;
 		lastmessage.tag = tag;
 		lastmessage.message = message;
+		++stored;
 	}
 	virtual void store(const pisk::infrastructure::Logger::Level level, const std::string& tag, const std::vector<std::string>& messages) noexcept override final {
 		lastmessage.level = level;
 		lastmessage.tag = tag;
 		lastmessage.message = pisk::utils::algorithm::join(messages, std::string("\n"));
 	}
+	virtual void flush() noexcept override final {
+		++flushes;
+	}
 };
 
 Describe(infrastructure_logger) {
@@ -82,5 +92,94 @@ Describe(infrastructure_logger) {
 			}
 		};
 	};
+	Context(level_is_filtered) {
+		void SetUp() {
+			lastmessage = {};
+			logger::set_log_storage(std::make_unique<TestLogStorage>());
+			logger::set_log_level(pisk::infrastructure::Logger::Level::Information);
+		}
+		Then(printer_is_false) {
+			Assert::That(static_cast<bool>(logger::debug("lazy")), Is().EqualTo(false));
+			Assert::That(static_cast<bool>(logger::info("lazy")), Is().EqualTo(true));
+		}
+		Then(arguments_are_not_evaluated) {
+			bool evaluated = false;
+			auto argument = [&evaluated]() {
+				evaluated = true;
+				return std::string("expensive");
+			};
+			if (auto&& log = logger::debug("lazy"))
+				log.print("Value: {}", argument());
+			Assert::That(evaluated, Is().EqualTo(false));
+			Assert::That(lastmessage.tag, Is().EqualTo(""));
+		}
+		Then(printer_stores_message) {
+			if (auto&& log = logger::warning("lazy"))
+				log.print("Value: {}", 13);
+			Assert::That(lastmessage.tag, Is().EqualTo("lazy"));
+			Assert::That(lastmessage.message, Is().EqualTo("Value: 13"));
+		}
+		Then(short_form_stores_message) {
+			logger::error("lazy", "Value: {}", 7);
+			Assert::That(lastmessage.message, Is().EqualTo("Value: 7"));
+		}
+	};
+	Context(async_mode) {
+		void SetUp() {
+			lastmessage = {};
+			logger::set_log_storage(std::make_unique<TestLogStorage>());
+			logger::start_async(16, pisk::infrastructure::Logger::OverflowPolicy::Block);
+		}
+		void TearDown() {
+			logger::stop_async();
+		}
+		Then(flush_delivers_message) {
+			using namespace pisk::infrastructure;
+			logger::log(Logger::Level::Warning, "async", "testmessage");
+			logger::flush();
+			Assert::That(lastmessage.level, Is().EqualTo(Logger::Level::Warning));
+			Assert::That(lastmessage.tag, Is().EqualTo("async"));
+			Assert::That(lastmessage.message, Is().EqualTo("testmessage"));
+		}
+		Then(lines_are_kept_together) {
+			using namespace pisk::infrastructure;
+			logger::log()
+				.add_line("a")
+				.add_line("b")
+				.commit(Logger::Level::Information, "async");
+			logger::flush();
+			Assert::That(lastmessage.message, Is().EqualTo("a\nb"));
+		}
+		Then(blocking_keeps_every_message) {
+			using namespace pisk::infrastructure;
+			const std::size_t before = stored;
+			std::vector<std::thread> threads;
+			for (int thread = 0; thread < 4; ++thread)
+				threads.emplace_back([]() {
+					for (int index = 0; index < 1000; ++index)
+						logger::log(Logger::Level::Error, "async", std::to_string(index));
+				});
+			for (auto& thread : threads)
+				thread.join();
+			logger::log(Logger::Level::Error, "async", "last");
+			logger::stop_async();
+			Assert::That(stored - before, Is().EqualTo(4001U));
+			Assert::That(lastmessage.message, Is().EqualTo("last"));
+		}
+		Then(stop_returns_to_synchronous_mode) {
+			using namespace pisk::infrastructure;
+			logger::stop_async();
+			const std::size_t before = flushes;
+			logger::log(Logger::Level::Error, "sync", "testmessage");
+			Assert::That(lastmessage.tag, Is().EqualTo("sync"));
+			Assert::That(flushes, Is().EqualTo(before + 1));
+		}
+		Then(crash_handlers_are_opt_in) {
+			logger::stop_async();
+			const std::terminate_handler before = std::get_terminate();
+			logger::start_async();
+			Assert::That(std::get_terminate() == before, Is().EqualTo(true));
+		}
+	};
 };
 
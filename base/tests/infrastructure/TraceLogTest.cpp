@@ -0,0 +1,129 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+#include <pisk/infrastructure/TraceLog.h>
+#include <pisk/utils/keystring.h>
+
+#include <vector>
+
+using namespace igloo;
+using namespace pisk::infrastructure;
+
+class TestTraceStorage : public TraceStorage
+{
+	std::vector<char>& block;
+	TraceRing ring;
+
+public:
+	TestTraceStorage(std::vector<char>& block, const std::size_t records):
+		block(block),
+		ring((block.resize(TraceRing::block_size(records, 1024)), block.data()), records, 1024)
+	{}
+
+	virtual std::uint32_t intern(const char* text, const std::size_t size) noexcept override final
+	{
+		return ring.intern(text, size);
+	}
+
+	virtual void write(TraceRecord& record) noexcept override final
+	{
+		record.thread = 7;
+		ring.write(record);
+	}
+};
+
+static std::vector<TraceReader::Line> read_trace(const std::vector<char>& block)
+{
+	return TraceReader(block.data(), block.size()).read();
+}
+
+Describe(infrastructure_trace_log) {
+	std::vector<char> block;
+
+	void SetUp() {
+		block.clear();
+		Logger::set_log_level(Logger::Level::Information);
+		Logger::set_trace_level(Logger::Level::Debug);
+		Logger::set_trace_storage(std::make_unique<TestTraceStorage>(block, 8));
+	}
+	void TearDown() {
+		Logger::set_trace_storage(nullptr);
+	}
+
+	Then(debug_is_traced_while_filtered) {
+		Assert::That(static_cast<bool>(Logger::debug("trace")), Is().EqualTo(true));
+		Logger::debug("trace", "Value: {}", 13);
+		const auto& lines = read_trace(block);
+		Assert::That(lines.size(), Is().EqualTo(1u));
+		Assert::That(lines[0].level, Is().EqualTo(Logger::Level::Debug));
+		Assert::That(lines[0].tag, Is().EqualTo("trace"));
+		Assert::That(lines[0].thread, Is().EqualTo(7u));
+		Assert::That(lines[0].message, Is().EqualTo("Value: 13"));
+	}
+	Then(spam_is_not_traced) {
+		Assert::That(static_cast<bool>(Logger::spam("trace")), Is().EqualTo(false));
+		Logger::spam("trace", "Value: {}", 13);
+		Assert::That(read_trace(block).size(), Is().EqualTo(0u));
+	}
+	Then(arguments_are_decoded) {
+		const std::string text("text");
+		Logger::info("trace", "{} {} {:.2} {} {} {:x} {} {}", -5, 7u, 0.125, true, 'c', 255, text, pisk::utils::keystring("key"));
+		Logger::warning("trace", std::string("{}"), reinterpret_cast<const void*>(0x10));
+		const auto& lines = read_trace(block);
+		Assert::That(lines[0].message, Is().EqualTo("-5 7 0.12 true c ff text key"));
+		Assert::That(lines[1].message, Is().EqualTo("0x10"));
+	}
+	Then(long_arguments_are_truncated) {
+		const std::string text(200, 'a');
+		Logger::debug("trace", "{} {}", text, 1);
+		const auto& message = read_trace(block)[0].message;
+		Assert::That(message.size(), Is().LessThan(100u));
+		Assert::That(message.substr(message.size() - 3), Is().EqualTo(" {}"));
+	}
+	Then(oldest_records_are_overwritten) {
+		for (int index = 0; index < 20; ++index)
+			Logger::debug("trace", "{}", index);
+		const auto& lines = read_trace(block);
+		Assert::That(lines.size(), Is().EqualTo(8u));
+		Assert::That(lines.front().message, Is().EqualTo("12"));
+		Assert::That(lines.back().message, Is().EqualTo("19"));
+	}
+	Then(strings_are_interned_once) {
+		Logger::debug("trace", "same");
+		const std::vector<char> first(block);
+		Logger::debug("trace", "same");
+		const auto& header = *reinterpret_cast<const TraceHeader*>(block.data());
+		Assert::That(header.strings_size, Is().EqualTo(reinterpret_cast<const TraceHeader*>(first.data())->strings_size));
+		Assert::That(read_trace(block).size(), Is().EqualTo(2u));
+	}
+	Then(torn_record_is_skipped) {
+		Logger::debug("trace", "{}", 1);
+		Logger::debug("trace", "{}", 2);
+		const auto& header = *reinterpret_cast<const TraceHeader*>(block.data());
+		TraceRecord* records = reinterpret_cast<TraceRecord*>(block.data() + header.records_offset);
+		records[0].end_sequence += header.records;
+		const auto& lines = read_trace(block);
+		Assert::That(lines.size(), Is().EqualTo(1u));
+		Assert::That(lines[0].message, Is().EqualTo("2"));
+	}
+	Then(keystring_is_traced) {
+		const pisk::utils::keystring empty;
+		Logger::debug("trace", "{}|{}", pisk::utils::keystring("key"), empty);
+		Assert::That(read_trace(block)[0].message, Is().EqualTo("key|"));
+	}
+	Then(broken_block_throws) {
+		block[0] = 'X';
+		AssertThrowsEx(TraceFormatException, TraceReader(block.data(), block.size()));
+	}
+};
@@ -0,0 +1,117 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+#include <pisk/tools/FramePacer.h>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::tools;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using std::chrono::milliseconds;
+
+	const Clock::time_point start = Clock::time_point() + std::chrono::hours(1);
+}
+
+Describe(FramePacerTest) {
+	When(pacer_skips_overrun) {
+		FramePacer pacer {milliseconds(10), FrameOverrun::Skip, 4};
+
+		void SetUp() {
+			Assert::That(pacer.advance(start), Is().EqualTo(1u));
+		}
+		Then(first_frame_is_now) {
+			Assert::That(pacer.get_frame_time() == start, Is().EqualTo(true));
+		}
+		Then(early_tick_waits_for_the_next_slot) {
+			Assert::That(pacer.advance(start + milliseconds(3)), Is().EqualTo(1u));
+			Assert::That(pacer.get_frame_time() == start + milliseconds(10), Is().EqualTo(true));
+		}
+		Then(late_wakeups_do_not_drift) {
+			for (int frame = 1; frame <= 100; ++frame)
+			{
+				//every wakeup is 2ms late and the tick takes 5ms
+				pacer.advance(start + milliseconds(10 * frame - 10 + 7));
+				Assert::That(pacer.get_frame_time() == start + milliseconds(10 * frame), Is().EqualTo(true));
+			}
+		}
+		Then(missed_frames_are_skipped_in_phase) {
+			Assert::That(pacer.advance(start + milliseconds(35)), Is().EqualTo(1u));
+			Assert::That(pacer.get_frame_time() == start + milliseconds(30), Is().EqualTo(true));
+			Assert::That(pacer.advance(start + milliseconds(36)), Is().EqualTo(1u));
+			Assert::That(pacer.get_frame_time() == start + milliseconds(40), Is().EqualTo(true));
+		}
+	};
+	When(pacer_catches_up) {
+		FramePacer pacer {milliseconds(10), FrameOverrun::CatchUp, 4};
+
+		void SetUp() {
+			pacer.advance(start);
+		}
+		Then(missed_frames_are_updated) {
+			Assert::That(pacer.advance(start + milliseconds(35)), Is().EqualTo(3u));
+			Assert::That(pacer.get_frame_time() == start + milliseconds(30), Is().EqualTo(true));
+		}
+		Then(catch_up_is_limited) {
+			Assert::That(pacer.advance(start + milliseconds(1000)), Is().EqualTo(5u));
+			Assert::That(pacer.get_frame_time() == start + milliseconds(1000), Is().EqualTo(true));
+		}
+	};
+	When(pacer_waits) {
+		Then(frame_is_not_before_the_slot) {
+			FramePacer pacer {milliseconds(2), FrameOverrun::Skip, 0};
+			pacer.wait_next_frame();
+			for (int frame = 0; frame < 5; ++frame)
+			{
+				pacer.wait_next_frame();
+				Assert::That(Clock::now() >= pacer.get_frame_time(), Is().EqualTo(true));
+			}
+		}
+	};
+};
+
+Describe(TickStatisticsTest) {
+	TickStatistics statistics;
+
+	Then(empty_statistics_is_zero) {
+		Assert::That(statistics.get_count(), Is().EqualTo(0u));
+		Assert::That(statistics.get_min() == Clock::duration::zero(), Is().EqualTo(true));
+		Assert::That(statistics.get_average() == Clock::duration::zero(), Is().EqualTo(true));
+		Assert::That(statistics.get_percentile(99) == Clock::duration::zero(), Is().EqualTo(true));
+	}
+	When(ticks_are_measured) {
+		void SetUp() {
+			Clock::time_point now = start;
+			Root().statistics.tick(now);
+			for (int period = 1; period <= 100; ++period)
+			{
+				now += milliseconds(period);
+				Root().statistics.tick(now);
+			}
+		}
+		Then(count_is_of_periods) {
+			Assert::That(Root().statistics.get_count(), Is().EqualTo(100u));
+		}
+		Then(min_and_average_are_calculated) {
+			Assert::That(Root().statistics.get_min() == milliseconds(1), Is().EqualTo(true));
+			Assert::That(Root().statistics.get_average() == std::chrono::microseconds(50500), Is().EqualTo(true));
+		}
+		Then(percentile_is_calculated) {
+			Assert::That(Root().statistics.get_percentile(99) == milliseconds(99), Is().EqualTo(true));
+			Assert::That(Root().statistics.get_percentile(100) == milliseconds(100), Is().EqualTo(true));
+		}
+	};
+};
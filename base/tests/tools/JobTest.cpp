@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <thread>
 
 using namespace igloo;
 using namespace pisk::tools;
@@ -142,3 +143,239 @@ Describe(CyclicalScopedJobTest) {
 	}
 };
 
+Describe(PoolScopedJobTest) {
+	It(always_wait_for_job) {
+		ThreadPool pool(2);
+		std::atomic_int x(0);
+		{
+			ScopedJob job(pool, [&](const ScopedJob&) {
+				for (int i = 0; i < 10000; ++i)
+					++x;
+			});
+		}
+		Assert::That(static_cast<int>(x), Is().EqualTo(10000));
+	}
+	It(is_stopped_called_when_job_destroing) {
+		ThreadPool pool(2);
+		std::atomic_int x(0);
+		{
+			ScopedJob job(pool, [&x](const ScopedJob& job) {
+				while (job.not_stopped())
+					++x;
+			});
+			while (x == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		Assert::That(static_cast<int>(x), Is().GreaterThan(0));
+	}
+	It(job_destroyed_by_worker_does_not_deadlock) {
+		ThreadPool pool(1);
+		std::atomic_int x(0);
+		pool.submit([&]() {
+			ScopedJob job(pool, [&x](const ScopedJob&) {
+				++x;
+			});
+		}).get();
+		Assert::That(static_cast<int>(x), Is().EqualTo(1));
+	}
+	It(thrown_exception_if_argument_is_nullptr) {
+		ThreadPool pool(1);
+		AssertThrowsEx(
+			pisk::infrastructure::InvalidArgumentException,
+			ScopedJob(pool, nullptr)
+		);
+	}
+};
+
+Describe(PoolCyclicalScopedJobTest) {
+	It(iterations_share_one_worker_with_other_tasks) {
+		ThreadPool pool(1);
+		std::atomic_int x(0);
+		{
+			CyclicalScopedJob job(pool, [&](const CyclicalScopedJob&) {
+				++x;
+			});
+			Assert::That(pool.submit([]() {return true;}).get(), Is().EqualTo(true));
+			while (x < 2)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		Assert::That(static_cast<int>(x), Is().GreaterThan(1));
+	}
+	It(start_and_end_called_once) {
+		ThreadPool pool(2);
+		std::atomic_int started(0);
+		std::atomic_int ended(0);
+		{
+			CyclicalScopedJob job(pool,
+				[&](const CyclicalScopedJob&) {},
+				[&]() {
+					++ended;
+				},
+				[&]() {
+					++started;
+					return true;
+				}
+			);
+		}
+		Assert::That(static_cast<int>(started), Is().EqualTo(1));
+		Assert::That(static_cast<int>(ended), Is().EqualTo(1));
+	}
+	It(iteration_and_deinit_is_not_called_if_init_returns_false) {
+		ThreadPool pool(2);
+		std::atomic_int x(0);
+		{
+			CyclicalScopedJob job(pool,
+				[&](const CyclicalScopedJob&) {
+					x = x + 1;
+				},
+				[&]() {
+					x = x + 1;
+				},
+				[&]() {
+					x = x + 1;
+					return false;
+				}
+			);
+		}
+		Assert::That(static_cast<int>(x), Is().EqualTo(1));
+	}
+	It(thrown_exception_if_iteration_is_nullptr) {
+		ThreadPool pool(1);
+		AssertThrowsEx(
+			pisk::infrastructure::InvalidArgumentException,
+			CyclicalScopedJob(pool, nullptr)
+		);
+	}
+};
+
+Describe(CyclicalScopedJobSuspendTest) {
+	std::unique_ptr<ThreadPool> pool;
+	std::atomic_int iterations;
+	std::atomic_bool suspend_next;
+
+	void SetUp() {
+		iterations = 0;
+		suspend_next = true;
+	}
+
+	template <typename MakeJob>
+	void check_suspend_and_resume(MakeJob&& make_job) {
+		std::unique_ptr<CyclicalScopedJob> job = make_job([this](const CyclicalScopedJob& current) {
+			++iterations;
+			if (suspend_next)
+				current.suspend();
+		});
+		wait_iterations(1);
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		Assert::That(static_cast<int>(iterations), Is().EqualTo(1));
+
+		job->resume();
+		wait_iterations(2);
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		Assert::That(static_cast<int>(iterations), Is().EqualTo(2));
+
+		suspend_next = false;
+		job->resume();
+		wait_iterations(5);
+		job.reset();
+	}
+
+	void wait_iterations(const int count) {
+		for (int index = 0; index < 500 and iterations < count; ++index)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		Assert::That(static_cast<int>(iterations), Is().GreaterThan(count - 1));
+	}
+
+	It(suspended_job_on_thread_waits_for_resume) {
+		check_suspend_and_resume([](CyclicalScopedJob::JobIterationFn iteration) {
+			return std::make_unique<CyclicalScopedJob>(iteration);
+		});
+	}
+	It(suspended_job_on_pool_waits_for_resume) {
+		pool = std::make_unique<ThreadPool>(1);
+		check_suspend_and_resume([this](CyclicalScopedJob::JobIterationFn iteration) {
+			return std::make_unique<CyclicalScopedJob>(*pool, iteration);
+		});
+		pool.reset();
+	}
+	It(suspended_job_on_pool_holds_no_worker) {
+		pool = std::make_unique<ThreadPool>(1);
+		{
+			CyclicalScopedJob job(*pool, [](const CyclicalScopedJob& current) {
+				current.suspend();
+			});
+			Assert::That(pool->submit([]() {return true;}).get(), Is().EqualTo(true));
+		}
+		pool.reset();
+	}
+	It(suspended_job_is_stopped_by_destructor) {
+		std::atomic_int ended(0);
+		pool = std::make_unique<ThreadPool>(1);
+		{
+			CyclicalScopedJob job(*pool,
+				[this](const CyclicalScopedJob& current) {
+					++iterations;
+					current.suspend();
+				},
+				[&ended]() {
+					++ended;
+				}
+			);
+			wait_iterations(1);
+		}
+		pool.reset();
+		Assert::That(static_cast<int>(iterations), Is().EqualTo(1));
+		Assert::That(static_cast<int>(ended), Is().EqualTo(1));
+	}
+};
+
+
+Describe(CyclicalScopedJobDelayTest) {
+	std::unique_ptr<ThreadPool> pool;
+	std::atomic_int iterations;
+
+	void SetUp() {
+		iterations = 0;
+	}
+
+	template <typename MakeJob>
+	void check_delay(MakeJob&& make_job) {
+		const auto start = std::chrono::steady_clock::now();
+		std::unique_ptr<CyclicalScopedJob> job = make_job([this](const CyclicalScopedJob& current) {
+			++iterations;
+			current.delay(std::chrono::milliseconds(20));
+		});
+		while (iterations < 3)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		Assert::That(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(40), Is().EqualTo(true));
+		job.reset();
+	}
+
+	It(delayed_job_on_thread_waits_for_the_delay) {
+		check_delay([](CyclicalScopedJob::JobIterationFn iteration) {
+			return std::make_unique<CyclicalScopedJob>(iteration);
+		});
+	}
+	It(delayed_job_on_pool_waits_for_the_delay) {
+		pool = std::make_unique<ThreadPool>(1);
+		check_delay([this](CyclicalScopedJob::JobIterationFn iteration) {
+			return std::make_unique<CyclicalScopedJob>(*pool, iteration);
+		});
+		pool.reset();
+	}
+	It(delayed_job_on_pool_holds_no_worker) {
+		pool = std::make_unique<ThreadPool>(1);
+		{
+			CyclicalScopedJob job(*pool, [this](const CyclicalScopedJob& current) {
+				++iterations;
+				current.delay(std::chrono::milliseconds(300));
+			});
+			while (iterations < 1)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			const auto start = std::chrono::steady_clock::now();
+			Assert::That(pool->submit([]() {return true;}).get(), Is().EqualTo(true));
+			Assert::That(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200), Is().EqualTo(true));
+		}
+		pool.reset();
+	}
+};
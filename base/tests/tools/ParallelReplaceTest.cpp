@@ -0,0 +1,156 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+#include <pisk/tools/ParallelReplace.h>
+#include <pisk/utils/json_utils.h>
+#include <pisk/utils/memory_resource.h>
+
+#include <string>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::tools;
+
+namespace
+{
+	std::string object_id(const std::size_t index)
+	{
+		return "object_" + std::to_string(index);
+	}
+
+	//the objects share the presentation storage, as the copies of one resource do
+	utils::property make_scene(const std::size_t count)
+	{
+		utils::property presentation;
+		presentation["location"]["properties"]["position"]["x"] = 0.;
+		presentation["location"]["properties"]["position"]["y"] = 0.;
+		presentation.seal();
+
+		utils::property scene;
+		scene["properties"]["name"] = "scene";
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			utils::property& object = scene["children"][object_id(index)];
+			object["id"] = object_id(index);
+			object["presentations"] = presentation;
+			object["children"]["light"]["id"] = "light";
+		}
+		scene.seal();
+		return scene;
+	}
+
+	utils::property make_patch(const std::size_t count)
+	{
+		utils::property patch;
+		patch["properties"]["name"] = "patched";
+		utils::property& children = patch["children"];
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			const std::string& id = object_id(index);
+			switch (index % 5)
+			{
+				case 0: children[id]["presentations"]["location"]["properties"]["position"]["x"] = index * 0.5; break;
+				case 1: children[id] = utils::property::make_deletion(); break;
+				case 2: children[id]["children"]["light"] = utils::property::make_deletion(); break;
+				case 3: children[id]["presentations"] = utils::property::make_overwrite(static_cast<int>(index)); break;
+				default: break;
+			}
+		}
+		for (std::size_t index = count; index < count + count / 10; ++index)
+			children[object_id(index)]["id"] = object_id(index);
+		return patch;
+	}
+}
+
+Describe(ParallelReplaceTest) {
+	It(patch_result_is_same_as_sequential) {
+		ThreadPool pool(4);
+		const utils::property& scene = make_scene(2000);
+		const utils::property& patch = make_patch(2000);
+
+		utils::property expected = scene;
+		utils::property::apply_patch(expected, patch);
+
+		utils::property actual = scene;
+		apply_patch_parallel(actual, patch, pool, 16);
+
+		Assert::That(actual == expected, Is().EqualTo(true));
+		Assert::That(utils::json::to_string(actual), Is().EqualTo(utils::json::to_string(expected)));
+		Assert::That(actual["children"].size(), Is().EqualTo(2000U - 400U + 200U));
+		Assert::That(scene == make_scene(2000), Is().EqualTo(true));
+	}
+	It(replace_result_is_same_as_sequential) {
+		ThreadPool pool(4);
+		const utils::property& scene = make_scene(2000);
+		const utils::property& patch = make_patch(2000);
+
+		utils::property expected = scene;
+		utils::property::replace(expected, patch);
+
+		utils::property actual = scene;
+		replace_parallel(actual, patch, pool, 16);
+
+		Assert::That(actual == expected, Is().EqualTo(true));
+		Assert::That(actual["children"].size(), Is().EqualTo(2000U + 200U));
+	}
+	It(scene_without_children_takes_them_from_patch) {
+		ThreadPool pool(2);
+		const utils::property& patch = make_patch(100);
+
+		utils::property expected;
+		expected["properties"]["name"] = "scene";
+		utils::property actual = expected;
+		utils::property::apply_patch(expected, patch);
+		apply_patch_parallel(actual, patch, pool, 16);
+
+		Assert::That(actual == expected, Is().EqualTo(true));
+	}
+	It(small_patch_is_merged_sequentially) {
+		ThreadPool pool(2);
+		const utils::property& scene = make_scene(100);
+		const utils::property& patch = make_patch(10);
+
+		utils::property expected = scene;
+		utils::property::apply_patch(expected, patch);
+		utils::property actual = scene;
+		apply_patch_parallel(actual, patch, pool);
+
+		Assert::That(actual == expected, Is().EqualTo(true));
+	}
+	It(arena_tree_is_merged_sequentially) {
+		ThreadPool pool(2);
+		utils::monotonic_resource arena;
+		const utils::property& patch = make_patch(100);
+
+		utils::property expected = make_scene(100);
+		utils::property actual(arena);
+		actual = expected;
+		utils::property::apply_patch(expected, patch);
+		apply_patch_parallel(actual, patch, pool, 16);
+
+		Assert::That(actual == expected, Is().EqualTo(true));
+	}
+	It(exception_is_rethrown_after_other_items) {
+		ThreadPool pool(2);
+		utils::property scene = make_scene(100);
+		utils::property patch;
+		for (std::size_t index = 0; index < 100; ++index)
+			patch["children"][object_id(index)]["id"] = 5;
+		patch["children"][object_id(99)]["id"] = "renamed";
+
+		AssertThrowsEx(utils::PropertyCastException, replace_parallel(scene, patch, pool, 16));
+		Assert::That(scene["children"][object_id(99)]["id"].get_or(""), Is().EqualTo("renamed"));
+	}
+};
+
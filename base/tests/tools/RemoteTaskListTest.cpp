@@ -14,9 +14,11 @@
 #include <pisk/bdd.h>
 #include <pisk/tools/RemoteTaskList.h>
 
+#include <stdexcept>
 #include <atomic>
 #include <chrono>
 #include <future>
+#include <thread>
 
 using namespace igloo;
 using namespace pisk::tools;
@@ -212,3 +214,64 @@ Describe(RemoteTaskExecutorTest) {
 		Assert::That(Root().exec_id, Is().EqualTo(1U));
 	}
 };
+
+Describe(RemoteTaskExecutorBatchTest) {
+	RemoteTaskExecutor executor;
+	std::vector<int> executed;
+	void SetUp() {
+		executor.init();
+	}
+	void TearDown() {
+		executor.deinit();
+	}
+
+	It(post_executes_in_order) {
+		for (int index = 0; index < 3; ++index)
+			executor.post_remote_task([this, index]() {
+				Root().executed.push_back(index);
+			});
+		executor.execute_remote_tasks();
+		Assert::That(executed, Is().EqualToContainer(std::vector<int> {0, 1, 2}));
+	}
+	It(task_pushed_by_task_waits_for_next_call) {
+		executor.post_remote_task([this]() {
+			Root().executed.push_back(1);
+			Root().executor.post_remote_task([this]() {
+				Root().executed.push_back(2);
+			});
+		});
+		executor.execute_remote_tasks();
+		Assert::That(executed, Is().EqualToContainer(std::vector<int> {1}));
+		executor.execute_remote_tasks();
+		Assert::That(executed, Is().EqualToContainer(std::vector<int> {1, 2}));
+	}
+	It(budget_leaves_the_rest_for_next_call) {
+		for (int index = 0; index < 3; ++index)
+			executor.post_remote_task([this, index]() {
+				Root().executed.push_back(index);
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			});
+		Assert::That(executor.execute_remote_tasks(std::chrono::milliseconds(1)), Is().EqualTo(false));
+		Assert::That(executed, Is().EqualToContainer(std::vector<int> {0}));
+		executor.post_remote_task([this]() {
+			Root().executed.push_back(3);
+		});
+		Assert::That(executor.execute_remote_tasks(std::chrono::seconds(10)), Is().EqualTo(true));
+		Assert::That(executed, Is().EqualToContainer(std::vector<int> {0, 1, 2, 3}));
+	}
+	It(throwing_task_keeps_the_rest) {
+		executor.post_remote_task([]() {
+			throw std::runtime_error("task");
+		});
+		executor.post_remote_task([this]() {
+			Root().executed.push_back(1);
+		});
+		AssertThrowsEx(std::runtime_error, executor.execute_remote_tasks());
+		executor.execute_remote_tasks();
+		Assert::That(executed, Is().EqualToContainer(std::vector<int> {1}));
+	}
+	It(post_without_init_throws) {
+		RemoteTaskExecutor other;
+		AssertThrowsEx(pisk::infrastructure::InitializeError, other.post_remote_task([]() {}));
+	}
+};
@@ -0,0 +1,196 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+#include <pisk/infrastructure/Exception.h>
+#include <pisk/tools/ThreadPool.h>
+#include <pisk/utils/sync_flag.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+using namespace igloo;
+using namespace pisk::tools;
+
+Describe(ThreadPoolTest) {
+	It(throws_on_zero_threads) {
+		AssertThrowsEx(
+			pisk::infrastructure::InvalidArgumentException,
+			ThreadPool(0)
+		);
+	}
+	It(throws_on_empty_task) {
+		ThreadPool pool(1);
+		AssertThrowsEx(
+			pisk::infrastructure::NullPointerException,
+			pool.post(nullptr)
+		);
+	}
+	It(shared_pool_is_sized_to_hardware) {
+		Assert::That(ThreadPool::shared().threads_count(), Is().EqualTo(ThreadPool::default_threads_count()));
+		Assert::That(ThreadPool::default_threads_count(), Is().GreaterThan(0U));
+	}
+	It(submit_returns_result) {
+		ThreadPool pool(2);
+		auto result = pool.submit([]() {
+			return 42;
+		});
+		Assert::That(result.get(), Is().EqualTo(42));
+	}
+	It(submit_passes_exception_to_future) {
+		ThreadPool pool(2);
+		auto result = pool.submit([]() -> int {
+			throw pisk::infrastructure::LogicErrorException();
+		});
+		AssertThrowsEx(pisk::infrastructure::LogicErrorException, result.get());
+	}
+	It(failed_task_does_not_stop_worker) {
+		ThreadPool pool(1);
+		pool.post([]() {
+			throw pisk::infrastructure::LogicErrorException();
+		});
+		Assert::That(pool.submit([]() {return true;}).get(), Is().EqualTo(true));
+	}
+	It(destructor_runs_queued_tasks) {
+		std::atomic_int count(0);
+		{
+			ThreadPool pool(2);
+			for (int index = 0; index < 1000; ++index)
+				pool.post([&count]() {
+					++count;
+				});
+		}
+		Assert::That(static_cast<int>(count), Is().EqualTo(1000));
+	}
+	It(is_worker_thread_only_inside_pool) {
+		ThreadPool pool(2);
+		Assert::That(pool.is_worker_thread(), Is().EqualTo(false));
+		Assert::That(pool.submit([&pool]() {return pool.is_worker_thread();}).get(), Is().EqualTo(true));
+		Assert::That(ThreadPool::shared().submit([&pool]() {return pool.is_worker_thread();}).get(), Is().EqualTo(false));
+	}
+	It(run_pending_task_is_false_outside_pool) {
+		ThreadPool pool(1);
+		Assert::That(pool.run_pending_task(), Is().EqualTo(false));
+	}
+	It(higher_priority_runs_first) {
+		ThreadPool pool(1);
+		pisk::utils::sync::flag release;
+		pool.post([&release]() {
+			release.wait();
+		});
+		std::mutex guard;
+		std::vector<ThreadPool::Priority> order;
+		for (const auto priority : {ThreadPool::Priority::Low, ThreadPool::Priority::Normal, ThreadPool::Priority::High})
+			pool.post([&guard, &order, priority]() {
+				std::unique_lock<std::mutex> lock(guard);
+				order.push_back(priority);
+			}, priority);
+		release.set();
+		pool.submit([]() {}, ThreadPool::Priority::Low).wait();
+
+		std::unique_lock<std::mutex> lock(guard);
+		Assert::That(order.size(), Is().EqualTo(3U));
+		Assert::That(order[0] == ThreadPool::Priority::High, Is().EqualTo(true));
+		Assert::That(order[1] == ThreadPool::Priority::Normal, Is().EqualTo(true));
+		Assert::That(order[2] == ThreadPool::Priority::Low, Is().EqualTo(true));
+	}
+	It(idle_worker_steals_from_busy_one) {
+		ThreadPool pool(2);
+		pisk::utils::sync::flag release;
+		std::promise<void> stolen;
+		//the tasks posted from the worker go to its own queue, the second worker has to steal
+		pool.post([&]() {
+			pool.post([&stolen]() {
+				stolen.set_value();
+			});
+			release.wait();
+		});
+		const auto status = stolen.get_future().wait_for(std::chrono::seconds(5));
+		release.set();
+		Assert::That(status == std::future_status::ready, Is().EqualTo(true));
+	}
+	It(nested_tasks_complete_on_one_thread) {
+		ThreadPool pool(1);
+		auto outer = pool.submit([&pool]() {
+			auto inner = pool.submit([]() {
+				return 7;
+			});
+			//a waiting worker helps instead of deadlock
+			while (inner.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				pool.run_pending_task();
+			return inner.get() + 1;
+		});
+		Assert::That(outer.get(), Is().EqualTo(8));
+	}
+	It(tasks_from_many_threads_are_executed) {
+		std::atomic_int count(0);
+		{
+			ThreadPool pool(3);
+			std::vector<std::thread> producers;
+			for (int thread = 0; thread < 4; ++thread)
+				producers.emplace_back([&pool, &count]() {
+					for (int index = 0; index < 5000; ++index)
+						pool.post([&count]() {
+							++count;
+						}, static_cast<ThreadPool::Priority>(index % 3));
+				});
+			for (auto& producer : producers)
+				producer.join();
+		}
+		Assert::That(static_cast<int>(count), Is().EqualTo(20000));
+	}
+	It(delayed_task_waits_for_delay) {
+		ThreadPool pool(2);
+		std::promise<ThreadPool::Clock::time_point> called;
+		const auto posted = ThreadPool::Clock::now();
+		pool.post_after(std::chrono::milliseconds(50), [&called]() {
+			called.set_value(ThreadPool::Clock::now());
+		});
+		const auto elapsed = called.get_future().get() - posted;
+		Assert::That(elapsed >= std::chrono::milliseconds(50), Is().EqualTo(true));
+	}
+	It(delayed_tasks_run_in_due_order) {
+		ThreadPool pool(1);
+		std::mutex guard;
+		std::vector<int> order;
+		std::promise<void> done;
+		pool.post_after(std::chrono::milliseconds(60), [&]() {
+			std::unique_lock<std::mutex> lock(guard);
+			order.push_back(2);
+			done.set_value();
+		});
+		pool.post_after(std::chrono::milliseconds(20), [&]() {
+			std::unique_lock<std::mutex> lock(guard);
+			order.push_back(1);
+		});
+		done.get_future().wait();
+
+		std::unique_lock<std::mutex> lock(guard);
+		Assert::That(order, Is().EqualTo(std::vector<int>{1, 2}));
+	}
+	It(not_due_tasks_are_dropped_with_pool) {
+		std::atomic_int count(0);
+		{
+			ThreadPool pool(1);
+			pool.post_after(std::chrono::hours(1), [&count]() {
+				++count;
+			});
+		}
+		Assert::That(static_cast<int>(count), Is().EqualTo(0));
+	}
+};
+
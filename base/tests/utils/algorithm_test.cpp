@@ -289,5 +289,54 @@ Describe(format_test) {
 			Assert::That(result, Is().EqualTo("simple {42}"));
 		}
 	};
+	When(with_spec) {
+		Then(width_pads_numbers_on_the_left) {
+			Assert::That(string::format("[{:5}]", 42), Is().EqualTo("[   42]"));
+			Assert::That(string::format("[{:<5}]", 42), Is().EqualTo("[42   ]"));
+		}
+		Then(width_pads_text_on_the_right) {
+			Assert::That(string::format("[{:5}]", "ab"), Is().EqualTo("[ab   ]"));
+			Assert::That(string::format("[{:>5}]", std::string("ab")), Is().EqualTo("[   ab]"));
+			Assert::That(string::format("[{:>5}]", keystring("ab")), Is().EqualTo("[   ab]"));
+		}
+		Then(zeros_follow_the_sign) {
+			Assert::That(string::format("{:05}", -42), Is().EqualTo("-0042"));
+		}
+		Then(hex_is_written) {
+			Assert::That(string::format("{:x} {:X} {:04x}", 255, 255u, 10), Is().EqualTo("ff FF 000a"));
+		}
+		Then(precision_is_applied) {
+			Assert::That(string::format("{:.2} {:8.3}", 3.14159, 2.5), Is().EqualTo("3.14    2.500"));
+			Assert::That(string::format("{:.2}", "abc"), Is().EqualTo("ab"));
+		}
+		Then(pointer_is_hex) {
+			Assert::That(string::format("{}", reinterpret_cast<const void*>(0x1f)), Is().EqualTo("0x1f"));
+		}
+		Then(bool_is_text) {
+			Assert::That(string::format("{} {}", true, false), Is().EqualTo("true false"));
+		}
+		Then(bad_spec_is_kept) {
+			Assert::That(string::format("{:q} {}", 1), Is().EqualTo("{:q} 1"));
+		}
+		Then(spec_without_args_is_kept) {
+			Assert::That(string::format("{:x}"), Is().EqualTo("{:x}"));
+		}
+	};
+	When(long_result) {
+		Then(it_is_complete) {
+			const std::string long_arg(1000, 'a');
+			const std::string& result = string::format("{}|{}|{}", long_arg, 1e300, long_arg);
+			Assert::That(result.size(), Is().EqualTo(2002u + std::to_string(1e300).size()));
+			Assert::That(result.substr(1000, 3), Is().EqualTo("|10"));
+		}
+	};
+	When(format_to) {
+		Then(result_is_appended) {
+			std::string out("> ");
+			string::format_to(out, "{} {}", 1, "x");
+			string::format_to(out, std::string(" {}"), 2);
+			Assert::That(out, Is().EqualTo("> 1 x 2"));
+		}
+	};
 };
 
@@ -0,0 +1,108 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+#include <pisk/utils/binary_property.h>
+#include <pisk/utils/json_utils.h>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::utils;
+using namespace pisk::utils::binary;
+
+static property round_trip(const property& prop)
+{
+	const infrastructure::DataBuffer& buffer = to_binary(prop);
+	return parse_binary_to_property(buffer);
+}
+
+Context(binary_round_trip) {
+	When(pass_scalars) {
+		Then(same_scalars_return) {
+			Assert::That(round_trip(property {}), Is().EqualTo(property {}));
+			Assert::That(round_trip(property {true}), Is().EqualTo(property {true}));
+			Assert::That(round_trip(property {-7}), Is().EqualTo(property {-7}));
+			Assert::That(round_trip(property {-80000L}), Is().EqualTo(property {-80000L}));
+			Assert::That(round_trip(property {41.1f}), Is().EqualTo(property {41.1f}));
+			Assert::That(round_trip(property {42.2}), Is().EqualTo(property {42.2}));
+			Assert::That(round_trip(property {"qwe"}), Is().EqualTo(property {"qwe"}));
+			Assert::That(round_trip(property {""}), Is().EqualTo(property {""}));
+		}
+	};
+	When(pass_tree) {
+		property tree;
+		void SetUp() {
+			tree["children"]["obj_1"]["properties"]["position"]["x"] = 1.;
+			tree["children"]["obj_1"]["properties"]["name"] = "obj_1";
+			tree["children"]["obj_2"]["properties"]["position"]["x"] = 2.;
+			tree["children"]["obj_2"]["tags"][std::size_t(0)] = "visible";
+			tree["children"]["obj_2"]["tags"][std::size_t(2)] = 3;
+			tree["empty"]["array"] = property::array {};
+			tree["empty"]["dictionary"] = property::dictionary {};
+		}
+		Then(same_tree_returns) {
+			Assert::That(round_trip(tree), Is().EqualTo(tree));
+		}
+		Then(repeated_strings_are_stored_once) {
+			property twice;
+			twice["a"]["properties"] = "properties";
+			twice["b"]["properties"] = "properties";
+			property different;
+			different["a"]["properties"] = "properties";
+			different["b"]["properties"] = "propertiez";
+			Assert::That(to_binary(twice).size(), Is().LessThan(to_binary(different).size()));
+		}
+		Then(same_as_json_returns) {
+			const property& from_json = json::parse_json_to_property(json::to_string(tree));
+			Assert::That(round_trip(from_json), Is().EqualTo(from_json));
+		}
+	};
+};
+
+Context(binary_detection) {
+	Then(binary_is_recognised) {
+		const infrastructure::DataBuffer& buffer = to_binary(property {1});
+		Assert::That(is_binary_property(buffer.data(), buffer.size()), Is().EqualTo(true));
+		Assert::That(is_binary_property(buffer.data(), header_size), Is().EqualTo(true));
+	}
+	Then(json_is_not_recognised) {
+		const std::string& json = json::to_string(property {"some long enough string to fill the header"});
+		Assert::That(is_binary_property(json.data(), json.size()), Is().EqualTo(false));
+	}
+	Then(short_data_is_not_recognised) {
+		const infrastructure::DataBuffer& buffer = to_binary(property {1});
+		Assert::That(is_binary_property(buffer.data(), header_size - 1), Is().EqualTo(false));
+	}
+};
+
+Context(binary_damaged) {
+	infrastructure::DataBuffer buffer;
+	void SetUp() {
+		property tree;
+		tree["a"]["b"][std::size_t(1)] = "c";
+		buffer = to_binary(tree);
+	}
+	Then(truncated_data_returns_none) {
+		buffer.resize(buffer.size() - 4);
+		Assert::That(parse_binary_to_property(buffer).is_none(), Is().EqualTo(true));
+	}
+	Then(wrong_offset_returns_none) {
+		buffer[header_size - 4] = 0xff;
+		buffer[header_size - 3] = 0xff;
+		Assert::That(parse_binary_to_property(buffer).is_none(), Is().EqualTo(true));
+	}
+	Then(wrong_tag_returns_none) {
+		buffer[header_size - 8] = 0x7f;
+		Assert::That(parse_binary_to_property(buffer).is_none(), Is().EqualTo(true));
+	}
+};
@@ -0,0 +1,108 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+
+#include <pisk/utils/flat_array.h>
+
+#include <vector>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::utils;
+
+Describe(test_flat_array) {
+	flat_array<int> array;
+
+	It(empty_by_default) {
+		Assert::That(Root().array.empty(), Is().EqualTo(true));
+		Assert::That(Root().array.begin() == Root().array.end(), Is().EqualTo(true));
+	}
+	When(push_values) {
+		void SetUp() {
+			for (int i = 0; i < 100; ++i)
+				Root().array.push_back(i);
+		}
+		Then(size_is_100) {
+			Assert::That(Root().array.size(), Is().EqualTo(100U));
+			Assert::That(Root().array.extent(), Is().EqualTo(100U));
+		}
+		Then(access_by_index) {
+			Assert::That(Root().array[42], Is().EqualTo(42));
+		}
+		Then(iteration_provides_indexes) {
+			for (auto iter = Root().array.begin(); iter != Root().array.end(); ++iter)
+				Assert::That(*iter, Is().EqualTo(static_cast<int>(iter.index())));
+		}
+		Then(references_are_stable) {
+			int& value = Root().array[50];
+			Root().array.resize(1000);
+			Assert::That(&value, Is().EqualTo(&Root().array[50]));
+		}
+		When(erase_value) {
+			void SetUp() {
+				Root().array.erase(10);
+			}
+			Then(next_values_are_shifted) {
+				Assert::That(Root().array.size(), Is().EqualTo(99U));
+				Assert::That(Root().array[10], Is().EqualTo(11));
+			}
+			Then(erased_slot_is_reused) {
+				const int* last = &Root().array[Root().array.extent() - 1];
+				Root().array.pop_back();
+				Root().array.reserve(Root().array.size() + 1);
+				Root().array.push_back(-1);
+				Assert::That(&Root().array[Root().array.extent() - 1], Is().EqualTo(last));
+			}
+		};
+		When(reset_value) {
+			void SetUp() {
+				Root().array.reset(10);
+			}
+			Then(hole_is_left) {
+				Assert::That(Root().array.size(), Is().EqualTo(99U));
+				Assert::That(Root().array.extent(), Is().EqualTo(100U));
+				Assert::That(Root().array.contains(10), Is().EqualTo(false));
+				Assert::That(Root().array[11], Is().EqualTo(11));
+			}
+		};
+	};
+	When(sparse_initialized) {
+		flat_array<int> sparse {{1U, 10}, {4U, 40}};
+		Then(holes_are_not_counted) {
+			Assert::That(sparse.size(), Is().EqualTo(2U));
+			Assert::That(sparse.extent(), Is().EqualTo(5U));
+		}
+		Then(holes_are_not_contained) {
+			Assert::That(sparse.contains(0), Is().EqualTo(false));
+			Assert::That(sparse.contains(1), Is().EqualTo(true));
+			Assert::That(sparse.get(2) == nullptr, Is().EqualTo(true));
+		}
+		Then(iteration_skips_holes) {
+			std::vector<std::size_t> indexes;
+			for (auto iter = sparse.begin(); iter != sparse.end(); ++iter)
+				indexes.push_back(iter.index());
+			Assert::That(indexes, Is().EqualTo(std::vector<std::size_t>{1, 4}));
+		}
+		Then(at_fills_hole) {
+			sparse.at(2) = 20;
+			Assert::That(sparse.size(), Is().EqualTo(3U));
+			Assert::That(sparse.contains(2), Is().EqualTo(true));
+		}
+		Then(copy_keeps_holes) {
+			const flat_array<int> copy(sparse);
+			Assert::That(copy == sparse, Is().EqualTo(true));
+			Assert::That(copy.contains(3), Is().EqualTo(false));
+		}
+	};
+};
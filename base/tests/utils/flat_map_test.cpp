@@ -0,0 +1,177 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+
+#include <pisk/utils/flat_map.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::utils;
+
+struct collided_hash
+{
+	std::size_t operator()(const std::string& key) const
+	{
+		return key.size();
+	}
+};
+
+Describe(test_flat_map) {
+	flat_map<std::string, int> map;
+
+	It(empty_by_default) {
+		Assert::That(Root().map.empty(), Is().EqualTo(true));
+		Assert::That(Root().map.size(), Is().EqualTo(0U));
+		Assert::That(Root().map.begin() == Root().map.end(), Is().EqualTo(true));
+	}
+	It(find_returns_end) {
+		Assert::That(Root().map.find("key") == Root().map.end(), Is().EqualTo(true));
+	}
+	When(insert_values) {
+		void SetUp() {
+			for (int i = 0; i < 100; ++i)
+				Root().map[std::to_string(i)] = i;
+		}
+		Then(size_is_100) {
+			Assert::That(Root().map.size(), Is().EqualTo(100U));
+		}
+		Then(each_value_is_found) {
+			for (int i = 0; i < 100; ++i)
+				Assert::That(Root().map.find(std::to_string(i))->second, Is().EqualTo(i));
+		}
+		Then(iteration_follows_insertion_order) {
+			std::vector<int> values;
+			for (const auto& item : Root().map)
+				values.push_back(item.second);
+			Assert::That(values.size(), Is().EqualTo(100U));
+			Assert::That(std::is_sorted(values.begin(), values.end()), Is().EqualTo(true));
+		}
+		Then(copy_keeps_order) {
+			const flat_map<std::string, int> copy(Root().map);
+			Assert::That(std::equal(copy.begin(), copy.end(), Root().map.begin()), Is().EqualTo(true));
+		}
+		Then(references_are_stable) {
+			int& value = Root().map["50"];
+			for (int i = 100; i < 1000; ++i)
+				Root().map[std::to_string(i)] = i;
+			Assert::That(&value, Is().EqualTo(&Root().map["50"]));
+			Assert::That(value, Is().EqualTo(50));
+		}
+		Then(copy_is_equal) {
+			const flat_map<std::string, int> copy(Root().map);
+			Assert::That(copy == Root().map, Is().EqualTo(true));
+			Assert::That(copy.find("7")->second, Is().EqualTo(7));
+		}
+		When(erase_value) {
+			void SetUp() {
+				Assert::That(Root().map.erase("7"), Is().EqualTo(1U));
+			}
+			Then(size_is_99) {
+				Assert::That(Root().map.size(), Is().EqualTo(99U));
+			}
+			Then(value_is_not_found) {
+				Assert::That(Root().map.count("7"), Is().EqualTo(0U));
+			}
+			Then(erase_again_returns_0) {
+				Assert::That(Root().map.erase("7"), Is().EqualTo(0U));
+			}
+			Then(other_values_are_found) {
+				for (int i = 0; i < 100; ++i)
+					if (i != 7)
+						Assert::That(Root().map.find(std::to_string(i))->second, Is().EqualTo(i));
+			}
+			Then(order_is_kept) {
+				auto iter = Root().map.begin();
+				for (int i = 0; i < 7; ++i)
+					++iter;
+				Assert::That(iter->second, Is().EqualTo(8));
+			}
+		};
+	};
+	When(emplace_existed_key) {
+		void SetUp() {
+			Root().map.emplace("key", 1);
+		}
+		Then(value_is_not_replaced) {
+			const auto& result = Root().map.emplace("key", 2);
+			Assert::That(result.second, Is().EqualTo(false));
+			Assert::That(result.first->second, Is().EqualTo(1));
+		}
+	};
+	It(equality_does_not_depend_on_insertion_order) {
+		const flat_map<std::string, int> map1 {{"a", 1}, {"b", 2}};
+		const flat_map<std::string, int> map2 {{"b", 2}, {"a", 1}};
+		const flat_map<std::string, int> map3 {{"b", 2}, {"a", 3}};
+		Assert::That(map1 == map2, Is().EqualTo(true));
+		Assert::That(map1 != map3, Is().EqualTo(true));
+	}
+	It(keys_with_same_hash_are_different) {
+		flat_map<std::string, int, collided_hash> collided;
+		collided["ab"] = 1;
+		collided["cd"] = 2;
+		collided["ef"] = 3;
+		Assert::That(collided.size(), Is().EqualTo(3U));
+		Assert::That(collided["ab"], Is().EqualTo(1));
+		Assert::That(collided["cd"], Is().EqualTo(2));
+		Assert::That(collided["ef"], Is().EqualTo(3));
+	}
+	It(many_keys_with_same_hash_are_different) {
+		flat_map<std::string, int, collided_hash> collided;
+		for (int i = 0; i < 100; ++i)
+			collided[std::to_string(i)] = i;
+		for (int i = 0; i < 100; i += 3)
+			collided.erase(std::to_string(i));
+		for (int i = 0; i < 100; ++i)
+			Assert::That(collided.count(std::to_string(i)), Is().EqualTo(i % 3 == 0 ? 0U : 1U));
+		Assert::That(collided.find("50")->second, Is().EqualTo(50));
+	}
+	It(bulk_erase_keeps_order_and_lookup) {
+		flat_map<std::string, int> map;
+		for (int i = 0; i < 1000; ++i)
+			map[std::to_string(i)] = i;
+		for (auto it = map.begin(); it != map.end(); )
+			if (it->second % 4 == 0)
+				++it;
+			else
+				it = map.erase(it);
+		Assert::That(map.size(), Is().EqualTo(250U));
+		int expected = 0;
+		for (const auto& item : map)
+		{
+			Assert::That(item.second, Is().EqualTo(expected));
+			expected += 4;
+		}
+		for (int i = 0; i < 1000; ++i)
+			Assert::That(map.count(std::to_string(i)), Is().EqualTo(i % 4 == 0 ? 1U : 0U));
+		map["new"] = -1;
+		Assert::That((--map.end())->second, Is().EqualTo(-1));
+		Assert::That(map.find("996")->second, Is().EqualTo(996));
+	}
+	It(erase_all_and_insert_again) {
+		flat_map<std::string, int> map;
+		for (int i = 0; i < 100; ++i)
+			map[std::to_string(i)] = i;
+		for (int i = 0; i < 100; ++i)
+			map.erase(std::to_string(i));
+		Assert::That(map.empty(), Is().EqualTo(true));
+		Assert::That(map.begin() == map.end(), Is().EqualTo(true));
+		map["a"] = 1;
+		Assert::That(map.size(), Is().EqualTo(1U));
+		Assert::That(map.begin()->second, Is().EqualTo(1));
+	}
+};
@@ -0,0 +1,291 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+#include <pisk/utils/json_utils.h>
+
+#include <limits>
+#include <cmath>
+#include <vector>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::utils;
+using namespace pisk::utils::json;
+
+class OneByteDataStream :
+	public infrastructure::DataStream
+{
+	const std::string content;
+	std::size_t pos = 0;
+
+public:
+	explicit OneByteDataStream(const std::string& content):
+		content(content)
+	{}
+
+	virtual std::size_t tell() const final override
+	{
+		return pos;
+	}
+	virtual std::size_t seek(const long offset, const Whence) final override
+	{
+		pos = static_cast<std::size_t>(offset);
+		return pos;
+	}
+	virtual std::size_t read(const std::size_t, infrastructure::DataBuffer& out) final override
+	{
+		out.clear();
+		if (pos < content.size())
+			out.push_back(content[pos++]);
+		return out.size();
+	}
+	virtual infrastructure::DataBuffer readall() const final override
+	{
+		return {content.begin(), content.end()};
+	}
+};
+
+Context(parse_json_numbers) {
+	Then(integer_is_double) {
+		Assert::That(parse_json_to_property("7"), Is().EqualTo(property {7.}));
+		Assert::That(parse_json_to_property("-7"), Is().EqualTo(property {-7.}));
+	}
+	Then(negative_zero_integer_is_zero) {
+		Assert::That(std::signbit(parse_json_to_property("-0").as_double()), Is().EqualTo(false));
+		Assert::That(std::signbit(parse_json_to_property("-0.0").as_double()), Is().EqualTo(true));
+	}
+	Then(big_integer_is_double) {
+		Assert::That(parse_json_to_property("18446744073709551615"), Is().EqualTo(property {18446744073709551615.}));
+		Assert::That(parse_json_to_property("184467440737095516150"), Is().EqualTo(property {184467440737095516150.}));
+	}
+	Then(fraction_and_exponent_are_parsed) {
+		Assert::That(parse_json_to_property("0.1"), Is().EqualTo(property {0.1}));
+		Assert::That(parse_json_to_property("-1.5E-3"), Is().EqualTo(property {-1.5E-3}));
+		Assert::That(parse_json_to_property("2e+2"), Is().EqualTo(property {200.}));
+	}
+	Then(overflow_is_error) {
+		Assert::That(parse_json_to_property("1e400").is_none(), Is().EqualTo(true));
+	}
+};
+
+Context(parse_json_strings) {
+	Then(escapes_are_decoded) {
+		Assert::That(parse_json_to_property(R"("a\"\\\/\b\f\n\r\t")"), Is().EqualTo(property {"a\"\\/\b\f\n\r\t"}));
+	}
+	Then(unicode_is_utf8) {
+		Assert::That(parse_json_to_property(R"("\u0041\u00e9\u20ac")"), Is().EqualTo(property {"A\xC3\xA9\xE2\x82\xAC"}));
+	}
+	Then(surrogate_pair_is_one_code_point) {
+		Assert::That(parse_json_to_property(R"("\ud83d\ude00")"), Is().EqualTo(property {"\xF0\x9F\x98\x80"}));
+	}
+	Then(bad_escape_is_error) {
+		Assert::That(parse_json_to_property(R"("\q")").is_none(), Is().EqualTo(true));
+		Assert::That(parse_json_to_property(R"("\u00g0")").is_none(), Is().EqualTo(true));
+	}
+};
+
+Context(parse_json_containers) {
+	Then(empty_containers_are_none) {
+		Assert::That(parse_json_to_property("{}").is_none(), Is().EqualTo(true));
+		Assert::That(parse_json_to_property("[]").is_none(), Is().EqualTo(true));
+		Assert::That(parse_json_to_property(R"({"a":{}})")["a"].is_none(), Is().EqualTo(true));
+	}
+	Then(null_member_exists) {
+		Assert::That(parse_json_to_property(R"({"a":null})").contains("a"), Is().EqualTo(true));
+	}
+	Then(last_duplicated_key_wins) {
+		const property& out = parse_json_to_property(R"({"a":{"x":1},"a":{"y":2}})");
+		Assert::That(out["a"].contains("x"), Is().EqualTo(false));
+		Assert::That(out["a"]["y"].as_double(), Is().EqualTo(2.));
+	}
+	Then(comments_and_trailing_commas_are_allowed) {
+		const property& out = parse_json_to_property("// head\n{\"a\": /* value */ [1, 2,], \"b\": true,}");
+		Assert::That(out["a"].size(), Is().EqualTo(2U));
+		Assert::That(out["b"].as_bool(), Is().EqualTo(true));
+	}
+	Then(text_after_root_is_ignored) {
+		Assert::That(parse_json_to_property(R"({"a":1} tail)")["a"].as_double(), Is().EqualTo(1.));
+	}
+	Then(broken_document_gives_parsed_part) {
+		const property& out = parse_json_to_property(R"({"a":1,"b":[2,)");
+		Assert::That(out["a"].as_double(), Is().EqualTo(1.));
+		Assert::That(out["b"][std::size_t(0)].as_double(), Is().EqualTo(2.));
+	}
+	Then(too_deep_document_is_none) {
+		const std::string deep = std::string(2000, '[') + std::string(2000, ']');
+		Assert::That(parse_json_to_property(deep).is_none(), Is().EqualTo(true));
+	}
+};
+
+Context(parse_json_stream) {
+	std::string document = "\xEF\xBB\xBF{\"a\\u00e9\": [1.5, \"long string\\n\", true, null], /* c */ \"b\": {\"c\": -12}}";
+
+	Then(chunked_stream_gives_same_tree) {
+		OneByteDataStream stream(document);
+		const property& out = parse_json_to_property(static_cast<const infrastructure::DataStream&>(stream));
+		Assert::That(out, Is().EqualTo(parse_json_to_property(document)));
+		Assert::That(out["a\xC3\xA9"][std::size_t(1)].as_string(), Is().EqualTo("long string\n"));
+		Assert::That(out["b"]["c"].as_double(), Is().EqualTo(-12.));
+	}
+	Then(stream_position_is_restored) {
+		OneByteDataStream stream(document);
+		stream.seek(5, infrastructure::DataStream::Whence::begin);
+		parse_json_to_property(static_cast<const infrastructure::DataStream&>(stream));
+		Assert::That(stream.tell(), Is().EqualTo(5U));
+	}
+};
+
+Context(lazy_property_view) {
+	std::string document = R"(// scene
+	{
+		"properties": {"name": "level \"1\"", "size": 2.5, "visible": true, "parent": null},
+		"objects": [
+			{"model": "box", "overrides": {"position": [1, 2, 3]}},
+			{"model": "ball", "tags": ["a]", "{b"], /* [comment] */},
+		],
+		"empty": {},
+		"key\u00e9": 1,
+		"dup": 1,
+		"dup": 2,
+	} tail)";
+
+	Then(types_are_detected) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		Assert::That(root.is_dictionary(), Is().EqualTo(true));
+		Assert::That(root["objects"].is_array(), Is().EqualTo(true));
+		Assert::That(root["properties"]["name"].is_string(), Is().EqualTo(true));
+		Assert::That(root["properties"]["size"].is_double(), Is().EqualTo(true));
+		Assert::That(root["properties"]["visible"].is_bool(), Is().EqualTo(true));
+		Assert::That(root["properties"]["parent"].is_none(), Is().EqualTo(true));
+		Assert::That(root["empty"].is_none(), Is().EqualTo(true));
+		Assert::That(root["absent"].is_none(), Is().EqualTo(true));
+	}
+	Then(values_are_parsed_on_demand) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		Assert::That(root["properties"]["name"].as_string(), Is().EqualTo("level \"1\""));
+		Assert::That(root["properties"]["size"].as_double(), Is().EqualTo(2.5));
+		Assert::That(root["objects"][std::size_t(1)]["tags"][std::size_t(0)].as_string(), Is().EqualTo("a]"));
+		Assert::That(root["objects"][std::size_t(2)].is_none(), Is().EqualTo(true));
+	}
+	Then(get_or_returns_fallback_on_mismatch) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		Assert::That(root["properties"]["name"].get_or("noname"), Is().EqualTo("level \"1\""));
+		Assert::That(root["properties"]["size"].get_or(0.), Is().EqualTo(2.5));
+		Assert::That(root["properties"]["visible"].get_or(false), Is().EqualTo(true));
+		Assert::That(root["properties"]["size"].get_or("noname"), Is().EqualTo("noname"));
+		Assert::That(root["absent"].get_or(keystring("noname")), Is().EqualTo(keystring("noname")));
+		Assert::That(root["objects"].get_or(1.), Is().EqualTo(1.));
+	}
+	Then(contains_finds_null_members) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		Assert::That(root["properties"].contains("parent"), Is().EqualTo(true));
+		Assert::That(root["properties"].contains("absent"), Is().EqualTo(false));
+	}
+	Then(escaped_key_is_decoded) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		Assert::That(root["key\xC3\xA9"].as_double(), Is().EqualTo(1.));
+	}
+	Then(last_duplicated_key_wins) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		Assert::That(root["dup"].as_double(), Is().EqualTo(2.));
+	}
+	Then(iteration_visits_members_in_order) {
+		const lazy_property& objects = parse_json_to_lazy_property(document)["objects"];
+		std::vector<std::string> models;
+		for (auto it = objects.begin(); it != objects.end(); ++it)
+			models.push_back(std::to_string(it.get_index()) + (*it)["model"].as_string());
+		Assert::That(models, Is().EqualTo(std::vector<std::string> {"0box", "1ball"}));
+		Assert::That(objects.size(), Is().EqualTo(2U));
+	}
+	Then(iteration_gives_keys) {
+		const lazy_property& properties = parse_json_to_lazy_property(document)["properties"];
+		std::vector<std::string> keys;
+		for (auto it = properties.begin(); it != properties.end(); ++it)
+			keys.push_back(it.get_key().get_content());
+		Assert::That(keys, Is().EqualTo(std::vector<std::string> {"name", "size", "visible", "parent"}));
+	}
+	Then(materialized_subtree_equals_eager_one) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		const property& eager = parse_json_to_property(document);
+		Assert::That(root["objects"].materialize(), Is().EqualTo(eager["objects"]));
+		Assert::That(root["properties"].materialize(), Is().EqualTo(eager["properties"]));
+		Assert::That(root.materialize(), Is().EqualTo(eager));
+	}
+	Then(scalar_is_not_iteratable) {
+		const lazy_property& root = parse_json_to_lazy_property(document);
+		AssertThrows(PropertyCastException, root["dup"].begin());
+		AssertThrows(PropertyCastException, root["dup"]["key"]);
+	}
+	Then(broken_structure_is_none) {
+		Assert::That(parse_json_to_lazy_property(R"({"a": [1, 2})").is_none(), Is().EqualTo(true));
+		Assert::That(parse_json_to_lazy_property(R"({"a": "1})").is_none(), Is().EqualTo(true));
+		Assert::That(parse_json_to_lazy_property(std::string(2000, '[') + std::string(2000, ']')).is_none(), Is().EqualTo(true));
+	}
+	Then(scalar_root_is_supported) {
+		Assert::That(parse_json_to_lazy_property(" 42 ").as_double(), Is().EqualTo(42.));
+		Assert::That(parse_json_to_lazy_property("").is_none(), Is().EqualTo(true));
+	}
+};
+
+Context(write_json) {
+	Then(keys_are_sorted) {
+		property prop;
+		prop["b"] = true;
+		prop["a"] = 1;
+		prop["c"] = "x";
+		Assert::That(to_string(prop), Is().EqualTo(R"({"a":1,"b":true,"c":"x"})"));
+	}
+	Then(empty_values_are_null) {
+		Assert::That(to_string(property {}), Is().EqualTo("null"));
+		Assert::That(to_string(property {property::dictionary {}}), Is().EqualTo("null"));
+		Assert::That(to_string(property {property::array {}}), Is().EqualTo("null"));
+	}
+	Then(holes_are_null) {
+		property prop;
+		prop[std::size_t(2)] = 3;
+		Assert::That(to_string(prop), Is().EqualTo("[null,null,3]"));
+	}
+	Then(numbers_are_written_as_jsoncpp_did) {
+		Assert::That(to_string(property {-7}), Is().EqualTo("-7"));
+		Assert::That(to_string(property {-80000000000L}), Is().EqualTo("-80000000000"));
+		Assert::That(to_string(property {2.}), Is().EqualTo("2.0"));
+		Assert::That(to_string(property {-0.}), Is().EqualTo("-0.0"));
+		Assert::That(to_string(property {0.1}), Is().EqualTo("0.10000000000000001"));
+		Assert::That(to_string(property {1e300}), Is().EqualTo("1.0000000000000001e+300"));
+		Assert::That(to_string(property {41.1f}), Is().EqualTo("41.099998474121094"));
+		Assert::That(to_string(property {std::numeric_limits<double>::infinity()}), Is().EqualTo("1e+9999"));
+	}
+	Then(strings_are_escaped) {
+		Assert::That(to_string(property {"a\"\\/\b\f\n\r\t\x01"}), Is().EqualTo(R"("a\"\\/\b\f\n\r\t\u0001")"));
+		Assert::That(to_string(property {"\xC3\xA9\xF0\x9F\x98\x80"}), Is().EqualTo(R"("\u00e9\ud83d\ude00")"));
+		Assert::That(to_string(property {"\xFF"}), Is().EqualTo(R"("\ufffd")"));
+	}
+	Then(text_is_appended_to_buffer) {
+		std::string buffer = "prefix ";
+		write(property {1}, buffer);
+		Assert::That(buffer, Is().EqualTo("prefix 1"));
+		infrastructure::DataBuffer data;
+		write(property {"s"}, data);
+		Assert::That(std::string(data.begin(), data.end()), Is().EqualTo(R"("s")"));
+	}
+	Then(pretty_text_is_indented) {
+		property prop;
+		prop["a"]["b"] = 1;
+		prop["c"][std::size_t(0)] = true;
+		std::string buffer;
+		write(prop, buffer, true);
+		Assert::That(buffer, Is().EqualTo("{\n\t\"a\": {\n\t\t\"b\": 1\n\t},\n\t\"c\": [\n\t\ttrue\n\t]\n}"));
+		Assert::That(parse_json_to_property(buffer), Is().EqualTo(parse_json_to_property(to_string(prop))));
+	}
+};
@@ -15,9 +15,12 @@
 #include <pisk/utils/keystring.h>
 
 #include <functional>
+#include <thread>
+#include <vector>
 #include <set>
 
 using namespace igloo;
+using namespace pisk;
 using namespace pisk::utils;
 
 Describe(keystring_test) {
@@ -328,6 +331,60 @@ Describe(keystring_test) {
 		};
 	};
 
+	Describe(interned) {
+		It(literal_hash_is_same_as_runtime_hash) {
+			constexpr keystring_literal literal = "children"_ks;
+			Assert::That(literal.hash, Is().EqualTo(keystring("children").get_hash()));
+			Assert::That(keystring(literal).get_hash(), Is().EqualTo(keystring("children").get_hash()));
+		}
+		It(literal_is_interned) {
+			const keystring _1 = "children"_ks;
+			const keystring _2("children");
+			Assert::That(_1.is_interned(), Is().EqualTo(true));
+			Assert::That(_2.is_interned(), Is().EqualTo(false));
+			Assert::That(_2.intern().is_interned(), Is().EqualTo(true));
+		}
+		It(same_strings_share_content) {
+			const keystring _1 = "qwe"_ks;
+			const keystring _2 = keystring::intern("qwe");
+			Assert::That(_1.c_str() == _2.c_str(), Is().EqualTo(true));
+		}
+		It(compares_with_regular_keystring) {
+			const keystring _1 = "qwe"_ks;
+			const keystring _2("qwe");
+			const keystring _3 = "asd"_ks;
+			Assert::That(_1 == _2, Is().EqualTo(true));
+			Assert::That(_2 == _1, Is().EqualTo(true));
+			Assert::That(_1 == _3, Is().EqualTo(false));
+			Assert::That(_2 == "qwe"_ks, Is().EqualTo(true));
+			Assert::That(_2 == "asd"_ks, Is().EqualTo(false));
+		}
+		It(empty_literal_is_empty) {
+			const keystring _1 = ""_ks;
+			Assert::That(_1.empty(), Is().EqualTo(true));
+			Assert::That(_1, Is().EqualTo(keystring()));
+		}
+		It(interned_from_many_threads_is_same) {
+			std::vector<std::thread> threads;
+			std::vector<const char*> pointers(8);
+			for (std::size_t index = 0; index < pointers.size(); ++index)
+				threads.emplace_back([index, &pointers]() {
+					pointers[index] = keystring::intern("concurrent").c_str();
+				});
+			for (auto& thread : threads)
+				thread.join();
+			for (const char* ptr : pointers)
+				Assert::That(ptr == pointers[0], Is().EqualTo(true));
+		}
+	};
+	It(less_is_strict_weak_order) {
+		const keystring _1("qwe");
+		const keystring _2("asd");
+		Assert::That(_1 < _2 or _2 < _1, Is().EqualTo(true));
+		Assert::That(_1 < _1, Is().EqualTo(false));
+		Assert::That(_1 < keystring::intern("qwe"), Is().EqualTo(false));
+	}
+
 	Describe(compatibility_with_std_algorithm) {
 		It(can_copy_empty_string) {
 			const keystring _1;
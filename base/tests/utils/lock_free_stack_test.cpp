@@ -15,6 +15,9 @@
 #include <pisk/utils/lock_free_stack.h>
 
 #include <functional>
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include <set>
 
 using namespace igloo;
@@ -60,3 +63,73 @@ Describe(lock_free_stack_int) {
 	};
 };
 
+
+Describe(lock_free_stack_free_nodes) {
+	It(are_kept_up_to_the_bound) {
+		lock_free_stack<int> ints {2};
+		for (int index = 0; index < 5; ++index)
+			ints.push(index);
+		ints.clear();
+		Assert::That(ints.free_nodes_count(), Is().EqualTo(2u));
+	}
+	It(are_reused_by_push) {
+		lock_free_stack<int> ints {4};
+		ints.push(1);
+		ints.push(2);
+		ints.clear();
+		ints.push(3);
+		Assert::That(ints.free_nodes_count(), Is().EqualTo(1u));
+	}
+	It(are_deleted_by_shrink) {
+		lock_free_stack<int> ints;
+		ints.push(1);
+		ints.clear();
+		ints.shrink();
+		Assert::That(ints.free_nodes_count(), Is().EqualTo(0u));
+	}
+	It(keep_values_destroyed) {
+		const auto item = std::make_shared<int>(1);
+		lock_free_stack<std::shared_ptr<int>> pointers;
+		pointers.push(item);
+		std::shared_ptr<int> out;
+		pointers.pop(out);
+		out.reset();
+		Assert::That(item.use_count(), Is().EqualTo(1));
+	}
+};
+
+Describe(lock_free_stack_many_threads) {
+	It(loose_and_duplicate_nothing) {
+		const int threads_count = 4;
+		const int count = 20000;
+		lock_free_stack<int> ints {8};
+		std::vector<std::vector<int>> popped(threads_count);
+		std::vector<std::thread> threads;
+		for (int thread = 0; thread < threads_count; ++thread)
+			threads.emplace_back([&ints, &popped, thread, count]() {
+				for (int index = 0; index < count; ++index)
+				{
+					ints.push(thread * count + index);
+					int value = 0;
+					if (ints.pop(value))
+						popped[thread].push_back(value);
+				}
+			});
+		for (auto& thread : threads)
+			thread.join();
+
+		std::vector<int> all;
+		for (const auto& values : popped)
+			all.insert(all.end(), values.begin(), values.end());
+		int value = 0;
+		while (ints.pop(value))
+			all.push_back(value);
+		std::sort(all.begin(), all.end());
+
+		std::vector<int> expected(threads_count * count);
+		for (std::size_t index = 0; index < expected.size(); ++index)
+			expected[index] = static_cast<int>(index);
+		Assert::That(all == expected, Is().EqualTo(true));
+		Assert::That(ints.free_nodes_count(), Is().LessThan(9u));
+	}
+};
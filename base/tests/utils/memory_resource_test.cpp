@@ -0,0 +1,148 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+
+#include <pisk/utils/memory_resource.h>
+#include <pisk/utils/property_tree.h>
+
+#include <cstdint>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::utils;
+
+class counting_resource :
+	public memory_resource
+{
+public:
+	std::size_t allocations = 0;
+	std::size_t deallocations = 0;
+	std::size_t bytes_in_use = 0;
+
+	virtual void* allocate(const std::size_t bytes, const std::size_t alignment) final override
+	{
+		++allocations;
+		bytes_in_use += bytes;
+		return new_delete_resource()->allocate(bytes, alignment);
+	}
+	virtual void deallocate(void* ptr, const std::size_t bytes, const std::size_t alignment) noexcept final override
+	{
+		++deallocations;
+		bytes_in_use -= bytes;
+		new_delete_resource()->deallocate(ptr, bytes, alignment);
+	}
+};
+
+static void fill_patch(property& patch)
+{
+	for (std::size_t i = 0; i < 100; ++i)
+	{
+		auto& position = patch["children"]["obj_" + std::to_string(i)]["properties"]["position"];
+		position["x"] = 1.;
+		position["y"] = 2.;
+		position["z"] = 3.;
+		patch["events"][i]["type"] = "moved";
+	}
+}
+
+Describe(test_monotonic_resource) {
+	counting_resource upstream;
+
+	It(allocations_are_aligned) {
+		monotonic_resource arena(64, &Root().upstream);
+		for (std::size_t alignment : {1, 2, 4, 8, 16})
+		{
+			arena.allocate(1, 1);
+			void* ptr = arena.allocate(3, alignment);
+			Assert::That(reinterpret_cast<std::uintptr_t>(ptr) % alignment, Is().EqualTo(0U));
+		}
+	}
+	It(takes_chunks_from_upstream) {
+		monotonic_resource arena(1024, &Root().upstream);
+		for (int i = 0; i < 100; ++i)
+			arena.allocate(16, 8);
+		Assert::That(Root().upstream.allocations, Is().EqualTo(2U));
+	}
+	It(large_allocation_is_served) {
+		monotonic_resource arena(64, &Root().upstream);
+		char* ptr = static_cast<char*>(arena.allocate(10000, 8));
+		ptr[9999] = 'x';
+		Assert::That(Root().upstream.allocations, Is().EqualTo(1U));
+	}
+	It(release_returns_all_to_upstream) {
+		monotonic_resource arena(64, &Root().upstream);
+		for (int i = 0; i < 100; ++i)
+			arena.allocate(32, 8);
+		arena.release();
+		Assert::That(Root().upstream.deallocations, Is().EqualTo(Root().upstream.allocations));
+		Assert::That(Root().upstream.bytes_in_use, Is().EqualTo(0U));
+	}
+};
+
+Describe(test_property_with_resource) {
+	counting_resource resource;
+
+	When(patch_built_from_resource) {
+		void SetUp() {
+			property patch(Root().resource);
+			fill_patch(patch);
+			allocations = Root().resource.allocations;
+			Assert::That(patch["children"].size(), Is().EqualTo(100U));
+		}
+		std::size_t allocations = 0;
+
+		Then(tree_is_allocated_from_resource) {
+			Assert::That(allocations, Is().GreaterThan(100U));
+		}
+		Then(all_memory_is_returned) {
+			Assert::That(Root().resource.bytes_in_use, Is().EqualTo(0U));
+			Assert::That(Root().resource.deallocations, Is().EqualTo(Root().resource.allocations));
+		}
+	};
+	When(patch_built_in_arena) {
+		counting_resource upstream;
+		monotonic_resource arena {4096, &upstream};
+		property patch {arena};
+
+		void SetUp() {
+			fill_patch(patch);
+		}
+		Then(arena_takes_few_chunks) {
+			Assert::That(upstream.allocations, Is().LessThan(20U));
+		}
+		Then(get_resource_returns_arena) {
+			Assert::That(&patch["children"]["obj_1"].get_resource(), Is().EqualTo(static_cast<memory_resource*>(&arena)));
+		}
+		Then(copy_uses_default_resource) {
+			const property copy = patch;
+			Assert::That(copy, Is().EqualTo(patch));
+			Assert::That(&copy["children"]["obj_1"].get_resource(), Is().EqualTo(new_delete_resource()));
+		}
+		Then(move_to_default_tree_copies) {
+			property scene;
+			scene["children"]["obj_1"] = std::move(patch["children"]["obj_1"]);
+			Assert::That(&scene["children"]["obj_1"].get_resource(), Is().EqualTo(new_delete_resource()));
+		}
+		Then(replace_by_moved_patch_keeps_scene_independent) {
+			property scene;
+			scene["children"]["obj_1"]["properties"]["position"]["x"] = 0.;
+			property::replace(scene, std::move(patch));
+			patch.clear();
+			arena.release();
+			Assert::That(scene["children"]["obj_1"]["properties"]["position"]["x"].as_double(), Is().EqualTo(1.));
+			Assert::That(scene["children"]["obj_99"]["properties"]["position"]["z"].as_double(), Is().EqualTo(3.));
+			Assert::That(&scene["children"]["obj_99"].get_resource(), Is().EqualTo(new_delete_resource()));
+		}
+	};
+};
@@ -0,0 +1,165 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+
+#include <pisk/utils/mpsc_queue.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace igloo;
+using namespace pisk;
+using namespace pisk::utils;
+
+template <typename Queue>
+static bool check_producers(Queue& queue, const int producers, const int count)
+{
+	std::vector<std::thread> threads;
+	for (int producer = 0; producer < producers; ++producer)
+		threads.emplace_back([&queue, producer, count]() {
+			for (int index = 0; index < count; ++index)
+				while (not queue.push(producer * count + index))
+					std::this_thread::yield();
+		});
+
+	//every producer's items come in the order of pushing
+	std::vector<int> last(producers, -1);
+	int received = 0;
+	bool ordered = true;
+	while (received != producers * count)
+	{
+		int value = 0;
+		if (not queue.wait_pop(value, std::chrono::milliseconds(10)))
+			continue;
+		const int producer = value / count;
+		ordered = ordered and value % count == last[producer] + 1;
+		last[producer] = value % count;
+		++received;
+	}
+	for (auto& thread : threads)
+		thread.join();
+	return ordered and queue.empty();
+}
+
+//the unbounded queue has no failing push, the helper above expects one
+template <typename Data>
+struct unbounded : mpsc_queue<Data>
+{
+	bool push(const Data& data)
+	{
+		mpsc_queue<Data>::push(data);
+		return true;
+	}
+};
+
+Describe(test_mpsc_queue) {
+	mpsc_queue<int> queue;
+
+	It(empty_by_default) {
+		int value = -1;
+		Assert::That(queue.empty(), Is().EqualTo(true));
+		Assert::That(queue.pop(value), Is().EqualTo(false));
+		Assert::That(value, Is().EqualTo(-1));
+	}
+	It(fifo) {
+		queue.push(1);
+		queue.push(2);
+		int value = 0;
+		Assert::That(queue.pop(value), Is().EqualTo(true));
+		Assert::That(value, Is().EqualTo(1));
+		Assert::That(queue.pop(value), Is().EqualTo(true));
+		Assert::That(value, Is().EqualTo(2));
+		Assert::That(queue.empty(), Is().EqualTo(true));
+	}
+	It(pop_all_appends) {
+		std::vector<int> out {0};
+		queue.push(1);
+		queue.push(2);
+		Assert::That(queue.pop_all(out), Is().EqualTo(2u));
+		Assert::That(out, Is().EqualToContainer(std::vector<int> {0, 1, 2}));
+		Assert::That(queue.pop_all(out), Is().EqualTo(0u));
+	}
+	It(move_only_items) {
+		mpsc_queue<std::unique_ptr<int>> pointers;
+		pointers.push(std::make_unique<int>(5));
+		pointers.push(std::make_unique<int>(6));
+		std::unique_ptr<int> value;
+		Assert::That(pointers.pop(value), Is().EqualTo(true));
+		Assert::That(*value, Is().EqualTo(5));
+	}
+	It(wait_pop_times_out) {
+		int value = -1;
+		Assert::That(queue.wait_pop(value, std::chrono::milliseconds(1)), Is().EqualTo(false));
+	}
+	It(wait_pop_is_woken_by_push) {
+		std::thread producer([this]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			queue.push(7);
+		});
+		int value = -1;
+		const bool popped = queue.wait_pop(value, std::chrono::seconds(10));
+		producer.join();
+		Assert::That(popped, Is().EqualTo(true));
+		Assert::That(value, Is().EqualTo(7));
+	}
+	It(wakeup_interrupts_wait) {
+		queue.wakeup();
+		Assert::That(queue.wait(std::chrono::seconds(10)), Is().EqualTo(false));
+	}
+	It(many_producers) {
+		unbounded<int> shared;
+		Assert::That(check_producers(shared, 4, 10000), Is().EqualTo(true));
+	}
+};
+
+Describe(test_bounded_mpsc_queue) {
+	bounded_mpsc_queue<int> queue {3};
+
+	It(capacity_is_rounded) {
+		Assert::That(queue.capacity(), Is().EqualTo(4u));
+	}
+	It(push_fails_when_full) {
+		for (int index = 0; index < 4; ++index)
+			Assert::That(queue.push(index), Is().EqualTo(true));
+		Assert::That(queue.push(4), Is().EqualTo(false));
+		int value = -1;
+		Assert::That(queue.pop(value), Is().EqualTo(true));
+		Assert::That(value, Is().EqualTo(0));
+		Assert::That(queue.push(4), Is().EqualTo(true));
+	}
+	It(pop_all_takes_ring_in_order) {
+		std::vector<int> out;
+		for (int lap = 0; lap < 3; ++lap)
+		{
+			queue.push(lap);
+			queue.push(lap + 10);
+			queue.pop_all(out);
+		}
+		Assert::That(out, Is().EqualToContainer(std::vector<int> {0, 10, 1, 11, 2, 12}));
+	}
+	It(items_are_destroyed) {
+		const auto item = std::make_shared<int>(1);
+		{
+			bounded_mpsc_queue<std::shared_ptr<int>> pointers {4};
+			pointers.push(item);
+			pointers.push(item);
+		}
+		Assert::That(item.use_count(), Is().EqualTo(1));
+	}
+	It(many_producers) {
+		bounded_mpsc_queue<int> shared {64};
+		Assert::That(check_producers(shared, 4, 10000), Is().EqualTo(true));
+	}
+};
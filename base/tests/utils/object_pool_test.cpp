@@ -0,0 +1,105 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+
+#include <pisk/utils/object_pool.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace igloo;
+using namespace pisk::utils;
+
+namespace
+{
+	struct counted
+	{
+		static std::atomic<int> alive;
+		std::string name;
+
+		explicit counted(std::string name):
+			name(std::move(name))
+		{
+			++alive;
+		}
+		~counted()
+		{
+			--alive;
+		}
+	};
+	std::atomic<int> counted::alive {0};
+}
+
+Describe(object_pool_test) {
+	It(make_constructs_object) {
+		object_pool<counted> pool;
+		auto object = pool.make("first");
+		Assert::That(object->name, Is().EqualTo("first"));
+		Assert::That(counted::alive.load(), Is().EqualTo(1));
+	}
+	It(release_destroys_object_and_keeps_block) {
+		object_pool<counted> pool;
+		pool.make("first");
+		Assert::That(counted::alive.load(), Is().EqualTo(0));
+		Assert::That(pool.size(), Is().EqualTo(1u));
+	}
+	It(block_is_reused) {
+		object_pool<counted> pool;
+		const counted* address = nullptr;
+		{
+			auto object = pool.make("first");
+			address = object.get();
+		}
+		auto object = pool.make("second");
+		Assert::That(object.get() == address, Is().EqualTo(true));
+		Assert::That(pool.size(), Is().EqualTo(0u));
+	}
+	It(blocks_are_kept_up_to_capacity) {
+		object_pool<counted> pool {2};
+		{
+			std::vector<object_pool<counted>::pointer> objects;
+			for (int index = 0; index < 5; ++index)
+				objects.push_back(pool.make("object"));
+		}
+		Assert::That(pool.size(), Is().EqualTo(2u));
+	}
+	It(objects_are_released_by_other_thread) {
+		object_pool<counted> pool {16};
+		const int count = 10000;
+		std::vector<object_pool<counted>::pointer> objects;
+		std::atomic<bool> done {false};
+		std::thread releaser([&objects, &done]() {
+			while (not done)
+				std::this_thread::yield();
+			objects.clear();
+		});
+		for (int index = 0; index < count; ++index)
+			objects.push_back(pool.make("object"));
+		done = true;
+		releaser.join();
+
+		std::vector<std::thread> threads;
+		for (int thread = 0; thread < 4; ++thread)
+			threads.emplace_back([&pool, count]() {
+				for (int index = 0; index < count; ++index)
+					pool.make("object");
+			});
+		for (auto& thread : threads)
+			thread.join();
+		Assert::That(counted::alive.load(), Is().EqualTo(0));
+		Assert::That(pool.size(), Is().LessThan(17u));
+	}
+};
@@ -16,12 +16,32 @@
 #include <pisk/utils/json_utils.h>
 
 #include <functional>
+#include <vector>
 
 using namespace igloo;
+using namespace pisk;
 using namespace pisk::utils;
 using namespace pisk::utils::json;
 
 Context(property_access) {
+	Context(access_by_literal) {
+		property _1;
+		void SetUp() {
+			_1["key"] = 1;
+			_1["key2"_ks] = 2;
+		}
+		Then(same_item_as_by_string) {
+			Assert::That(_1["key"_ks].as_int(), Is().EqualTo(1));
+			Assert::That(_1["key2"].as_int(), Is().EqualTo(2));
+			Assert::That(_1.size(), Is().EqualTo(2U));
+		}
+		Then(const_access_does_not_insert) {
+			const property& ref = _1;
+			Assert::That(ref["key3"_ks].is_none(), Is().EqualTo(true));
+			Assert::That(ref.contains("key2"_ks), Is().EqualTo(true));
+			Assert::That(ref.size(), Is().EqualTo(2U));
+		}
+	};
 	Context(const_none) {
 		property _0;
 		const property _1;
@@ -141,6 +161,118 @@ Context(property_access) {
 	};
 };
 
+Context(copy_on_write) {
+	property _1;
+	void SetUp() {
+		_1["a"]["x"] = 1;
+		_1["b"]["y"] = "str";
+		_1["c"][std::size_t(2)] = 2.;
+		_1.seal();
+	}
+	const property& cref(const property& prop) {
+		return prop;
+	}
+	Then(copy_shares_items) {
+		const property copy = _1;
+		Assert::That(&copy["a"]["x"], Is().EqualTo(&cref(_1)["a"]["x"]));
+		Assert::That(copy, Is().EqualTo(_1));
+	}
+	Then(change_of_copy_clones_touched_path_only) {
+		property copy = _1;
+		copy["a"]["x"] = 3;
+		Assert::That(_1["a"]["x"].as_int(), Is().EqualTo(1));
+		Assert::That(copy["a"]["x"].as_int(), Is().EqualTo(3));
+		Assert::That(&cref(copy)["b"]["y"], Is().EqualTo(&cref(_1)["b"]["y"]));
+		Assert::That(&cref(copy)["c"][2], Is().EqualTo(&cref(_1)["c"][2]));
+	}
+	Then(change_of_original_does_not_affect_copy) {
+		const property copy = _1;
+		_1["b"]["y"] = "new";
+		_1["c"].remove(2);
+		Assert::That(copy["b"]["y"].as_string(), Is().EqualTo("str"));
+		Assert::That(copy["c"][2].as_double(), Is().EqualTo(2.));
+		Assert::That(_1["c"].size(), Is().EqualTo(2U));
+	}
+	Then(mutable_reference_is_not_shared) {
+		property& item = _1["a"]["x"];
+		const property copy = _1;
+		item = 5;
+		Assert::That(copy["a"]["x"].as_int(), Is().EqualTo(1));
+		Assert::That(_1["a"]["x"].as_int(), Is().EqualTo(5));
+	}
+	Then(mutable_iteration_is_not_shared) {
+		property copy = _1;
+		for (auto& item : copy["a"])
+			item = 7;
+		Assert::That(_1["a"]["x"].as_int(), Is().EqualTo(1));
+		Assert::That(copy["a"]["x"].as_int(), Is().EqualTo(7));
+	}
+	Then(replace_by_copy_keeps_sharing) {
+		property scene;
+		scene["a"]["z"] = 0;
+		property::replace(scene, cref(_1));
+		Assert::That(&cref(scene)["b"]["y"], Is().EqualTo(&cref(_1)["b"]["y"]));
+		Assert::That(scene["a"]["x"].as_int(), Is().EqualTo(1));
+		Assert::That(scene["a"]["z"].as_int(), Is().EqualTo(0));
+	}
+	Then(replace_keeps_patched_tree_shareable) {
+		property patch;
+		patch["a"]["x"] = 2;
+		property::replace(_1, patch);
+		const property copy = _1;
+		Assert::That(&copy["a"]["x"], Is().EqualTo(&cref(_1)["a"]["x"]));
+		Assert::That(copy["a"]["x"].as_int(), Is().EqualTo(2));
+	}
+	Then(replace_keeps_markers_of_patched_tree) {
+		property patch;
+		patch["a"]["m"] = property::make_deletion();
+		property::replace(_1, patch);
+		property target;
+		property::apply_patch(target, cref(_1));
+		Assert::That(target["a"].contains("m"), Is().EqualTo(false));
+		Assert::That(target["a"]["x"].as_int(), Is().EqualTo(1));
+	}
+	Then(seal_shares_tree_after_mutable_access) {
+		_1["a"]["x"] = 2;
+		const property unsealed = _1;
+		Assert::That(&unsealed["a"]["x"] == &cref(_1)["a"]["x"], Is().EqualTo(false));
+		_1.seal();
+		const property copy = _1;
+		Assert::That(&copy["a"]["x"], Is().EqualTo(&cref(_1)["a"]["x"]));
+	}
+};
+
+Context(array_building) {
+	property _1;
+	Then(none_turns_into_array) {
+		_1.push_back(1);
+		Assert::That(_1.is_array(), Is().EqualTo(true));
+		Assert::That(_1[std::size_t(0)].as_int(), Is().EqualTo(1));
+	}
+	Then(reserve_keeps_references) {
+		_1.reserve(100);
+		property& first = _1.push_back(0);
+		for (int i = 1; i < 100; ++i)
+			_1.push_back(i);
+		Assert::That(&first, Is().EqualTo(&_1[std::size_t(0)]));
+		Assert::That(_1.size(), Is().EqualTo(100U));
+		Assert::That(_1[std::size_t(99)].as_int(), Is().EqualTo(99));
+	}
+	Then(append_goes_past_holes) {
+		_1 = property::array {std::make_pair(std::size_t(1), property("b"))};
+		const std::vector<property> items {property("c"), property("d")};
+		_1.append(items.begin(), items.end());
+		Assert::That(_1.size(), Is().EqualTo(3U));
+		Assert::That(_1.begin().get_index(), Is().EqualTo(1U));
+		Assert::That(_1[std::size_t(2)].as_string(), Is().EqualTo("c"));
+		Assert::That(_1[std::size_t(3)].as_string(), Is().EqualTo("d"));
+	}
+	Then(append_to_dictionary_throws) {
+		_1["a"] = 1;
+		AssertThrowsEx(PropertyCastException, _1.push_back(2));
+	}
+};
+
 Context(from_string_to_string) {
 	When(pass_none) {
 		Then(none_returns) {
@@ -18,6 +18,7 @@
 #include <functional>
 
 using namespace igloo;
+using namespace pisk;
 using namespace pisk::utils;
 using namespace pisk::utils::json;
 
@@ -130,6 +131,49 @@ Describe(property_tree) {
 		AssertThrowsEx(PropertyCastException, static_cast<int>(prop[1]));
 		prop[2] = "hehehe";
 	}
+	It(_try_as_returns_value_of_same_type_only) {
+		property prop(5);
+		Assert::That(prop.try_as<int>() != nullptr, Is().EqualTo(true));
+		Assert::That(*prop.try_as<int>(), Is().EqualTo(5));
+		Assert::That(prop.try_as<long>() == nullptr, Is().EqualTo(true));
+		Assert::That(prop.try_as<double>() == nullptr, Is().EqualTo(true));
+		Assert::That(prop.try_as<keystring>() == nullptr, Is().EqualTo(true));
+		Assert::That(property().try_as<bool>() == nullptr, Is().EqualTo(true));
+	}
+	It(_try_as_string_and_containers) {
+		property prop;
+		prop["name"] = "object_1";
+		prop["items"][std::size_t(0)] = 1.f;
+		Assert::That(*prop["name"].try_as<keystring>(), Is().EqualTo(keystring("object_1")));
+		Assert::That(prop.try_as<property::dictionary>()->size(), Is().EqualTo(2U));
+		Assert::That(prop["items"].try_as<property::array>()->size(), Is().EqualTo(1U));
+		Assert::That(prop["items"].try_as<property::dictionary>() == nullptr, Is().EqualTo(true));
+		Assert::That(prop["name"].try_as<property::array>() == nullptr, Is().EqualTo(true));
+	}
+	It(_get_or_returns_fallback_on_mismatch) {
+		property prop;
+		prop["bool"] = true;
+		prop["int"] = 15;
+		prop["long"] = 16L;
+		prop["float"] = 1.5f;
+		prop["double"] = 2.5;
+		prop["string"] = "text";
+		Assert::That(prop["bool"].get_or(false), Is().EqualTo(true));
+		Assert::That(prop["int"].get_or(0), Is().EqualTo(15));
+		Assert::That(prop["long"].get_or(0L), Is().EqualTo(16L));
+		Assert::That(prop["float"].get_or(0.f), Is().EqualTo(1.5f));
+		Assert::That(prop["double"].get_or(0.), Is().EqualTo(2.5));
+		Assert::That(prop["string"].get_or("none"), Is().EqualTo("text"));
+		Assert::That(prop["string"].get_or(keystring("none")), Is().EqualTo(keystring("text")));
+		Assert::That(prop["string"].get_or("none"_ks), Is().EqualTo(keystring("text")));
+
+		Assert::That(prop["int"].get_or(0L), Is().EqualTo(0L));
+		Assert::That(prop["int"].get_or(0.), Is().EqualTo(0.));
+		Assert::That(prop["double"].get_or(7), Is().EqualTo(7));
+		Assert::That(prop["int"].get_or(std::string("none")), Is().EqualTo("none"));
+		Assert::That(prop["missed"].get_or("none"_ks), Is().EqualTo(keystring("none")));
+		Assert::That(prop.get_or(false), Is().EqualTo(false));
+	}
 	It(_uses_as_property_tree) {
 		property prop(property::dictionary {});
 		prop["phys"]["speed"] = 23;
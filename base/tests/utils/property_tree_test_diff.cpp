@@ -0,0 +1,245 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+#include <pisk/utils/property_tree.h>
+#include <pisk/utils/json_utils.h>
+
+#include <vector>
+
+using namespace igloo;
+using namespace pisk::utils;
+using namespace pisk::utils::json;
+
+static property apply(property original, const property& patch)
+{
+	property::apply_patch(original, patch);
+	return original;
+}
+
+static property make_state()
+{
+	property state;
+	state["children"]["obj_1"]["properties"]["position"]["x"] = 1.;
+	state["children"]["obj_1"]["properties"]["position"]["y"] = 2.;
+	state["children"]["obj_1"]["properties"]["name"] = "obj_1";
+	state["children"]["obj_2"]["tags"][std::size_t(0)] = "visible";
+	state["children"]["obj_2"]["tags"][std::size_t(1)] = "solid";
+	state["children"]["obj_2"]["tags"][std::size_t(2)] = "red";
+	return state;
+}
+
+Describe(test_diff) {
+	Context(markers) {
+		Then(deletion_is_recognised) {
+			Assert::That(property::make_deletion().is_deletion(), Is().EqualTo(true));
+			Assert::That(property::make_deletion().is_overwrite(), Is().EqualTo(false));
+		}
+		Then(overwrite_is_recognised) {
+			Assert::That(property::make_overwrite(property(1)).is_overwrite(), Is().EqualTo(true));
+			Assert::That(property::make_overwrite(property(1)).is_deletion(), Is().EqualTo(false));
+		}
+		Then(markers_survive_json) {
+			const property& marker = parse_json_to_property(to_string(property::make_deletion()));
+			Assert::That(marker.is_deletion(), Is().EqualTo(true));
+		}
+		Then(apply_patch_erases_dictionary_item) {
+			property original = make_state();
+			property patch;
+			patch["children"]["obj_1"] = property::make_deletion();
+			property::apply_patch(original, patch);
+			Assert::That(original["children"].contains("obj_1"), Is().EqualTo(false));
+			Assert::That(original["children"].contains("obj_2"), Is().EqualTo(true));
+		}
+		Then(apply_patch_erases_array_tail) {
+			property original = make_state();
+			property patch;
+			patch["children"]["obj_2"]["tags"][std::size_t(1)] = property::make_deletion();
+			patch["children"]["obj_2"]["tags"][std::size_t(2)] = property::make_deletion();
+			property::apply_patch(original, std::move(patch));
+			Assert::That(original["children"]["obj_2"]["tags"].size(), Is().EqualTo(1u));
+			Assert::That(original["children"]["obj_2"]["tags"][std::size_t(0)].as_string(), Is().EqualTo("visible"));
+		}
+		Then(apply_patch_overwrites_other_type) {
+			property original = make_state();
+			property patch;
+			patch["children"]["obj_1"]["properties"]["position"] = property::make_overwrite(property("none"));
+			property::apply_patch(original, patch);
+			Assert::That(original["children"]["obj_1"]["properties"]["position"].as_string(), Is().EqualTo("none"));
+		}
+		Then(replace_merges_markers_as_data) {
+			property original = make_state();
+			property patch;
+			patch["children"]["obj_1"] = property::make_deletion();
+			property::replace(original, patch);
+			Assert::That(original["children"]["obj_1"]["$delete"].as_bool(), Is().EqualTo(true));
+			Assert::That(original["children"]["obj_1"]["properties"]["name"].as_string(), Is().EqualTo("obj_1"));
+		}
+		Then(replace_does_not_overwrite_by_marker) {
+			property original = make_state();
+			property patch;
+			patch["children"]["obj_2"]["tags"] = property::make_overwrite(property("none"));
+			AssertThrowsEx(PropertyCastException, property::replace(original, patch));
+		}
+		Then(replace_copies_markers_into_none) {
+			property original;
+			property::replace(original, property::make_deletion());
+			Assert::That(original.is_deletion(), Is().EqualTo(true));
+		}
+		Then(deletion_of_absent_item_is_ignored) {
+			property original = make_state();
+			property patch;
+			patch["children"]["obj_3"] = property::make_deletion();
+			property::apply_patch(original, patch);
+			Assert::That(original, Is().EqualTo(make_state()));
+		}
+		Then(delete_key_with_other_value_is_data) {
+			property data;
+			data["$delete"] = "text";
+			Assert::That(data.is_deletion(), Is().EqualTo(false));
+			property original;
+			original["item"] = make_state();
+			property patch;
+			patch["item"] = data;
+			property::apply_patch(original, patch);
+			Assert::That(original["item"]["$delete"].as_string(), Is().EqualTo("text"));
+		}
+		Then(sealed_tree_is_shared_by_none) {
+			property sealed = make_state();
+			sealed.seal();
+			property original;
+			property::apply_patch(original, sealed);
+			const property& shared = original;
+			const property& source = sealed;
+			Assert::That(&shared["children"]["obj_1"] == &source["children"]["obj_1"], Is().EqualTo(true));
+		}
+		Then(markers_of_sealed_patch_are_dropped_in_new_items) {
+			property original = make_state();
+			property patch;
+			patch["children"]["obj_3"]["name"] = "obj_3";
+			patch["children"]["obj_3"]["tags"] = property::make_deletion();
+			patch.seal();
+			property::apply_patch(original, patch);
+			Assert::That(original["children"]["obj_3"]["name"].as_string(), Is().EqualTo("obj_3"));
+			Assert::That(original["children"]["obj_3"].contains("tags"), Is().EqualTo(false));
+		}
+		Then(marker_added_to_copy_of_sealed_patch_is_found) {
+			property sealed;
+			sealed["obj_3"]["name"] = "obj_3";
+			sealed.seal();
+			property patch = sealed;
+			patch["obj_3"]["tags"] = property::make_deletion();
+			property original;
+			property::apply_patch(original, patch);
+			Assert::That(original["obj_3"].contains("tags"), Is().EqualTo(false));
+			property untouched;
+			property::apply_patch(untouched, sealed);
+			Assert::That(untouched["obj_3"]["name"].as_string(), Is().EqualTo("obj_3"));
+		}
+	};
+	Context(diff) {
+		property before = make_state();
+		property after = make_state();
+
+		Then(equal_trees_give_none) {
+			Assert::That(property::diff(before, after).is_none(), Is().EqualTo(true));
+		}
+		Then(shared_trees_give_none) {
+			const property copy = before;
+			Assert::That(property::diff(before, copy).is_none(), Is().EqualTo(true));
+		}
+		Then(only_changed_value_is_in_patch) {
+			after["children"]["obj_1"]["properties"]["position"]["x"] = 5.;
+			property expected;
+			expected["children"]["obj_1"]["properties"]["position"]["x"] = 5.;
+			Assert::That(property::diff(before, after), Is().EqualTo(expected));
+		}
+		Then(removed_item_is_marked) {
+			after["children"]["obj_1"]["properties"].remove(keystring("name"));
+			const property& patch = property::diff(before, after);
+			Assert::That(patch["children"]["obj_1"]["properties"]["name"].is_deletion(), Is().EqualTo(true));
+			Assert::That(patch["children"]["obj_1"]["properties"].size(), Is().EqualTo(1u));
+		}
+		Then(type_change_is_overwritten) {
+			after["children"]["obj_1"]["properties"]["name"] = 7;
+			const property& patch = property::diff(before, after);
+			Assert::That(patch["children"]["obj_1"]["properties"]["name"].is_overwrite(), Is().EqualTo(true));
+		}
+		Then(removed_root_is_marked) {
+			Assert::That(property::diff(before, property()).is_deletion(), Is().EqualTo(true));
+		}
+		Then(patch_turns_before_into_after) {
+			after["children"]["obj_1"]["properties"]["position"] = property::array {};
+			after["children"]["obj_1"]["properties"]["scale"] = 2.f;
+			after["children"]["obj_1"]["properties"]["name"] = nullptr;
+			after["children"]["obj_2"]["tags"].remove(std::size_t(2));
+			after["children"]["obj_2"]["tags"][std::size_t(0)] = "invisible";
+			after["children"]["obj_3"]["tags"][std::size_t(1)] = "new";
+			Assert::That(apply(before, property::diff(before, after)), Is().EqualTo(after));
+		}
+		Then(hole_in_the_middle_overwrites_array) {
+			after["children"]["obj_2"]["tags"] = property::array {
+				std::make_pair(std::size_t(0), property("visible")),
+				std::make_pair(std::size_t(2), property("red")),
+			};
+			const property& patch = property::diff(before, after);
+			Assert::That(patch["children"]["obj_2"]["tags"].is_overwrite(), Is().EqualTo(true));
+			Assert::That(apply(before, patch), Is().EqualTo(after));
+		}
+	};
+	Context(compact) {
+		property state = make_state();
+
+		Then(sequence_is_merged) {
+			std::vector<property> states {state, state, state, state};
+			states[1]["children"]["obj_1"]["properties"]["position"]["x"] = 3.;
+			states[1]["children"]["obj_2"]["tags"].remove(std::size_t(2));
+			states[2] = states[1];
+			states[2]["children"]["obj_1"]["properties"].remove(keystring("position"));
+			states[2]["children"]["obj_2"]["tags"][std::size_t(2)] = "blue";
+			states[3] = states[2];
+			states[3]["children"]["obj_1"]["properties"]["position"] = "left";
+			states[3]["children"]["obj_4"] = true;
+
+			std::vector<property> patches;
+			for (std::size_t index = 1; index < states.size(); ++index)
+				patches.push_back(property::diff(states[index - 1], states[index]));
+			const property& patch = property::compact(patches.begin(), patches.end());
+			Assert::That(apply(state, patch), Is().EqualTo(states.back()));
+		}
+		Then(deletion_wins) {
+			property first;
+			first["a"] = 1;
+			Assert::That(property::compact(first, property::make_deletion()).is_deletion(), Is().EqualTo(true));
+		}
+		Then(none_keeps_patch) {
+			property first;
+			first["a"] = 1;
+			Assert::That(property::compact(first, property()), Is().EqualTo(first));
+			Assert::That(property::compact(property(), first), Is().EqualTo(first));
+		}
+		Then(deletion_then_patch_overwrites) {
+			property second;
+			second["x"] = 1;
+			second["y"] = property::make_deletion();
+			const property& patch = property::compact(property::make_deletion(), second);
+			Assert::That(patch.is_overwrite(), Is().EqualTo(true));
+			property expected;
+			expected["x"] = 1;
+			Assert::That(apply(state, patch), Is().EqualTo(expected));
+		}
+		Then(incompatible_patches_throw) {
+			AssertThrowsEx(PropertyCastException, property::compact(property(1), property("x")));
+		}
+	};
+};
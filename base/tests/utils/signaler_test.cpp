@@ -17,6 +17,9 @@
 
 #include <functional>
 #include <exception>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <set>
 
 using namespace igloo;
@@ -576,3 +579,99 @@ Describe(subscribtions) {
 	};
 };
 
+Describe(signaler_snapshot) {
+	It(subscribtions_of_the_same_handler_are_independent) {
+		signaler<int> event;
+		int calls = 0;
+		auto make_handler = [&calls]() {
+			return [&calls](const int) {
+				++calls;
+			};
+		};
+		auto first = event.subscribe(make_handler());
+		auto second = event.subscribe(make_handler());
+		first.reset();
+		event.emit(1);
+		Assert::That(calls, Is().EqualTo(1));
+	}
+	It(handler_unsubscribed_under_emit_is_skipped) {
+		signaler<void> event;
+		int calls = 0;
+		auto_unsubscriber second;
+		auto first = event.subscribe([&second]() {
+			second.reset();
+		});
+		second = event.subscribe([&calls]() {
+			++calls;
+		});
+		event.emit();
+		event.emit();
+		Assert::That(calls, Is().EqualTo(0));
+	}
+	It(handler_subscribed_under_emit_gets_next_event) {
+		signaler<void> event;
+		int calls = 0;
+		auto_unsubscriber second;
+		auto first = event.subscribe([&]() {
+			if (second == nullptr)
+				second = event.subscribe([&calls]() {
+					++calls;
+				});
+		});
+		event.emit();
+		Assert::That(calls, Is().EqualTo(0));
+		event.emit();
+		Assert::That(calls, Is().EqualTo(1));
+	}
+	It(emits_from_many_threads_under_subscribtions) {
+		signaler<int> event;
+		std::atomic<int> sum {0};
+		auto permanent = event.subscribe([&sum](const int value) {
+			sum += value;
+		});
+		std::atomic<bool> done {false};
+		std::thread subscriber([&event, &done]() {
+			while (not done)
+			{
+				auto temporary = event.subscribe([](const int) {});
+				std::this_thread::yield();
+			}
+		});
+		std::vector<std::thread> emitters;
+		for (int thread = 0; thread < 3; ++thread)
+			emitters.emplace_back([&event]() {
+				for (int index = 0; index < 10000; ++index)
+					event.emit(1);
+			});
+		for (auto& thread : emitters)
+			thread.join();
+		done = true;
+		subscriber.join();
+		Assert::That(sum.load(), Is().EqualTo(30000));
+	}
+};
+
+Describe(light_signaler_test) {
+	It(unsubscribe_erases_handler) {
+		light_signaler<int> event;
+		light_signaler<int>::eventhandler handler = [](const int) {};
+		event.subscribe(handler);
+		event.unsubscribe(handler);
+		Assert::That(event.size(), Is().EqualTo(0u));
+	}
+	It(unsubscribe_under_emit_erases_after_emit) {
+		light_signaler<void> event;
+		int calls = 0;
+		light_signaler<void>::eventhandler second = [&calls]() {
+			++calls;
+		};
+		event.subscribe([&]() {
+			event.unsubscribe(second);
+			Assert::That(event.size(), Is().EqualTo(2u));
+		});
+		event.subscribe(second);
+		event.emit();
+		Assert::That(calls, Is().EqualTo(0));
+		Assert::That(event.size(), Is().EqualTo(1u));
+	}
+};
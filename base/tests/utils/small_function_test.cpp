@@ -0,0 +1,88 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/bdd.h>
+
+#include <pisk/utils/small_function.h>
+
+#include <functional>
+#include <memory>
+#include <array>
+
+using namespace igloo;
+using namespace pisk::utils;
+
+Describe(small_function_test) {
+	It(is_empty_by_default) {
+		small_function<void ()> function;
+		Assert::That(static_cast<bool>(function), Is().EqualTo(false));
+		AssertThrowsEx(std::bad_function_call, function());
+	}
+	It(calls_callee) {
+		int value = 0;
+		small_function<int (int)> function = [&value](const int arg) {
+			value = arg;
+			return arg * 2;
+		};
+		Assert::That(function(21), Is().EqualTo(42));
+		Assert::That(value, Is().EqualTo(21));
+	}
+	It(keeps_small_callee_inside) {
+		auto small = [](){};
+		std::array<char, 128> big_data {};
+		auto big = [big_data]() {
+			return big_data[0];
+		};
+		Assert::That(small_function<void ()>::is_inplace<decltype(small)>(), Is().EqualTo(true));
+		Assert::That(small_function<void ()>::is_inplace<decltype(big)>(), Is().EqualTo(false));
+		small_function<char ()> function = big;
+		Assert::That(function(), Is().EqualTo(0));
+	}
+	It(keeps_move_only_callee) {
+		auto value = std::make_unique<int>(5);
+		small_function<int ()> function = [value = std::move(value)]() {
+			return *value;
+		};
+		small_function<int ()> moved = std::move(function);
+		Assert::That(static_cast<bool>(function), Is().EqualTo(false));
+		Assert::That(moved(), Is().EqualTo(5));
+	}
+	It(destroys_callee) {
+		const auto item = std::make_shared<int>(1);
+		{
+			small_function<void ()> function = [item]() {};
+			Assert::That(item.use_count(), Is().EqualTo(2));
+			function = nullptr;
+			Assert::That(item.use_count(), Is().EqualTo(1));
+			function = [item]() {};
+		}
+		Assert::That(item.use_count(), Is().EqualTo(1));
+	}
+	It(empty_std_function_makes_empty) {
+		std::function<void ()> empty;
+		small_function<void ()> function = empty;
+		Assert::That(static_cast<bool>(function), Is().EqualTo(false));
+	}
+	It(swap_exchanges_callees) {
+		small_function<int ()> first = []() {
+			return 1;
+		};
+		std::array<int, 32> big_data {{2}};
+		small_function<int ()> second = [big_data]() {
+			return big_data[0];
+		};
+		first.swap(second);
+		Assert::That(first(), Is().EqualTo(2));
+		Assert::That(second(), Is().EqualTo(1));
+	}
+};
@@ -0,0 +1,80 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//The global operator new is replaced for the whole process, the engine libraries included
+namespace
+{
+	std::atomic<std::size_t> allocations {0};
+
+	void* allocate(const std::size_t size)
+	{
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		return std::malloc(size == 0 ? 1 : size);
+	}
+}
+
+std::size_t pisk::benchmarks::allocations_count() noexcept
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(const std::size_t size)
+{
+	if (void* out = allocate(size))
+		return out;
+	throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size)
+{
+	if (void* out = allocate(size))
+		return out;
+	throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
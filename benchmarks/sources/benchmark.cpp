@@ -0,0 +1,210 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+
+#include <pisk/utils/property_tree.h>
+#include <pisk/utils/json_utils.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <ctime>
+
+namespace pisk
+{
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr long json_format = 1;
+		constexpr std::size_t max_iterations = 1000000000;
+
+		std::vector<std::pair<std::string, benchmark>>& registered()
+		{
+			static std::vector<std::pair<std::string, benchmark>> out;
+			return out;
+		}
+
+		std::string compiler()
+		{
+#if defined(__clang__)
+			return "clang " __clang_version__;
+#elif defined(__GNUC__)
+			return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+			return "msvc " + std::to_string(_MSC_VER);
+#else
+			return "unknown";
+#endif
+		}
+
+		std::string timestamp()
+		{
+			const std::time_t now = std::time(nullptr);
+			char out[32] = {};
+			std::strftime(out, sizeof(out), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+			return out;
+		}
+	}
+
+	suite::suite(const options& config) :
+		config(config)
+	{}
+
+	bool suite::selected(std::initializer_list<std::string> names) const
+	{
+		return std::any_of(names.begin(), names.end(), [this](const std::string& name) {
+			return name.find(config.filter) != std::string::npos;
+		});
+	}
+
+	void suite::measure(const std::string& name, const std::function<void ()>& operation, const std::size_t operations)
+	{
+		if (not selected({name}))
+			return;
+
+		//warm up the caches and the lazy initialization
+		operation();
+
+		//grow the count of calls until a repetition lasts min_time
+		const double min_time = std::chrono::duration<double, std::nano>(config.min_time).count();
+		std::size_t iterations = 1;
+		while (iterations < max_iterations)
+		{
+			const double elapsed = run(operation, iterations);
+			if (elapsed >= min_time)
+				break;
+			const double factor = elapsed <= 0. ? 10. : std::min(10., 1.2 * min_time / elapsed);
+			iterations = std::max(iterations + 1, static_cast<std::size_t>(iterations * factor));
+		}
+
+		const double count = static_cast<double>(iterations * operations);
+		std::vector<double> samples;
+		const std::size_t allocations_before = allocations_count();
+		for (std::size_t repetition = 0; repetition < std::max<std::size_t>(config.repetitions, 1); ++repetition)
+			samples.push_back(run(operation, iterations) / count);
+		const std::size_t allocations = allocations_count() - allocations_before;
+
+		std::sort(samples.begin(), samples.end());
+		const std::size_t middle = samples.size() / 2;
+		const double median = samples.size() % 2 == 1 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+		results.push_back(result {
+			name,
+			iterations,
+			operations,
+			median,
+			samples.front(),
+			samples.back(),
+			static_cast<double>(allocations) / (count * samples.size())
+		});
+		print(results.back());
+	}
+
+	const std::vector<result>& suite::get_results() const
+	{
+		return results;
+	}
+
+	double suite::run(const std::function<void ()>& operation, const std::size_t iterations) const
+	{
+		const auto& start = std::chrono::steady_clock::now();
+		for (std::size_t index = 0; index < iterations; ++index)
+			operation();
+		const auto& elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::nano>(elapsed).count();
+	}
+
+	void suite::print(const result& item) const
+	{
+		std::ostream& out = *config.table;
+		out << std::left << std::setw(64) << item.name << std::right << std::fixed
+			<< std::setw(14) << std::setprecision(1) << item.median_ns << " ns/op"
+			<< std::setw(12) << std::setprecision(1) << item.min_ns << " min"
+			<< std::setw(10) << std::setprecision(2) << item.allocations << " allocs/op";
+		const auto& found = config.baseline.find(item.name);
+		if (found != config.baseline.end() and found->second > 0.)
+			out << std::setw(9) << std::showpos << std::setprecision(1)
+				<< (item.median_ns / found->second - 1.) * 100. << std::noshowpos << "%";
+		out << std::endl;
+	}
+
+	registration::registration(const char* group, benchmark run)
+	{
+		registered().emplace_back(group, std::move(run));
+	}
+
+	void run_registered(suite& benchmarks)
+	{
+		auto groups = registered();
+		std::sort(groups.begin(), groups.end(), [](const auto& left, const auto& right) {
+			return left.first < right.first;
+		});
+		for (const auto& group : groups)
+			group.second(benchmarks);
+	}
+
+	void write_json(const std::vector<result>& results, const options& config, std::string& out)
+	{
+		utils::property document;
+		document["format"] = json_format;
+		document["context"]["compiler"] = compiler();
+		document["context"]["threads"] = static_cast<long>(std::thread::hardware_concurrency());
+		document["context"]["repetitions"] = static_cast<long>(config.repetitions);
+		document["context"]["min_time_ms"] = static_cast<long>(config.min_time.count());
+		document["context"]["timestamp"] = timestamp();
+		utils::property& items = document["benchmarks"];
+		items = utils::property::array();
+		for (std::size_t index = 0; index < results.size(); ++index)
+		{
+			const result& item = results[index];
+			utils::property& entry = items[index];
+			entry["name"] = item.name;
+			entry["iterations"] = static_cast<long>(item.iterations);
+			entry["operations"] = static_cast<long>(item.operations);
+			entry["ns_per_op"] = item.median_ns;
+			entry["min_ns_per_op"] = item.min_ns;
+			entry["max_ns_per_op"] = item.max_ns;
+			entry["allocations_per_op"] = item.allocations;
+		}
+		utils::json::write(document, out, true);
+	}
+
+	std::map<std::string, double> read_baseline(const std::string& document)
+	{
+		std::map<std::string, double> out;
+		const utils::property& root = utils::json::parse_json_to_property(document);
+		const utils::property& items = root["benchmarks"];
+		if (not items.is_array())
+			return out;
+		for (auto it = items.begin(); it != items.end(); ++it)
+		{
+			const utils::property& name = (*it)["name"];
+			const utils::property& value = (*it)["ns_per_op"];
+			if (not name.is_string())
+				continue;
+			if (value.is_double())
+				out[name.as_string()] = value.as_double();
+			else if (value.is_float())
+				out[name.as_string()] = value.as_float();
+			else if (value.is_long())
+				out[name.as_string()] = static_cast<double>(value.as_long());
+			else if (value.is_int())
+				out[name.as_string()] = value.as_int();
+		}
+		return out;
+	}
+}
+}
+
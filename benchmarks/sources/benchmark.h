@@ -0,0 +1,114 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include <pisk/defines.h>
+
+#include <initializer_list>
+#include <functional>
+#include <iostream>
+#include <cstddef>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace pisk
+{
+namespace benchmarks
+{
+	//The count of the global operator new calls; the benchmark executable replaces the operator
+	std::size_t allocations_count() noexcept;
+
+	//Keeps the value computed: the optimizer may not drop the measured code
+	template <typename Value>
+	void keep(const Value& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static const void* volatile sink;
+		sink = &value;
+#endif
+	}
+
+	struct result
+	{
+		std::string name;
+		//calls of the operation in one repetition
+		std::size_t iterations;
+		//operations made by one call, e.g. items passed through a queue
+		std::size_t operations;
+		//nanoseconds per operation over the repetitions
+		double median_ns;
+		double min_ns;
+		double max_ns;
+		double allocations;
+	};
+
+	struct options
+	{
+		//a substring of the names to run; empty runs everything
+		std::string filter;
+		//a repetition lasts at least this time
+		std::chrono::milliseconds min_time {100};
+		std::size_t repetitions = 5;
+		//median_ns by the name, from a former run
+		std::map<std::string, double> baseline;
+		//the results are printed as a table there
+		std::ostream* table = &std::cout;
+	};
+
+	class suite
+	{
+		const options config;
+		std::vector<result> results;
+
+	public:
+		explicit suite(const options& config);
+
+		//Will measure() run any of the names; expensive fixtures are built for the selected ones only
+		bool selected(std::initializer_list<std::string> names) const;
+
+		//Calls `operation` in a loop and prints the result; a call makes `operations` operations
+		void measure(const std::string& name, const std::function<void ()>& operation, const std::size_t operations = 1);
+
+		const std::vector<result>& get_results() const;
+
+	private:
+		double run(const std::function<void ()>& operation, const std::size_t iterations) const;
+		void print(const result& item) const;
+	};
+
+	using benchmark = std::function<void (suite&)>;
+
+	//A group of benchmarks; a static object of the benchmark source registers it
+	struct registration
+	{
+		registration(const char* group, benchmark run);
+	};
+
+	void run_registered(suite& benchmarks);
+
+	//Writes the results and the run context as json:
+	//{"format": 1, "context": {"compiler", "threads", "repetitions", "min_time_ms", "timestamp"},
+	// "benchmarks": [{"name", "iterations", "operations", "ns_per_op", "min_ns_per_op", "max_ns_per_op", "allocations_per_op"}]}
+	//ns_per_op is the median of the repetitions
+	void write_json(const std::vector<result>& results, const options& config, std::string& out);
+
+	//Reads median_ns of the results written by write_json
+	std::map<std::string, double> read_baseline(const std::string& document);
+}
+}
+
@@ -0,0 +1,84 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "fixtures.h"
+
+#include <string>
+
+namespace pisk
+{
+namespace benchmarks
+{
+	utils::property make_scene(const std::size_t count)
+	{
+		utils::property out;
+		out["properties"]["name"] = "benchmark";
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			const utils::keystring id("object_" + std::to_string(index));
+			utils::property& object = out["children"][id];
+			//the id is the key of the child, as ReflectedObject keeps it
+			object["properties"]["id"] = id;
+			object["properties"]["index"] = static_cast<int>(index);
+			object["properties"]["visible"] = index % 2 == 0;
+			object["properties"]["title"] = "Object \"" + std::to_string(index) + "\"\n";
+			utils::property& position = object["presentations"]["location"]["properties"]["position"];
+			position["x"] = index * 0.5;
+			position["y"] = index * 1.25;
+			position["z"] = -1.;
+			object["tags"][std::size_t(0)] = "static";
+			object["tags"][std::size_t(1)] = "visible";
+		}
+		return out;
+	}
+
+	void fill_patch(utils::property& out, const std::size_t moved)
+	{
+		for (std::size_t index = 0; index < moved; ++index)
+		{
+			utils::property& position = out["children"][utils::keystring("object_" + std::to_string(index))]["presentations"]["location"]["properties"]["position"];
+			position["x"] = index * 0.75;
+			position["y"] = index * 1.5;
+		}
+		utils::property& event = out["events"][std::size_t(0)];
+		event["type"] = "control";
+		event["action"] = "play";
+		event["id_path"][std::size_t(0)] = "scene";
+		event["id_path"][std::size_t(1)] = "music";
+	}
+
+	void fill_patch(utils::property& out, const std::vector<utils::keystring>& moved)
+	{
+		for (std::size_t index = 0; index < moved.size(); ++index)
+		{
+			utils::property& position = out["children"_ks][moved[index]]["presentations"_ks]["location"_ks]["properties"_ks]["position"_ks];
+			position["x"_ks] = index * 0.75;
+			position["y"_ks] = index * 1.5;
+		}
+		utils::property& event = out["events"_ks][std::size_t(0)];
+		event["type"_ks] = "control";
+		event["action"_ks] = "play";
+		event["id_path"_ks][std::size_t(0)] = "scene";
+		event["id_path"_ks][std::size_t(1)] = "music";
+	}
+
+	std::vector<utils::keystring> make_interned_names(const std::size_t count)
+	{
+		std::vector<utils::keystring> out;
+		for (std::size_t index = 0; index < count; ++index)
+			out.push_back(utils::keystring::intern("object_" + std::to_string(index)));
+		return out;
+	}
+}
+}
+
@@ -0,0 +1,37 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include <pisk/utils/property_tree.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace pisk
+{
+namespace benchmarks
+{
+	//A scene of `count` objects "object_<index>", each with a location, a few properties and tags
+	utils::property make_scene(const std::size_t count);
+
+	//Fills `out` as an engine fills a patch by push_changes: `moved` objects got a new position and one event
+	void fill_patch(utils::property& out, const std::size_t moved);
+
+	//The same patch by the keys which allocate nothing: the literals and the interned names of the objects
+	void fill_patch(utils::property& out, const std::vector<utils::keystring>& moved);
+
+	std::vector<utils::keystring> make_interned_names(const std::size_t count);
+}
+}
+
@@ -0,0 +1,117 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+#include "fixtures.h"
+
+#include <pisk/utils/json_utils.h>
+
+#include <json/json.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	//The former to_string: property -> Json::Value -> StreamWriter -> stringstream -> std::string
+	namespace reference
+	{
+		Json::Value convert(const utils::property& root)
+		{
+			Json::Value out;
+			if (root.is_none()) {
+			} else if (root.is_dictionary()) {
+				for (auto it = root.begin(); it != root.end(); ++it)
+					out[it.get_key().c_str()] = convert(*it);
+			} else if (root.is_array()) {
+				for (auto it = root.begin(); it != root.end(); ++it)
+					out[static_cast<Json::ArrayIndex>(it.get_index())] = convert(*it);
+			} else if (root.is_bool()) {
+				out = root.as_bool();
+			} else if (root.is_int()) {
+				out = root.as_int();
+			} else if (root.is_long()) {
+				out = static_cast<Json::Value::Int64>(root.as_long());
+			} else if (root.is_float()) {
+				out = root.as_float();
+			} else if (root.is_double()) {
+				out = root.as_double();
+			} else if (root.is_string()) {
+				out = root.as_string();
+			}
+			return out;
+		}
+
+		std::string to_string(const utils::property& root)
+		{
+			Json::StreamWriterBuilder builder;
+			builder["indentation"] = "";
+			auto writer = std::unique_ptr<Json::StreamWriter>(builder.newStreamWriter());
+			std::stringstream out;
+			writer->write(convert(root), &out);
+			return out.str();
+		}
+	}
+
+	void measure_to_string(suite& benchmarks, const std::string& name, const utils::property& document)
+	{
+		benchmarks.measure("json/to_string_jsoncpp" + name, [&document]() {
+			keep(reference::to_string(document));
+		});
+		benchmarks.measure("json/to_string" + name, [&document]() {
+			keep(utils::json::to_string(document));
+		});
+	}
+
+	const registration json_benchmarks("json", [](suite& benchmarks) {
+		//a patch as an engine pushes it: one event
+		utils::property event;
+		fill_patch(event, 0);
+		std::string buffer;
+		measure_to_string(benchmarks, "/event", event);
+		benchmarks.measure("json/write/event", [&event, &buffer]() {
+			buffer.clear();
+			utils::json::write(event, buffer);
+			keep(buffer);
+		});
+
+		for (const std::size_t objects : {1000, 10000, 100000})
+		{
+			const std::string size = "/scene_" + std::to_string(objects / 1000) + "k";
+			if (not benchmarks.selected({"json/parse" + size, "json/to_string_jsoncpp" + size, "json/to_string" + size, "json/write" + size, "json/write_pretty" + size}))
+				continue;
+
+			const utils::property scene = make_scene(objects);
+			const std::string document = utils::json::to_string(scene);
+			benchmarks.measure("json/parse" + size, [&document]() {
+				keep(utils::json::parse_json_to_property(document));
+			});
+			measure_to_string(benchmarks, size, scene);
+			benchmarks.measure("json/write" + size, [&scene, &buffer]() {
+				buffer.clear();
+				utils::json::write(scene, buffer);
+				keep(buffer);
+			});
+			benchmarks.measure("json/write_pretty" + size, [&scene, &buffer]() {
+				buffer.clear();
+				utils::json::write(scene, buffer, true);
+				keep(buffer);
+			});
+		}
+	});
+}
+
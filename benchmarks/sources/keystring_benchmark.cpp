@@ -0,0 +1,79 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+
+#include <pisk/utils/keystring.h>
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	const registration keystring_benchmarks("keystring", [](suite& benchmarks) {
+		const std::string short_text = "position";
+		const std::string long_text = "presentations/location/properties/position/x";
+
+		benchmarks.measure("keystring/create/short", [&short_text]() {
+			keep(utils::keystring(short_text));
+		});
+		benchmarks.measure("keystring/create/long", [&long_text]() {
+			keep(utils::keystring(long_text));
+		});
+		benchmarks.measure("keystring/intern", [&long_text]() {
+			keep(utils::keystring::intern(long_text));
+		});
+
+		const utils::keystring regular(long_text);
+		const utils::keystring interned = utils::keystring::intern(long_text);
+		benchmarks.measure("keystring/copy/regular", [&regular]() {
+			keep(utils::keystring(regular));
+		});
+		benchmarks.measure("keystring/copy/interned", [&interned]() {
+			keep(utils::keystring(interned));
+		});
+
+		const utils::keystring same(long_text);
+		const utils::keystring other(long_text.substr(0, long_text.size() - 1) + "y");
+		benchmarks.measure("keystring/compare/equal", [&regular, &same]() {
+			const bool equal = regular == same;
+			keep(equal);
+		});
+		benchmarks.measure("keystring/compare/different", [&regular, &other]() {
+			const bool equal = regular == other;
+			keep(equal);
+		});
+		benchmarks.measure("keystring/compare/literal", [&interned]() {
+			const bool equal = interned == "presentations/location/properties/position/x"_ks;
+			keep(equal);
+		});
+
+		const std::size_t count = 1000;
+		std::unordered_map<utils::keystring, int> map;
+		std::vector<utils::keystring> keys;
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			keys.emplace_back("object_" + std::to_string(index));
+			map[keys.back()] = static_cast<int>(index);
+		}
+		benchmarks.measure("keystring/lookup/unordered_map", [&map, &keys]() {
+			for (const auto& key : keys)
+				keep(map.find(key));
+		}, count);
+	});
+}
+
@@ -0,0 +1,143 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+
+#include "benchmark.h"
+
+#include <pisk/infrastructure/Logger.h>
+#include <pisk/infrastructure/TraceLog.h>
+#include <pisk/utils/json_utils.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	using Arguments = std::vector<utils::property>;
+
+	//The former logging calls: the tag and the format are std::string parameters
+	//and every argument is evaluated before the level is checked
+	namespace reference
+	{
+		template <typename ...TArgs>
+		void log_format(const logger::Level level, const std::string& tag, const std::string& format, TArgs&& ... args)
+		{
+			if (logger::is_level_filtered(level))
+				return;
+			logger::log(level, tag, utils::string::format(format, std::forward<TArgs>(args)...));
+		}
+		template <typename ...TArgs>
+		void spam(const std::string& tag, const std::string& format, TArgs&& ... args)
+		{
+			log_format(logger::Level::Spam, tag, format, std::forward<TArgs>(args)...);
+		}
+		template <typename ...TArgs>
+		void debug(const std::string& tag, const std::string& format, TArgs&& ... args)
+		{
+			log_format(logger::Level::Debug, tag, format, std::forward<TArgs>(args)...);
+		}
+	}
+
+	std::string to_json(const Arguments& args)
+	{
+		std::string out(1, '[');
+		for (std::size_t index = 0; index < args.size(); ++index)
+		{
+			if (index != 0)
+				out.push_back(',');
+			utils::json::write(args[index], out);
+		}
+		out.push_back(']');
+		return out;
+	}
+
+	//arguments of a script call as the script engine passes them: an object state
+	Arguments make_arguments()
+	{
+		utils::property state;
+		state["id"] = "object_1";
+		state["properties"]["position"]["x"] = 1.5;
+		state["properties"]["position"]["y"] = -2.;
+		state["properties"]["visible"] = true;
+		return {state, utils::property("on_update")};
+	}
+
+	//The log level of the suite is Critical, so every measured record is filtered out of the text log
+	const registration logger_benchmarks("logger", [](suite& benchmarks) {
+		//script calls per engine tick
+		const std::size_t calls = 100;
+		const Arguments arguments = make_arguments();
+		const utils::keystring resource_id("scripts/object.lua");
+		const utils::keystring function("on_update");
+		const void* task = &arguments;
+
+		benchmarks.measure("logger/filtered/debug_former", [task]() {
+			reference::debug("engine_task", "Task {} loop", task);
+		});
+		benchmarks.measure("logger/filtered/debug", [task]() {
+			logger::debug("engine_task", "Task {} loop", task);
+		});
+		benchmarks.measure("logger/filtered/spam_arguments_former", [&]() {
+			reference::spam("script", "Execute {}:{}({})", resource_id.c_str(), function, to_json(arguments));
+		});
+		benchmarks.measure("logger/filtered/spam_arguments", [&]() {
+			if (auto&& log = logger::spam("script"))
+				log.print("Execute {}:{}({})", resource_id.c_str(), function, to_json(arguments));
+		});
+		benchmarks.measure("logger/filtered/script_tick_former", [&]() {
+			for (std::size_t index = 0; index < calls; ++index)
+			{
+				reference::spam("script", "Execute {}:{}({})", resource_id.c_str(), function, to_json(arguments));
+				reference::spam("script", "Script executed with results: {}", to_json(arguments));
+			}
+		}, calls * 2);
+		benchmarks.measure("logger/filtered/script_tick", [&]() {
+			for (std::size_t index = 0; index < calls; ++index)
+			{
+				if (auto&& log = logger::spam("script"))
+					log.print("Execute {}:{}({})", resource_id.c_str(), function, to_json(arguments));
+				if (auto&& log = logger::spam("script"))
+					log.print("Script executed with results: {}", to_json(arguments));
+			}
+		}, calls * 2);
+
+		if (not benchmarks.selected({"logger/traced/debug", "logger/traced/debug_text", "logger/traced/debug_4_threads"}))
+			return;
+		//the binary trace is on for Debug while the text log is filtered
+		std::vector<char> block(infrastructure::TraceRing::block_size(65536, 65536));
+		logger::set_trace_storage(std::make_unique<infrastructure::TraceRing>(block.data(), 65536, 65536));
+		benchmarks.measure("logger/traced/debug", [task]() {
+			logger::debug("engine_task", "Task {} loop", task);
+		});
+		benchmarks.measure("logger/traced/debug_text", []() {
+			logger::debug("http", "Request by url: {}", "https://example.com/api/v1/state");
+		});
+		const std::size_t records_per_thread = 100000;
+		benchmarks.measure("logger/traced/debug_4_threads", [task, records_per_thread]() {
+			std::vector<std::thread> threads;
+			for (int thread = 0; thread < 4; ++thread)
+				threads.emplace_back([task, records_per_thread]() {
+					for (std::size_t index = 0; index < records_per_thread; ++index)
+						logger::debug("engine_task", "Task {} loop", task);
+				});
+			for (auto& thread : threads)
+				thread.join();
+		}, 4 * records_per_thread);
+		logger::set_trace_storage(nullptr);
+	});
+}
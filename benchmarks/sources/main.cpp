@@ -0,0 +1,103 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+
+#include <pisk/infrastructure/Logger.h>
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace pisk;
+
+namespace
+{
+	bool read_file(const std::string& path, std::string& out)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (not file)
+			return false;
+		out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	int usage()
+	{
+		std::cerr << "Usage: pisk_benchmarks [--filter <text>] [--min-time <ms>] [--repetitions <count>]" << std::endl
+			<< "                      [--json <file, - for stdout>] [--compare <former json>]" << std::endl;
+		return 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	infrastructure::Logger::set_log_level(infrastructure::Logger::Level::Critical);
+
+	benchmarks::options config;
+	std::string json_path;
+	for (int index = 1; index < argc; ++index)
+	{
+		const std::string key = argv[index];
+		if (index + 1 == argc)
+			return usage();
+		const std::string value = argv[++index];
+		if (key == "--filter")
+			config.filter = value;
+		else if (key == "--min-time")
+			config.min_time = std::chrono::milliseconds(std::stoul(value));
+		else if (key == "--repetitions")
+			config.repetitions = std::stoul(value);
+		else if (key == "--json")
+			json_path = value;
+		else if (key == "--compare")
+		{
+			std::string document;
+			if (not read_file(value, document))
+			{
+				std::cerr << "Failed to read " << value << std::endl;
+				return 1;
+			}
+			config.baseline = benchmarks::read_baseline(document);
+		}
+		else
+			return usage();
+	}
+
+	//the json goes to stdout alone
+	if (json_path == "-")
+		config.table = &std::cerr;
+
+	benchmarks::suite suite(config);
+	benchmarks::run_registered(suite);
+
+	if (json_path.empty())
+		return 0;
+	std::string document;
+	benchmarks::write_json(suite.get_results(), config, document);
+	if (json_path == "-")
+	{
+		std::cout << document << std::endl;
+		return 0;
+	}
+	std::ofstream file(json_path, std::ios::binary);
+	file << document;
+	if (not file)
+	{
+		std::cerr << "Failed to write " << json_path << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
@@ -0,0 +1,164 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+#include "fixtures.h"
+
+#include <pisk/tools/ParallelReplace.h>
+#include <pisk/utils/memory_resource.h>
+#include <pisk/utils/property_tree.h>
+
+#include <string>
+#include <vector>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	void measure_scene(suite& benchmarks, const std::size_t objects)
+	{
+		const std::string size = "/scene_" + std::to_string(objects / 1000) + "k";
+		if (not benchmarks.selected({"property/construct" + size, "property/copy" + size, "property/copy_sealed" + size, "property/copy_sealed_and_modify" + size, "property/compare" + size, "property/replace_patch" + size, "property/replace_bulk/sequential" + size, "property/replace_bulk/parallel" + size, "property/erase_half" + size}))
+			return;
+
+		benchmarks.measure("property/construct" + size, [objects]() {
+			keep(make_scene(objects));
+		});
+
+		const utils::property scene = make_scene(objects);
+		const utils::property same_scene = make_scene(objects);
+		//a sealed tree shares the storage with the copies, as a loaded resource does
+		utils::property sealed_scene = make_scene(objects);
+		sealed_scene.seal();
+		benchmarks.measure("property/copy" + size, [&scene]() {
+			const utils::property copy = scene;
+			keep(copy);
+		});
+		benchmarks.measure("property/copy_sealed" + size, [&sealed_scene]() {
+			const utils::property copy = sealed_scene;
+			keep(copy);
+		});
+		//the shared storage is cloned along the path to the changed value only
+		benchmarks.measure("property/copy_sealed_and_modify" + size, [&sealed_scene]() {
+			utils::property copy = sealed_scene;
+			copy["children"]["object_0"]["properties"]["index"] = 1;
+			keep(copy);
+		});
+		benchmarks.measure("property/compare" + size, [&scene, &same_scene]() {
+			const bool equal = scene == same_scene;
+			keep(equal);
+		});
+
+		utils::property patch;
+		fill_patch(patch, objects / 10);
+		utils::property target = make_scene(objects);
+		benchmarks.measure("property/replace_patch" + size, [&target, &patch]() {
+			utils::property::replace(target, patch);
+		});
+
+		//a level load patches every object; the scene is shared with the resource, so the paths are cloned.
+		//The parallel merge falls back to the sequential one below tools::parallel_replace_threshold objects
+		const utils::property bulk = make_scene(objects);
+		benchmarks.measure("property/replace_bulk/sequential" + size, [&sealed_scene, &bulk]() {
+			utils::property target = sealed_scene;
+			utils::property::replace(target, bulk);
+			keep(target);
+		});
+		benchmarks.measure("property/replace_bulk/parallel" + size, [&sealed_scene, &bulk]() {
+			utils::property target = sealed_scene;
+			tools::replace_parallel(target, bulk);
+			keep(target);
+		});
+
+		//a patch removes every second object; the copy clones the shared children once
+		std::vector<utils::keystring> removed;
+		for (std::size_t index = 0; index < objects; index += 2)
+			removed.emplace_back("object_" + std::to_string(index));
+		benchmarks.measure("property/erase_half" + size, [&sealed_scene, &removed]() {
+			utils::property target = sealed_scene;
+			const utils::property& children = target["children"];
+			for (const auto& key : removed)
+				children.remove(key);
+			keep(target);
+		}, removed.size());
+	}
+
+	void measure_lookup(suite& benchmarks)
+	{
+		const std::size_t objects = 1000;
+		if (not benchmarks.selected({"property/lookup/keystring", "property/lookup/string", "property/lookup/literal"}))
+			return;
+		const utils::property scene = make_scene(objects);
+		const utils::property& children = scene["children"];
+		std::vector<utils::keystring> keys;
+		std::vector<std::string> names;
+		for (std::size_t index = 0; index < objects; ++index)
+		{
+			names.push_back("object_" + std::to_string(index));
+			keys.emplace_back(names.back());
+		}
+
+		benchmarks.measure("property/lookup/keystring", [&children, &keys]() {
+			for (const auto& key : keys)
+				keep(children[key]);
+		}, objects);
+		benchmarks.measure("property/lookup/string", [&children, &names]() {
+			for (const auto& name : names)
+				keep(children[name]);
+		}, objects);
+		benchmarks.measure("property/lookup/literal", [&scene]() {
+			keep(scene["properties"]["name"_ks]);
+		});
+	}
+
+	//A patch of push_changes is built and released each engine tick
+	void measure_patch(suite& benchmarks)
+	{
+		for (const std::size_t moved : {100, 1000})
+		{
+			const std::string size = "/moved_" + std::to_string(moved);
+			benchmarks.measure("property/push_changes_patch/default" + size, [moved]() {
+				utils::property patch;
+				fill_patch(patch, moved);
+				keep(patch);
+			});
+			utils::monotonic_resource arena;
+			benchmarks.measure("property/push_changes_patch/arena" + size, [moved, &arena]() {
+				{
+					utils::property patch(arena);
+					fill_patch(patch, moved);
+					keep(patch);
+				}
+				arena.release();
+			});
+			const std::vector<utils::keystring> names = make_interned_names(moved);
+			benchmarks.measure("property/push_changes_patch/arena_interned_keys" + size, [&names, &arena]() {
+				{
+					utils::property patch(arena);
+					fill_patch(patch, names);
+					keep(patch);
+				}
+				arena.release();
+			});
+		}
+	}
+
+	const registration property_benchmarks("property", [](suite& benchmarks) {
+		for (const std::size_t objects : {1000, 10000})
+			measure_scene(benchmarks, objects);
+		measure_lookup(benchmarks);
+		measure_patch(benchmarks);
+	});
+}
+
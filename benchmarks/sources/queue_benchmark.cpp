@@ -0,0 +1,106 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+
+#include <pisk/utils/safequeue.h>
+#include <pisk/utils/mpsc_queue.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	//a patch or a task pointer is what the engines pass through the queues
+	using Item = std::shared_ptr<int>;
+
+	const std::size_t items_per_producer = 10000;
+
+	//Producers push to the queue while the calling thread drains it; returns after all the items passed
+	template <typename Push, typename Consume>
+	void pass_items(const std::size_t producers, Push&& push, Consume&& consume)
+	{
+		std::vector<std::thread> threads;
+		for (std::size_t thread = 0; thread < producers; ++thread)
+			threads.emplace_back([&push]() {
+				const Item item = std::make_shared<int>(0);
+				for (std::size_t index = 0; index < items_per_producer; ++index)
+					push(item);
+			});
+		std::size_t consumed = 0;
+		while (consumed < producers * items_per_producer)
+		{
+			const std::size_t count = consume();
+			if (count == 0)
+				std::this_thread::yield();
+			consumed += count;
+		}
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	const registration queue_benchmarks("queue", [](suite& benchmarks) {
+		for (const std::size_t producers : {1, 2, 4, 8, 16})
+		{
+			const std::string name = "/producers_" + std::to_string(producers);
+			const std::size_t items = producers * items_per_producer;
+
+			utils::safequeue<Item> safe;
+			benchmarks.measure("queue/safequeue/pop" + name, [&safe, producers]() {
+				Item out;
+				pass_items(producers, [&safe](const Item& item) {
+					safe.push(item);
+				}, [&safe, &out]() -> std::size_t {
+					return safe.pop(out) ? 1 : 0;
+				});
+			}, items);
+
+			utils::mpsc_queue<Item> mpsc;
+			benchmarks.measure("queue/mpsc_queue/pop" + name, [&mpsc, producers]() {
+				Item out;
+				pass_items(producers, [&mpsc](const Item& item) {
+					mpsc.push(item);
+				}, [&mpsc, &out]() -> std::size_t {
+					return mpsc.pop(out) ? 1 : 0;
+				});
+			}, items);
+			benchmarks.measure("queue/mpsc_queue/pop_all" + name, [&mpsc, producers]() {
+				std::vector<Item> out;
+				pass_items(producers, [&mpsc](const Item& item) {
+					mpsc.push(item);
+				}, [&mpsc, &out]() -> std::size_t {
+					out.clear();
+					return mpsc.pop_all(out);
+				});
+			}, items);
+
+			utils::bounded_mpsc_queue<Item> bounded(4096);
+			benchmarks.measure("queue/bounded_mpsc_queue/pop_all" + name, [&bounded, producers]() {
+				std::vector<Item> out;
+				pass_items(producers, [&bounded](const Item& item) {
+					while (not bounded.push(item))
+						std::this_thread::yield();
+				}, [&bounded, &out]() -> std::size_t {
+					out.clear();
+					return bounded.pop_all(out);
+				});
+			}, items);
+		}
+	});
+}
+
@@ -0,0 +1,104 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+
+#include "benchmark.h"
+#include "fixtures.h"
+
+#include <pisk/model/ReflectedScene.h>
+#include <pisk/model/ReflectedItem.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	const utils::keystring kchildren = "children"_ks;
+	const utils::keystring kindex = "index"_ks;
+	const utils::keystring kvisible = "visible"_ks;
+
+	//The lookups of the children by id in a random order, as the engines reflect the objects of a patch
+	void measure_scene(suite& benchmarks, const std::size_t objects)
+	{
+		const std::string size = "/scene_" + std::to_string(objects / 1000) + "k";
+		if (not benchmarks.selected({"reflected/property_child" + size, "reflected/const_child" + size, "reflected/const_child_property" + size, "reflected/child_properties_into_patch" + size, "reflected/iterate_children" + size, "reflected/remove_half_children" + size}))
+			return;
+
+		//a loaded scene shares the storage with the resource
+		utils::property scene = make_scene(objects);
+		scene.seal();
+		std::vector<utils::keystring> ids;
+		for (std::size_t index = 0; index < objects; ++index)
+			ids.emplace_back("object_" + std::to_string(index));
+		std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+
+		benchmarks.measure("reflected/property_child" + size, [&scene, &ids]() {
+			std::size_t sum = 0;
+			for (const utils::keystring& id : ids)
+				sum += scene[kchildren][id].size();
+			keep(sum);
+		}, objects);
+		benchmarks.measure("reflected/const_child" + size, [&scene, &ids]() {
+			const model::ConstReflectedScene reflected(scene, utils::property::none_property());
+			std::size_t sum = 0;
+			for (const utils::keystring& id : ids)
+				sum += reflected.child(id).size();
+			keep(sum);
+		}, objects);
+		benchmarks.measure("reflected/const_child_property" + size, [&scene, &ids]() {
+			const model::ConstReflectedScene reflected(scene, utils::property::none_property());
+			std::size_t sum = 0;
+			for (const utils::keystring& id : ids)
+				sum += reflected.child(id).properties().get_item(kindex).as_int();
+			keep(sum);
+		}, objects);
+		benchmarks.measure("reflected/child_properties_into_patch" + size, [&scene, &ids]() {
+			utils::property patch;
+			model::ReflectedScene reflected(scene, patch);
+			for (const utils::keystring& id : ids)
+			{
+				auto&& properties = reflected.child(id).properties();
+				keep(properties.get_item(kindex).as_int());
+				properties.get_item(kvisible) = true;
+			}
+			keep(patch);
+		}, objects);
+		benchmarks.measure("reflected/iterate_children" + size, [&scene]() {
+			std::size_t sum = 0;
+			for (const utils::property& child : scene[kchildren])
+				sum += child.size();
+			keep(sum);
+		}, objects);
+
+		//a reflected item copies the shared children into the patch at the first removal;
+		//then every removal is an erase from the copy
+		const std::vector<utils::keystring> removed(ids.begin(), ids.begin() + ids.size() / 2);
+		benchmarks.measure("reflected/remove_half_children" + size, [&scene, &removed]() {
+			utils::property patch;
+			model::ReflectedItem children(scene[kchildren], patch);
+			for (const utils::keystring& id : removed)
+				children.remove_item(id);
+			keep(patch);
+		}, removed.size());
+	}
+
+	const registration reflected_benchmarks("reflected", [](suite& benchmarks) {
+		for (const std::size_t objects : {1000, 10000})
+			measure_scene(benchmarks, objects);
+	});
+}
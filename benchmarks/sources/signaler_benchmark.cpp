@@ -0,0 +1,60 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+
+#include <pisk/utils/signaler.h>
+
+#include <string>
+#include <vector>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	const registration signaler_benchmarks("signaler", [](suite& benchmarks) {
+		for (const std::size_t subscribers : {1, 8})
+		{
+			const std::string name = "/subscribers_" + std::to_string(subscribers);
+			int sum = 0;
+
+			utils::signaler<int> signaler;
+			std::vector<utils::auto_unsubscriber> subscribtions;
+			for (std::size_t index = 0; index < subscribers; ++index)
+				subscribtions.push_back(signaler.subscribe([&sum](const int value) {
+					sum += value;
+				}));
+			benchmarks.measure("signaler/emit" + name, [&signaler]() {
+				signaler.emit(1);
+			});
+
+			utils::light_signaler<int> light;
+			for (std::size_t index = 0; index < subscribers; ++index)
+				light.subscribe([&sum](const int value) {
+					sum += value;
+				});
+			benchmarks.measure("light_signaler/emit" + name, [&light]() {
+				light.emit(1);
+			});
+			keep(sum);
+		}
+
+		utils::signaler<int> signaler;
+		benchmarks.measure("signaler/subscribe_unsubscribe", [&signaler]() {
+			const auto subscribtion = signaler.subscribe([](const int) {});
+			keep(subscribtion);
+		});
+	});
+}
+
@@ -0,0 +1,120 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include "benchmark.h"
+
+#include <pisk/model/ReflectedItem.h>
+#include <pisk/utils/property_tree.h>
+
+#include <string>
+
+using namespace pisk;
+using namespace pisk::benchmarks;
+
+namespace
+{
+	//"Maybe a number": a half of the values are doubles, the rest are ints and strings
+	utils::property make_values(const std::size_t count)
+	{
+		utils::property out;
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			utils::property& value = out[index];
+			switch (index % 4)
+			{
+				case 0: case 1: value = index * 0.5; break;
+				case 2: value = static_cast<int>(index); break;
+				default: value = "value_" + std::to_string(index); break;
+			}
+		}
+		return out;
+	}
+
+	const registration typed_access_benchmarks("typed_access", [](suite& benchmarks) {
+		const std::size_t count = 1000;
+		const utils::property values = make_values(count);
+		const utils::property& none = utils::property::none_property();
+
+		benchmarks.measure("typed_access/property/is_as", [&values, count]() {
+			double sum = 0;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				const utils::property& value = values[index];
+				if (value.is_double())
+					sum += value.as_double();
+			}
+			keep(sum);
+		}, count);
+		benchmarks.measure("typed_access/property/try_as", [&values, count]() {
+			double sum = 0;
+			for (std::size_t index = 0; index < count; ++index)
+				if (const double* value = values[index].try_as<double>())
+					sum += *value;
+			keep(sum);
+		}, count);
+		benchmarks.measure("typed_access/property/get_or", [&values, count]() {
+			double sum = 0;
+			for (std::size_t index = 0; index < count; ++index)
+				sum += values[index].get_or(0.);
+			keep(sum);
+		}, count);
+		benchmarks.measure("typed_access/property/as_catch", [&values, count]() {
+			double sum = 0;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				try
+				{
+					sum += values[index].as_double();
+				}
+				catch (const utils::PropertyCastException&)
+				{}
+			}
+			keep(sum);
+		}, count);
+
+		//the values are the origin: ReflectedItem checks the change first
+		benchmarks.measure("typed_access/reflected/is_as", [&values, &none, count]() {
+			double sum = 0;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				const model::ConstReflectedItem value(values[index], none);
+				if (value.is_double())
+					sum += value.as_double();
+			}
+			keep(sum);
+		}, count);
+		benchmarks.measure("typed_access/reflected/try_as", [&values, &none, count]() {
+			double sum = 0;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				const model::ConstReflectedItem value(values[index], none);
+				if (const double* number = value.try_as<double>())
+					sum += *number;
+			}
+			keep(sum);
+		}, count);
+		benchmarks.measure("typed_access/reflected/as_catch", [&values, &none, count]() {
+			double sum = 0;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				try
+				{
+					sum += model::ConstReflectedItem(values[index], none).as_double();
+				}
+				catch (const utils::PropertyCastException&)
+				{}
+			}
+			keep(sum);
+		}, count);
+	});
+}
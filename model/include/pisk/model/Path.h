@@ -126,11 +126,6 @@ private:
 	}
 };
 
-inline std::size_t get_to_string_size(const PathId& arg)
-{
-	return arg.to_keystring().size();
-}
-
 inline utils::keystring to_string(const PathId& arg)
 {
 	return arg.to_keystring();
@@ -51,7 +51,7 @@ namespace model
 	public:
 		ReflectedItemBase<cv_property> source()
 		{
-			static const utils::keystring ksource("source");
+			static const utils::keystring ksource = "source"_ks;
 			return this->get_string_item(ksource);
 		}
 		ReflectedItemBase<const cv_property> source() const
@@ -60,7 +60,7 @@ namespace model
 		}
 		ReflectedItemBase<cv_property> type()
 		{
-			static const utils::keystring ktype("type");
+			static const utils::keystring ktype = "type"_ks;
 			return this->get_string_item(ktype);
 		}
 		ReflectedItemBase<const cv_property> type() const
@@ -69,7 +69,7 @@ namespace model
 		}
 		ReflectedItemBase<cv_property> action()
 		{
-			static const utils::keystring kaction("action");
+			static const utils::keystring kaction = "action"_ks;
 			return this->get_string_item(kaction);
 		}
 		ReflectedItemBase<const cv_property> action() const
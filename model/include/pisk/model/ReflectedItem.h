@@ -181,94 +181,66 @@ namespace model
 			return orig.is_array();
 		}
 
+		//the value of the current item (the change or the origin) if it has type T, nullptr otherwise
+		template <typename T>
+		const T* try_as() const noexcept
+		{
+			if (not prop.is_none())
+				return prop.template try_as<T>();
+			return orig.template try_as<T>();
+		}
+		template <typename T>
+		T get_or(const T& fallback) const
+		{
+			if (not prop.is_none())
+				return prop.get_or(fallback);
+			return orig.get_or(fallback);
+		}
+		utils::keystring get_or(const utils::keystring_literal& fallback) const
+		{
+			if (not prop.is_none())
+				return prop.get_or(fallback);
+			return orig.get_or(fallback);
+		}
+		std::string get_or(const std::string& fallback) const
+		{
+			if (not prop.is_none())
+				return prop.get_or(fallback);
+			return orig.get_or(fallback);
+		}
+
 	public:
 		bool operator == (const bool value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_bool())
-					return prop.as_bool() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_bool())
-					return orig.as_bool() == value;
-			}
-			return false;
+			return is_equal_as<bool>(value);
 		}
 		bool operator == (const int value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_int())
-					return prop.as_int() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_int())
-					return orig.as_int() == value;
-			}
-			return false;
+			return is_equal_as<int>(value);
 		}
 		bool operator == (const long value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_long())
-					return prop.as_long() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_long())
-					return orig.as_long() == value;
-			}
-			return false;
+			return is_equal_as<long>(value);
 		}
 		bool operator == (const float value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_float())
-					return prop.as_float() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_float())
-					return orig.as_float() == value;
-			}
-			return false;
+			return is_equal_as<float>(value);
 		}
 		bool operator == (const double value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_double())
-					return prop.as_double() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_double())
-					return orig.as_double() == value;
-			}
-			return false;
+			return is_equal_as<double>(value);
 		}
 		bool operator == (const utils::keystring& value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_string())
-					return prop.as_keystring() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_string())
-					return orig.as_keystring() == value;
-			}
-			return false;
+			return is_equal_as<utils::keystring>(value);
 		}
 		bool operator == (const std::string& value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_string())
-					return prop.as_string() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_string())
-					return orig.as_string() == value;
-			}
-			return false;
+			return is_equal_as<utils::keystring>(value);
 		}
 		bool operator == (const char* value) const
 		{
-			if (not prop.is_none()) {
-				if (prop.is_string())
-					return prop.as_string() == value;
-			} else if (not orig.is_none()) {
-				if (orig.is_string())
-					return orig.as_string() == value;
-			}
-			return false;
+			return is_equal_as<utils::keystring>(value);
 		}
 
 		template <typename Left>
@@ -494,6 +466,13 @@ namespace model
 			return const_ref().template cast<ReflectedItemType>();
 		}
 	protected:
+		template <typename T, typename Value>
+		bool is_equal_as(const Value& value) const
+		{
+			const T* current = try_as<T>();
+			return current != nullptr and *current == value;
+		}
+
 		template <typename CastedType, typename BaseType>
 		static void check_type()
 		{
@@ -32,12 +32,12 @@ namespace io
 	};
 	inline utils::keystring to_keystring(const keyboard_action action)
 	{
-		static const utils::keystring up("released");
-		static const utils::keystring down("pressed");
-		static const utils::keystring short_press("short");
-		static const utils::keystring long_press("long");
-		static const utils::keystring single_press("single");
-		static const utils::keystring double_press("double");
+		static const utils::keystring up = "released"_ks;
+		static const utils::keystring down = "pressed"_ks;
+		static const utils::keystring short_press = "short"_ks;
+		static const utils::keystring long_press = "long"_ks;
+		static const utils::keystring single_press = "single"_ks;
+		static const utils::keystring double_press = "double"_ks;
 		switch (action)
 		{
 			case keyboard_action::released:
@@ -73,12 +73,12 @@ namespace io
 		}
 		static const utils::keystring& key_source()
 		{
-			static const utils::keystring key("keyboard");
+			static const utils::keystring key = "keyboard"_ks;
 			return key;
 		}
 		static const utils::keystring& key_type()
 		{
-			static const utils::keystring key("button");
+			static const utils::keystring key = "button"_ks;
 			return key;
 		}
 
@@ -108,7 +108,7 @@ namespace io
 
 		ReflectedItemBase<cv_property> key()
 		{
-			static const utils::keystring kkey("key");
+			static const utils::keystring kkey = "key"_ks;
 			return this->get_int_item(kkey);
 		}
 		ReflectedItemBase<const cv_property> key() const
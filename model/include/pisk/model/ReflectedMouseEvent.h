@@ -22,7 +22,7 @@ namespace model
 namespace io
 {
 	static inline const utils::keystring& mouse_source() {
-		static const utils::keystring key("mouse");
+		static const utils::keystring key = "mouse"_ks;
 		return key;
 	}
 
@@ -57,25 +57,25 @@ namespace io
 		}
 
 		static const utils::keystring& button_type() {
-			static const utils::keystring key("button");
+			static const utils::keystring key = "button"_ks;
 			return key;
 		}
 		static const utils::keystring& lbutton() {
-			static const utils::keystring key("left");
+			static const utils::keystring key = "left"_ks;
 			return key;
 		}
 		static const utils::keystring& mbutton() {
-			static const utils::keystring key("middle");
+			static const utils::keystring key = "middle"_ks;
 			return key;
 		}
 		static const utils::keystring& rbutton() {
-			static const utils::keystring key("right");
+			static const utils::keystring key = "right"_ks;
 			return key;
 		}
 
 		ReflectedItemBase<cv_property> button()
 		{
-			static const utils::keystring k("button");
+			static const utils::keystring k = "button"_ks;
 			return this->get_int_item(k);
 		}
 		ReflectedItemBase<const cv_property> button() const
@@ -117,21 +117,21 @@ namespace io
 		}
 
 		static const utils::keystring& wheel_type() {
-			static const utils::keystring key("wheel");
+			static const utils::keystring key = "wheel"_ks;
 			return key;
 		}
 		static const utils::keystring& up_wheel() {
-			static const utils::keystring key("up_wheel");
+			static const utils::keystring key = "up_wheel"_ks;
 			return key;
 		}
 		static const utils::keystring& down_wheel() {
-			static const utils::keystring key("down_wheel");
+			static const utils::keystring key = "down_wheel"_ks;
 			return key;
 		}
 
 		ReflectedItemBase<cv_property> wheel()
 		{
-			static const utils::keystring k("wheel");
+			static const utils::keystring k = "wheel"_ks;
 			return this->get_string_item(k);
 		}
 		ReflectedItemBase<const cv_property> wheel() const
@@ -173,13 +173,13 @@ namespace io
 		}
 
 		static const utils::keystring& move_type() {
-			static const utils::keystring key("move");
+			static const utils::keystring key = "move"_ks;
 			return key;
 		}
 
 		ReflectedItemBase<cv_property> x()
 		{
-			static const utils::keystring k("x");
+			static const utils::keystring k = "x"_ks;
 			return this->get_int_item(k);
 		}
 		ReflectedItemBase<const cv_property> x() const
@@ -188,7 +188,7 @@ namespace io
 		}
 		ReflectedItemBase<cv_property> y()
 		{
-			static const utils::keystring k("y");
+			static const utils::keystring k = "y"_ks;
 			return this->get_int_item(k);
 		}
 		ReflectedItemBase<const cv_property> y() const
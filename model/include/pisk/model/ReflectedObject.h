@@ -51,7 +51,7 @@ namespace model
 
 		ReflectedItemBase<cv_property> properties()
 		{
-			static const utils::keystring kproperties("properties");
+			static const utils::keystring kproperties = "properties"_ks;
 			return this->get_dictionary_item(kproperties);
 		}
 		ReflectedItemBase<const cv_property> properties() const
@@ -69,7 +69,7 @@ namespace model
 
 		ReflectedItemBase<cv_property> current_state_id()
 		{
-			static const utils::keystring kstate("state");
+			static const utils::keystring kstate = "state"_ks;
 			return properties().get_string_item(kstate);
 		}
 		ReflectedItemBase<const cv_property> current_state_id() const
@@ -78,7 +78,7 @@ namespace model
 		}
 		ReflectedItemBase<cv_property> id()
 		{
-			static const utils::keystring kid("id");
+			static const utils::keystring kid = "id"_ks;
 			return properties().get_string_item(kid);
 		}
 		ReflectedItemBase<const cv_property> id() const
@@ -88,7 +88,7 @@ namespace model
 
 		ReflectedItemBase<cv_property> enabled()
 		{
-			static const utils::keystring kid("enabled");
+			static const utils::keystring kid = "enabled"_ks;
 			return properties().get_bool_item(kid);
 		}
 		ReflectedItemBase<const cv_property> enabled() const
@@ -98,7 +98,7 @@ namespace model
 
 		ReflectedItemRange<ReflectedItemBase<cv_property>, cv_property> tags()
 		{
-			static const utils::keystring kid("tags");
+			static const utils::keystring kid = "tags"_ks;
 			return ReflectedItemRange<ReflectedItemBase<cv_property>, cv_property>(this->orig[kid], this->prop[kid]);
 		}
 		ReflectedItemRange<ReflectedItemBase<const cv_property>, const cv_property> tags() const
@@ -107,7 +107,7 @@ namespace model
 		}
 		void add_tag(const utils::keystring& name)
 		{
-			static const utils::keystring kid("tags");
+			static const utils::keystring kid = "tags"_ks;
 			auto tags = this->get_array_item(kid);
 			const std::size_t initial_size = tags.size();
 			for (std::size_t index = initial_size-1; index < initial_size; --index)
@@ -117,7 +117,7 @@ namespace model
 		}
 		bool remove_tag(const utils::keystring& tag)
 		{
-			static const utils::keystring kid("tags");
+			static const utils::keystring kid = "tags"_ks;
 			auto tags = this->get_array_item(kid);
 			const std::size_t initial_size = tags.size();
 			for (std::size_t index = initial_size-1; index < initial_size; --index)
@@ -129,7 +129,7 @@ namespace model
 		template <typename Presentation>
 		Presentation presentation(const utils::keystring& id)
 		{
-			static const utils::keystring kpresentations("presentations");
+			static const utils::keystring kpresentations = "presentations"_ks;
 			return this->get_dictionary_item(kpresentations).template get_custom_item<Presentation>(id);
 		}
 		template <typename Presentation>
@@ -177,7 +177,7 @@ namespace model
 		template <typename check_type = cv_property, typename = typename std::enable_if<!std::is_const<check_type>::value>::type>
 		ReflectedObjectBase<cv_property> child(const utils::keystring& id)
 		{
-			static const utils::keystring kchildren("children");
+			static const utils::keystring kchildren = "children"_ks;
 
 			if (id.empty())
 				throw infrastructure::InvalidArgumentException();
@@ -188,7 +188,7 @@ namespace model
 		}
 		ReflectedObjectBase<const cv_property> child(const utils::keystring& id) const
 		{
-			static const utils::keystring kchildren("children");
+			static const utils::keystring kchildren = "children"_ks;
 
 			if (id.empty())
 				throw infrastructure::InvalidArgumentException();
@@ -203,14 +203,14 @@ namespace model
 		}
 		void remove_child(const utils::keystring& id)
 		{
-			static const utils::keystring kchildren("children");
+			static const utils::keystring kchildren = "children"_ks;
 			if (this->orig[kchildren].contains(id) or this->prop[kchildren].contains(id))
 				this->prop[kchildren][id].clear();
 		}
 
 		ReflectedItemRange<ReflectedObjectBase<cv_property>, cv_property> children()
 		{
-			static const utils::keystring kchildren("children");
+			static const utils::keystring kchildren = "children"_ks;
 			return ReflectedItemRange<ReflectedObjectBase<cv_property>, cv_property>(this->orig[kchildren], this->prop[kchildren]);
 		}
 		ReflectedItemRange<ReflectedObjectBase<const cv_property>, const cv_property> children() const
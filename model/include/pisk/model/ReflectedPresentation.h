@@ -39,7 +39,7 @@ namespace model
 
 		ReflectedItemBase<cv_property> properties()
 		{
-			static const utils::keystring kproperties("properties");
+			static const utils::keystring kproperties = "properties"_ks;
 			return this->get_dictionary_item(kproperties);
 		}
 		ReflectedItemBase<const cv_property> properties() const
@@ -50,7 +50,7 @@ namespace model
 		template <typename State>
 		State state(const utils::keystring& id)
 		{
-			static const utils::keystring kstates("states");
+			static const utils::keystring kstates = "states"_ks;
 			return this->get_dictionary_item(kstates).template get_custom_item<State>(id);
 		}
 		template <typename State>
@@ -62,7 +62,7 @@ namespace model
 		template <typename State>
 		ReflectedItemRange<State, cv_property> states()
 		{
-			static const utils::keystring kstates("states");
+			static const utils::keystring kstates = "states"_ks;
 			return ReflectedItemRange<State, cv_property>(this->orig[kstates], this->prop[kstates]);
 		}
 		template <typename State>
@@ -43,7 +43,7 @@ namespace model
 		{
 			this->template check_type<ReflectedEventType, ReflectedEventBase<cv_property>>();
 
-			static const utils::keystring kevents("events");
+			static const utils::keystring kevents = "events"_ks;
 			const std::size_t newindex = this->prop[kevents].size();
 			const std::size_t orig_events_count = this->orig[kevents].size();
 			if (newindex < orig_events_count)
@@ -52,7 +52,7 @@ namespace model
 		}
 		ReflectedItemRange<ReflectedEventBase<cv_property>, cv_property> events()
 		{
-			static const utils::keystring kevents("events");
+			static const utils::keystring kevents = "events"_ks;
 			return ReflectedItemRange<ReflectedEventBase<cv_property>, cv_property>(this->orig[kevents], this->prop[kevents]);
 		}
 		ReflectedItemRange<ReflectedEventBase<const cv_property>, const cv_property> events() const
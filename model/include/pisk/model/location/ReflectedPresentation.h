@@ -40,7 +40,7 @@ namespace location
 
 		ReflectedItemBase<cv_property> x()
 		{
-			static const utils::keystring kid("x");
+			static const utils::keystring kid = "x"_ks;
 			return this->get_double_item(kid);
 		}
 		ReflectedItemBase<const cv_property> x() const
@@ -49,7 +49,7 @@ namespace location
 		}
 		ReflectedItemBase<cv_property> y()
 		{
-			static const utils::keystring kid("y");
+			static const utils::keystring kid = "y"_ks;
 			return this->get_double_item(kid);
 		}
 		ReflectedItemBase<const cv_property> y() const
@@ -58,7 +58,7 @@ namespace location
 		}
 		ReflectedItemBase<cv_property> z()
 		{
-			static const utils::keystring kid("z");
+			static const utils::keystring kid = "z"_ks;
 			return this->get_double_item(kid);
 		}
 		ReflectedItemBase<const cv_property> z() const
@@ -88,7 +88,7 @@ namespace location
 
 		ReflectedItemBase<cv_property> w()
 		{
-			static const utils::keystring kid("w");
+			static const utils::keystring kid = "w"_ks;
 			return this->get_double_item(kid);
 		}
 		ReflectedItemBase<const cv_property> w() const
@@ -130,7 +130,7 @@ namespace location
 
 		PositionPresentationBase<cv_property> position()
 		{
-			static const utils::keystring kid("position");
+			static const utils::keystring kid = "position"_ks;
 			return this->properties().template get_custom_item<PositionPresentationBase<cv_property>>(kid);
 		}
 		PositionPresentationBase<const cv_property> position() const
@@ -140,7 +140,7 @@ namespace location
 
 		QuaternionPresentationBase<cv_property> quaternion()
 		{
-			static const utils::keystring kid("quaternion");
+			static const utils::keystring kid = "quaternion"_ks;
 			return this->properties().template get_custom_item<QuaternionPresentationBase<cv_property>>(kid);
 		}
 		QuaternionPresentationBase<const cv_property> quaternion() const
@@ -150,7 +150,7 @@ namespace location
 
 		ScalePresentationBase<cv_property> scale()
 		{
-			static const utils::keystring kid("scale");
+			static const utils::keystring kid = "scale"_ks;
 			return this->properties().template get_custom_item<ScalePresentationBase<cv_property>>(kid);
 		}
 		ScalePresentationBase<const cv_property> scale() const
@@ -47,6 +47,14 @@ Describe(TestReflectedItem) {
 		AssertThrowsEx(PropertyCastException, item.as_int());
 		AssertThrowsEx(PropertyCastException, item.as_string());
 	}
+	Spec(item_try_as_returns_nullptr) {
+		Assert::That(item.try_as<int>() == nullptr, Is().EqualTo(true));
+		Assert::That(item.try_as<keystring>() == nullptr, Is().EqualTo(true));
+	}
+	Spec(item_get_or_returns_fallback) {
+		Assert::That(item.get_or(7), Is().EqualTo(7));
+		Assert::That(item.get_or("none"), Is().EqualTo("none"));
+	}
 	Spec(item_not_eq_to_int) {
 		Assert::That(item == 2, Is().EqualTo(false));
 	}
@@ -72,6 +80,11 @@ Describe(TestReflectedItem) {
 			Assert::That(Root().item.get_int_item("asd"), Is().EqualTo(15));
 			Assert::That(Root().item.get_string_item("qwe"), Is().EqualTo("zxc"));
 		}
+		Then(typed_access_reads_origin) {
+			Assert::That(*Root().item.get_item("asd").try_as<int>(), Is().EqualTo(15));
+			Assert::That(Root().item.get_item("asd").try_as<keystring>() == nullptr, Is().EqualTo(true));
+			Assert::That(Root().item.get_item("qwe").get_or("none"), Is().EqualTo("zxc"));
+		}
 		When(change_item) {
 			void SetUp() {
 				Root().item.get_int_item("asd") = "rty";
@@ -81,6 +94,11 @@ Describe(TestReflectedItem) {
 				Assert::That(Root().item.get_string_item("asd"), Is().EqualTo("rty"));
 				Assert::That(Root().item.get_string_item("qwe"), Is().EqualTo("zxc"));
 			}
+			Then(typed_access_reads_change) {
+				Assert::That(Root().item.get_item("asd").try_as<int>() == nullptr, Is().EqualTo(true));
+				Assert::That(Root().item.get_item("asd").get_or(0), Is().EqualTo(0));
+				Assert::That(*Root().item.get_item("asd").try_as<keystring>(), Is().EqualTo(keystring("rty")));
+			}
 			Then(item_has_origin) {
 				Assert::That(Root().item.has_origin(), Is().EqualTo(true));
 			}
@@ -612,7 +630,7 @@ Describe(TestReflectedItem) {
 			Then(check_members) {
 				ReflectedItem edit{Root().orig, Root().diff};
 				const auto& members = edit.get_dictionary_item("dict").get_members();
-				Assert::That(members, Is().EqualTo(std::vector<keystring>{"cxz", "zxc"}));
+				Assert::That(members, Is().EqualTo(std::vector<keystring>{"zxc", "cxz"}));
 			}
 		};
 		When(prop_is_none_and_orig_is_dict) {
@@ -631,7 +649,7 @@ Describe(TestReflectedItem) {
 			Then(check_members) {
 				ReflectedItem edit{Root().orig, Root().diff};
 				const auto& members = edit.get_dictionary_item("dict").get_members();
-				Assert::That(members, Is().EqualTo(std::vector<keystring>{"cxz", "zxc"}));
+				Assert::That(members, Is().EqualTo(std::vector<keystring>{"zxc", "cxz"}));
 			}
 		};
 		When(prop_is_array_and_orig_is_dictionary) {
@@ -40,7 +40,7 @@ namespace audio
 
 		ReflectedItemBase<cv_property> res_id()
 		{
-			static const utils::keystring kresid("res_id");
+			static const utils::keystring kresid = "res_id"_ks;
 			return this->get_string_item(kresid);
 		}
 		ReflectedItemBase<const cv_property> res_id() const
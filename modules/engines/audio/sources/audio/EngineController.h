@@ -14,6 +14,7 @@
 #pragma once
 
 #include <pisk/utils/signaler.h>
+#include <pisk/tools/ParallelReplace.h>
 
 #include <pisk/model/Path.h>
 #include <pisk/model/ReflectedScene.h>
@@ -55,7 +56,7 @@ namespace audio
 
 			model::ConstReflectedScene scene_object(scene, *patch);
 			walk(scene_object, {});
-			utils::property::replace(scene, *patch);
+			tools::replace_parallel(scene, *patch);
 		}
 
 		void update()
@@ -72,7 +73,7 @@ namespace audio
 		void walk(model::ConstReflectedObject& object, const model::PathId& id_path)
 		try
 		{
-			const utils::keystring& obj_id = object.id().is_string() ? object.id().as_keystring() : "";
+			const utils::keystring& obj_id = object.id().get_or(utils::keystring());
 			const auto& obj_id_path = id_path.add(obj_id);
 			process_object(object, obj_id_path);
 			if (object.children().has_changes())
@@ -111,14 +112,14 @@ namespace audio
 			else
 				logger::debug("audio", "Receive new object '{}' with initial state: '{}'", id_path, state_id.as_keystring());
 
-			const auto& resource_id = presentation.state(state_id.as_keystring()).res_id();
-			if (resource_id.is_none())
+			const utils::keystring* resource_id = presentation.state(state_id.as_keystring()).res_id().try_as<utils::keystring>();
+			if (resource_id == nullptr)
 			{
 				logger::debug("audio", "State '{}' does not contains res_id (object: '{}')", state_id.as_keystring(), id_path);
 				audio_engine.stop(id_path);
 				return;
 			}
-			audio_engine.play(id_path, resource_id.as_keystring());
+			audio_engine.play(id_path, *resource_id);
 		}
 		void on_remove(const model::PathId& id_path)
 		{
@@ -31,7 +31,9 @@ namespace audio
 
 		virtual Configure on_init_app() final override
 		{
-			return {};
+			Configure configure;
+			configure.scheduling = Configure::Scheduling::OnEvent;
+			return configure;
 		}
 
 		virtual void on_deinit_app() final override
@@ -91,8 +93,13 @@ namespace audio
 		}
 		void push(const pisk::system::PatchPtr& patch) noexcept threadsafe
 		{
-			const auto& content = pisk::utils::json::to_string(*patch);
-			pisk::logger::debug("audio", "Update scene:\n {}", content);
+			if (auto&& log = pisk::logger::debug("audio"))
+			{
+				static thread_local std::string content;
+				content.clear();
+				pisk::utils::json::write(*patch, content);
+				log.print("Update scene:\n {}", content);
+			}
 
 			push_changes(patch);
 		}
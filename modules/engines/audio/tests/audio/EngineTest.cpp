@@ -31,6 +31,10 @@ class TestPatchRecipient :
 	{
 		_last_patch = patch;
 	}
+	virtual void post(pisk::system::EngineTaskHandle&& task) noexcept threadsafe
+	{
+		task();
+	}
 public:
 	PatchPtr last_patch() const
 	{
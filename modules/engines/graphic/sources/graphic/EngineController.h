@@ -14,6 +14,7 @@
 #pragma once
 
 #include <pisk/utils/noncopyable.h>
+#include <pisk/tools/ParallelReplace.h>
 
 #include <pisk/os/WindowManager.h>
 
@@ -144,7 +145,7 @@ namespace graphic
 
 			model::ConstReflectedScene scene_object(scene, *patch);
 			update_scene(scene_object);
-			utils::property::replace(scene, *patch);
+			tools::replace_parallel(scene, *patch);
 		}
 
 	private:
@@ -173,7 +174,7 @@ namespace graphic
 		void walk(model::ConstReflectedObject& object, const model::PathId& id_path)
 		try
 		{
-			const utils::keystring& obj_id = object.id().is_string() ? object.id().as_keystring() : "";
+			const utils::keystring& obj_id = object.id().get_or(utils::keystring());
 			const auto& obj_id_path = id_path.add(obj_id);
 			process_object(object, obj_id_path);
 			if (object.children().has_changes())
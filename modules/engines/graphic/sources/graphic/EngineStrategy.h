@@ -123,8 +123,13 @@ namespace graphic
 		}
 		void push(const pisk::system::PatchPtr& patch) noexcept threadsafe
 		{
-			const auto& content = pisk::utils::json::to_string(*patch);
-			pisk::logger::debug("graphic", "Update scene:\n {}", content.c_str());
+			if (auto&& log = pisk::logger::debug("graphic"))
+			{
+				static thread_local std::string content;
+				content.clear();
+				pisk::utils::json::write(*patch, content);
+				log.print("Update scene:\n {}", content.c_str());
+			}
 
 			push_changes(patch);
 		}
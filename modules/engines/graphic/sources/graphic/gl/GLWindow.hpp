@@ -228,13 +228,15 @@ namespace graphic
 		virtual void on_detach_window(const TWindowPtr& wnd) = 0;
 
 	public:
-		void call_from_engine_thread_sync(std::function<void ()> handle)
+		template <typename Callee>
+		void call_from_engine_thread_sync(Callee&& handle)
 		{
-			tasks.push_remote_task_sync(handle);
+			tasks.push_remote_task_sync(std::forward<Callee>(handle));
 		}
-		void call_from_engine_thread_async(std::function<void ()> handle)
+		template <typename Callee>
+		void call_from_engine_thread_async(Callee&& handle)
 		{
-			tasks.push_remote_task_async(handle);
+			tasks.post_remote_task(std::forward<Callee>(handle));
 		}
 	};
 }//namespace graphic
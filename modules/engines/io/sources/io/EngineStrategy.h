@@ -100,7 +100,7 @@ namespace io
 			subscriptions.emplace_back(mouse->up.subscribe([this](const Mouse::ButtonType& button_type) {
 				pisk::logger::debug("io", "Mouse button released: {}", button_type);
 
-				static const utils::keystring pressed("pressed");
+				static const utils::keystring pressed = "pressed"_ks;
 				system::Patch patch;
 				model::io::ReflectedMouseButtonEvent event(utils::property::none_property(), patch);
 				event.action() = pressed;
@@ -110,7 +110,7 @@ namespace io
 			subscriptions.emplace_back(mouse->down.subscribe([this](const Mouse::ButtonType& button_type) {
 				pisk::logger::debug("io", "Mouse button pressed: {}", button_type);
 
-				static const utils::keystring released("released");
+				static const utils::keystring released = "released"_ks;
 				system::Patch patch;
 				model::io::ReflectedMouseButtonEvent event(utils::property::none_property(), patch);
 				event.action() = released;
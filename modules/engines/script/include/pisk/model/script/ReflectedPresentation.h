@@ -40,7 +40,7 @@ namespace script
 
 		ReflectedItemBase<cv_property> res_id()
 		{
-			static const utils::keystring kresid("res_id");
+			static const utils::keystring kresid = "res_id"_ks;
 			return this->get_string_item(kresid);
 		}
 		ReflectedItemBase<const cv_property> res_id() const
@@ -50,7 +50,7 @@ namespace script
 
 		ReflectedItemBase<cv_property> function()
 		{
-			static const utils::keystring kfunction("function");
+			static const utils::keystring kfunction = "function"_ks;
 			return this->get_string_item(kfunction);
 		}
 		ReflectedItemBase<const cv_property> function() const
@@ -60,7 +60,7 @@ namespace script
 
 		ReflectedItemBase<cv_property> arguments()
 		{
-			static const utils::keystring karguments("arguments");
+			static const utils::keystring karguments = "arguments"_ks;
 			return this->get_item(karguments);
 		}
 		ReflectedItemBase<const cv_property> arguments() const
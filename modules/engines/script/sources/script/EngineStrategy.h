@@ -48,7 +48,9 @@ namespace script
 		virtual Configure on_init_app() override
 		{
 			execute("script", "init", {config});
-			return {};
+			Configure configure;
+			configure.scheduling = Configure::Scheduling::OnEvent;
+			return configure;
 		}
 
 		virtual void on_deinit_app() override
@@ -79,7 +81,7 @@ namespace script
 		void walk(model::ConstReflectedObject& object, const model::PathId& id_path)
 		try
 		{
-			const utils::keystring& obj_id = object.id().is_string() ? object.id().as_keystring() : "";
+			const utils::keystring& obj_id = object.id().get_or(utils::keystring());
 			const auto& obj_id_path = id_path.add(obj_id);
 			process_object(object, obj_id_path);
 			if (object.children().has_changes())
@@ -114,15 +116,16 @@ namespace script
 			else
 				logger::debug("script", "Receive new object '{}' with initial state: '{}'", id_path, state_id.as_keystring());
 
-			const auto& resource_id = presentation.state(state_id.as_keystring()).res_id();
-			const auto& function = presentation.state(state_id.as_keystring()).function();
-			const auto& arguments = presentation.state(state_id.as_keystring()).arguments();
-			if (not (resource_id.is_string() and function.is_string() and arguments.is_array()))
+			const auto& state = presentation.state(state_id.as_keystring());
+			const utils::keystring* resource_id = state.res_id().try_as<utils::keystring>();
+			const utils::keystring* function = state.function().try_as<utils::keystring>();
+			const auto& arguments = state.arguments();
+			if (resource_id == nullptr or function == nullptr or not arguments.is_array())
 			{
 				logger::warning("script", "State '{}' has not requred params or them has incorrect types (object: '{}')", state_id.as_keystring(), id_path);
 				return;
 			}
-			execute(resource_id.as_keystring(), function.as_keystring(), to_arguments(arguments));
+			execute(*resource_id, *function, to_arguments(arguments));
 		}
 
 	protected:
@@ -130,12 +133,12 @@ namespace script
 		{
 			if (item.is_none())
 				return {};
-			if (item.is_bool())
-				return { item.as_bool() };
-			if (item.is_int())
-				return { item.as_int() };
-			if (item.is_string())
-				return { item.as_keystring() };
+			if (const bool* value = item.try_as<bool>())
+				return { *value };
+			if (const int* value = item.try_as<int>())
+				return { *value };
+			if (const utils::keystring* value = item.try_as<utils::keystring>())
+				return { *value };
 			if (item.is_array())
 			{
 				const std::size_t count = item.size();
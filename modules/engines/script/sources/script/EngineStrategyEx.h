@@ -144,6 +144,7 @@ namespace script
 		public BaseStrategy
 	{
 		const utils::keystring log_member {"log"};
+		std::string log_buffer;
 
 	public:
 		template <typename ... TArgs>
@@ -180,14 +181,19 @@ namespace script
 				logger::error("script", "Unexpected count of arguments for 'log' external function");
 				return {};
 			}
-			if (not arguments[0].is_string())
+			const utils::keystring* level = arguments[0].try_as<utils::keystring>();
+			if (level == nullptr)
 			{
 				logger::error("script", "Unexpected arguments for 'log' external function");
 				return {};
 			}
 
-			const infrastructure::Logger::Level loglevel = arg_to_loglevel(arguments[0].as_keystring());
-			logger::log(loglevel, "script log", utils::json::to_string(arguments[1]));
+			const infrastructure::Logger::Level loglevel = arg_to_loglevel(*level);
+			if (logger::is_level_filtered(loglevel))
+				return {};
+			log_buffer.clear();
+			utils::json::write(arguments[1], log_buffer);
+			logger::log(loglevel, "script log", log_buffer);
 			return {};
 		}
 		static infrastructure::Logger::Level arg_to_loglevel(const utils::keystring& loglevel)
@@ -255,18 +261,20 @@ namespace script
 				logger::error("script", "Unexpected count of arguments for external function '{}'", signature);
 				return {};
 			}
-			if (not arguments[0].is_string())
+			const utils::keystring* path_to_scene = arguments[0].try_as<utils::keystring>();
+			if (path_to_scene == nullptr)
 			{
 				logger::error("script", "Unexpected 1st argument for external function '{}'", signature);
 				return {};
 			}
-			if (not arguments[1].is_bool())
+			const bool* clear_all = arguments[1].try_as<bool>();
+			if (clear_all == nullptr)
 			{
 				logger::error("script", "Unexpected 2nd argument for external function '{}'", signature);
 				return {};
 			}
 
-			this->load_scene(arguments[0].as_keystring(), arguments[1].as_bool());
+			this->load_scene(*path_to_scene, *clear_all);
 
 			return {};
 		}
@@ -38,6 +38,7 @@ namespace script
 
 		system::ResourceManagerPtr resource_manager;
 		Scripts scripts;
+		std::string log_buffer;
 
 	public:
 		explicit ScriptManager(const system::ResourceManagerPtr& _resource_manager) :
@@ -52,7 +53,8 @@ namespace script
 		bool execute(const utils::keystring& resource_id, const utils::keystring& function, const Arguments& arguments)
 		try
 		{
-			logger::spam("script", "Execute {}:{}({})", resource_id.c_str(), function, to_string(arguments));
+			if (auto&& log = logger::spam("script"))
+				log.print("Execute {}:{}({})", resource_id.c_str(), function, to_string(arguments));
 			auto found = scripts.find(resource_id);
 			if (found == scripts.end())
 			{
@@ -61,7 +63,8 @@ namespace script
 				found = scripts.find(resource_id);
 			}
 			const auto& results = found->second->execute(function, arguments);
-			logger::spam("script", "Script executed with results: {}", to_string(results));
+			if (auto&& log = logger::spam("script"))
+				log.print("Script executed with results: {}", to_string(results));
 			return true;
 		}
 		catch(const ScriptException& ex)
@@ -103,16 +106,18 @@ namespace script
 		}
 
 	private:
-		static std::string to_string(const Arguments& args)
+		//the text is written into one buffer which is reused by the next call
+		const std::string& to_string(const Arguments& args)
 		{
-			std::vector<std::string> arg_strings;
-			std::transform(
-				args.begin(),
-				args.end(),
-				std::back_inserter(arg_strings),
-				std::bind(&utils::json::to_string, std::placeholders::_1)
-			);
-			return '[' + utils::algorithm::join(arg_strings, std::string(",")) + ']';
+			log_buffer.assign(1, '[');
+			for (std::size_t index = 0; index < args.size(); ++index)
+			{
+				if (index != 0)
+					log_buffer.push_back(',');
+				utils::json::write(args[index], log_buffer);
+			}
+			log_buffer.push_back(']');
+			return log_buffer;
 		}
 
 		bool load(const utils::keystring& resource_id)
@@ -126,12 +126,13 @@ namespace script
 				return {service->help()};
 			else
 			{
-				if (not arguments[0].is_string())
+				const utils::keystring* function = arguments[0].try_as<utils::keystring>();
+				if (function == nullptr)
 				{
 					logger::error("script", "Unexpected arguments for 'help' external function");
 					return {};
 				}
-				return {service->help(arguments[0].as_keystring())};
+				return {service->help(*function)};
 			}
 		}
 
@@ -142,16 +143,21 @@ namespace script
 				logger::error("script", "Unexpected count of arguments for 'subscribe' external function");
 				return {};
 			}
-			if (not arguments[0].is_string() and not arguments[1].is_string())
+			const utils::keystring* eventname = arguments[0].try_as<utils::keystring>();
+			const utils::keystring* callback = arguments[1].try_as<utils::keystring>();
+			if (eventname == nullptr or callback == nullptr)
 			{
 				logger::error("script", "Unexpected arguments for 'subscribe' external function");
 				return {};
 			}
-			utils::keystring callbackname = arguments[1].as_keystring();
+			utils::keystring callbackname = *callback;
 			pisk::utils::auto_unsubscriber subscription = service->subscribe(
-				arguments[0].as_keystring(),
+				*eventname,
 				[this, callbackname](Arguments arguments) -> void {
-					this->execute("script", callbackname.c_str(), arguments);
+					//the signal comes from a thread of the service: the script is called by the engine thread
+					this->post_task([this, callbackname, arguments]() {
+						this->execute("script", callbackname.c_str(), arguments);
+					});
 				}
 			);
 			subscriptions.push_back(subscription);
@@ -32,6 +32,10 @@ extern "C"
 #	define LUA_OK 0
 #endif
 
+#if LUA_VERSION_NUM >= 502
+#	define lua_objlen lua_rawlen
+#endif
+
 namespace pisk
 {
 namespace script
@@ -337,26 +341,26 @@ namespace loaders
 					lua_pushnil(state);
 					break;
 				case utils::property::type::_bool:
-					lua_pushboolean(state, static_cast<int>(arg.as_bool()));
+					lua_pushboolean(state, static_cast<int>(arg.get_or(false)));
 					break;
 				case utils::property::type::_int:
-					lua_pushinteger(state, static_cast<int>(arg.as_int()));
+					lua_pushinteger(state, static_cast<int>(arg.get_or(0)));
 					break;
 				case utils::property::type::_long:
-					lua_pushinteger(state, static_cast<int>(arg.as_long()));
+					lua_pushinteger(state, static_cast<int>(arg.get_or(0l)));
 					break;
 				case utils::property::type::_float:
-					lua_pushnumber(state, static_cast<double>(arg.as_float()));
+					lua_pushnumber(state, static_cast<double>(arg.get_or(0.f)));
 					break;
 				case utils::property::type::_double:
-					lua_pushnumber(state, static_cast<double>(arg.as_double()));
+					lua_pushnumber(state, static_cast<double>(arg.get_or(0.)));
 					break;
 				case utils::property::type::_string:
-					lua_pushstring(state, arg.as_keystring().c_str());
+					lua_pushstring(state, arg.try_as<utils::keystring>()->c_str());
 					break;
 				case utils::property::type::_dictionary:
 					{
-						lua_newtable(state);
+						lua_createtable(state, 0, static_cast<int>(arg.size()));
 						const int top = lua_gettop(state);
 						for (auto it = arg.begin(); it != arg.end(); ++it)
 						{
@@ -368,13 +372,12 @@ namespace loaders
 					break;
 				case utils::property::type::_array:
 					{
-						lua_newtable(state);
+						lua_createtable(state, static_cast<int>(arg.size()), 0);
 						const int top = lua_gettop(state);
-						for (std::size_t index = 0; index < arg.size(); ++index)
+						for (auto it = arg.begin(); it != arg.end(); ++it)
 						{
-							lua_pushinteger(state, static_cast<int>(1+index));
-							push_argument(arg[index]);
-							lua_settable(state, top);
+							push_argument(*it);
+							lua_rawseti(state, top, static_cast<int>(1 + it.get_index()));
 						}
 					}
 					break;
@@ -409,29 +412,44 @@ namespace loaders
 					out = lua_tostring(state, -1);
 					break;
 				case LUA_TTABLE:
-					lua_pushnil(state);
-					while (lua_next(state, -2) != 0)
 					{
-						if (lua_isnumber(state, -2))
+						//the sequence part is read by index into a preallocated array; lua_next visits it again, so it is skipped there
+						const std::size_t length = lua_objlen(state, -1);
+						if (length > 0)
 						{
-							const auto& key = static_cast<std::ptrdiff_t>(lua_tointeger(state, -2));
-							if (key > 0)
-								out[key-1] = pop_result();
-							else
+							out.reserve(length);
+							for (std::size_t index = 1; index <= length; ++index)
 							{
-								logger::warning("lua", "Lua array keys starts from 1. Skip it");
-								pop_result();
+								lua_rawgeti(state, -1, static_cast<int>(index));
+								out.push_back(pop_result());
 							}
 						}
-						else if (lua_isstring(state, -2))
+						lua_pushnil(state);
+						while (lua_next(state, -2) != 0)
 						{
-							const utils::keystring key {lua_tostring(state, -2)};
-							out[key] = pop_result();
-						}
-						else
-						{
-							logger::warning("lua", "Unsupported lua type detected for key of table: {}", lua_type(state, -2));
-							lua_pop(state, 1);
+							if (lua_isnumber(state, -2))
+							{
+								const auto& key = static_cast<std::ptrdiff_t>(lua_tointeger(state, -2));
+								if (key > 0 and static_cast<std::size_t>(key) <= length and is_sequence_key(key))
+									lua_pop(state, 1);
+								else if (key > 0)
+									out[key-1] = pop_result();
+								else
+								{
+									logger::warning("lua", "Lua array keys starts from 1. Skip it");
+									pop_result();
+								}
+							}
+							else if (lua_isstring(state, -2))
+							{
+								const utils::keystring key {lua_tostring(state, -2)};
+								out[key] = pop_result();
+							}
+							else
+							{
+								logger::warning("lua", "Unsupported lua type detected for key of table: {}", lua_type(state, -2));
+								lua_pop(state, 1);
+							}
 						}
 					}
 					break;
@@ -443,6 +461,12 @@ namespace loaders
 			return out;
 		}
 
+		//a key on the stack (under the value) which is an integral number, not a numeric string
+		bool is_sequence_key(const std::ptrdiff_t key) const
+		{
+			return lua_type(state, -2) == LUA_TNUMBER and lua_tonumber(state, -2) == static_cast<lua_Number>(key);
+		}
+
 		static ScriptException::ErrorFamily to_error(const int lua_error)
 		{
 			switch (lua_error)
@@ -21,8 +21,11 @@
 
 #include <pisk/http/Service.h>
 
+#include <pisk/tools/ThreadPool.h>
+
 #include <chrono>
-#include <thread>
+#include <memory>
+#include <mutex>
 
 #include "ServiceImpl.h"
 
@@ -37,11 +40,24 @@ namespace googleapi
 	class ProviderByIP :
 		public GeolocationProvider
 	{
+		//Steps of the locating are the timers of the pool: the session outlives the provider in them,
+		//so a stopped session is marked by the null owner and its steps do nothing
+		struct session
+		{
+			std::mutex guard;
+			ProviderByIP* owner;
+		};
+		using SessionPtr = std::shared_ptr<session>;
+
+		const std::chrono::milliseconds response_poll_period {100};
+		const std::chrono::seconds update_period {60};
+
 		pisk::services::http::ServicePtr http_service;
 		const http::URL request_url;
 
-		std::unique_ptr<std::thread> worker;
-		bool stop_flag = false;
+		SessionPtr current_session;
+		//is touched by the steps of the session under its guard
+		std::future<http::Response> request;
 	public:
 		ProviderByIP(const pisk::services::http::ServicePtr& http_service, const pisk::utils::property& config) :
 			http_service(http_service),
@@ -55,69 +71,79 @@ namespace googleapi
 
 		virtual bool start_locate() final override
 		{
-			if (worker != nullptr)
+			if (current_session != nullptr)
 				return false;
-			reset_stop_flag();
-			worker = std::make_unique<std::thread>(std::bind(&ProviderByIP::run, this));
+			current_session = std::make_shared<session>();
+			current_session->owner = this;
+			const SessionPtr started = current_session;
+			tools::ThreadPool::shared().post([started]() {
+				locate(started);
+			}, tools::ThreadPool::Priority::Low);
 			return true;
 		}
 
 		virtual bool stop_locate() final override
 		{
-			if (worker == nullptr)
+			if (current_session == nullptr)
 				return false;
-			set_stop_flag();
-			worker->join();
-			worker.reset();
+			{
+				//waits for the running step
+				std::unique_lock<std::mutex> lock(current_session->guard);
+				current_session->owner = nullptr;
+				request = std::future<http::Response>();
+			}
+			current_session.reset();
 			return true;
 		}
 
 	private:
 		static http::URL get_request_url(const pisk::utils::property& config)
 		{
-			if (not config["IP"]["URL"].is_string())
+			const utils::keystring* url = config["IP"]["URL"].try_as<utils::keystring>();
+			if (url == nullptr)
 			{
 				pisk::logger::warning("script", "'IP/URL' key not found in the config ");
 				throw infrastructure::InvalidArgumentException();
 			}
-			const auto& url = config["IP"]["URL"].as_keystring();
-			if (url.empty())
+			if (url->empty())
 			{
 				pisk::logger::error("script", "Value 'IP/URL' is empty");
 				throw infrastructure::InvalidArgumentException();
 			}
-			return http::to_url(url);
+			return http::to_url(*url);
 		}
-		void run()
+		static void locate(const SessionPtr& current)
 		{
-			do
-			{
-				auto request = request_update_location();
-				while (request.wait_for(std::chrono::milliseconds{100}) != std::future_status::ready)
-					if (is_stopped())
-						return;
-				const http::Response& response = request.get();
-				on_response(response);
-			}
-			while(wait_for_stop(60) == false);
+			std::unique_lock<std::mutex> lock(current->guard);
+			if (current->owner != nullptr)
+				current->owner->update_location(current);
+		}
+		static void schedule(const SessionPtr& current, const tools::ThreadPool::Clock::duration delay)
+		{
+			tools::ThreadPool::shared().post_after(delay, [current]() {
+				locate(current);
+			}, tools::ThreadPool::Priority::Low);
 		}
-		bool wait_for_stop(const std::size_t seconds)
+		void update_location(const SessionPtr& current)
 		{
-			for (std::size_t index = 0; index < 10 * seconds; ++index)
+			if (not request.valid())
+				request = request_update_location();
+			if (request.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
 			{
-				if (is_stopped())
-					return true;
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				schedule(current, response_poll_period);
+				return;
 			}
-			return false;
+			const http::Response& response = request.get();
+			on_response(response);
+			schedule(current, update_period);
 		}
 		std::future<http::Response> request_update_location()
 		{
 			const http::Headers headers {
 				"Content-Type: application/json",
 			};
-			const std::string geolocation_request = utils::json::to_string(get_detect_info());
-			const infrastructure::DataBuffer body {geolocation_request.begin(), geolocation_request.end()};
+			infrastructure::DataBuffer body;
+			utils::json::write(get_detect_info(), body);
 
 			return http_service->request(http::Request {request_url, headers, body, http::Method::POST, nullptr});
 		}
@@ -146,8 +172,9 @@ namespace googleapi
 				error.provider = Provider::IP;
 				error.domain = Error::Domain::Http;
 				error.code = static_cast<int>(response.status_code);
-				if (resp["error"]["message"].is_string())
-					error.msg = resp["error"]["message"].as_keystring();
+				const utils::keystring* message = resp["error"]["message"].try_as<utils::keystring>();
+				if (message != nullptr)
+					error.msg = *message;
 				else
 					error.msg = response.headers[0];
 				this->on_update_error.emit(error);
@@ -201,20 +228,6 @@ namespace googleapi
 			out["wifiAccessPoints"] = utils::property::array();
 			return out;
 		}
-
-	private:
-		void reset_stop_flag()
-		{
-			stop_flag = false;
-		}
-		void set_stop_flag()
-		{
-			stop_flag = true;
-		}
-		bool is_stopped() const
-		{
-			return stop_flag;
-		}
 	};
 }//namespace googleapi
 
@@ -216,12 +216,13 @@ namespace geolocation
 				logger::error("script2go", "Unexpected count of arguments for 'enable_provider/disable_provider' external function");
 				throw infrastructure::InvalidArgumentException();
 			}
-			if (not arguments[0].is_string())
+			const utils::keystring* provider_name = arguments[0].try_as<utils::keystring>();
+			if (provider_name == nullptr)
 			{
 				logger::error("script2go", "Unexpected argument type at 'enable_provider/disable_provider' external function");
 				throw infrastructure::InvalidArgumentException();
 			}
-			const auto& provider = to_provider(arguments[0].as_keystring());
+			const auto& provider = to_provider(*provider_name);
 			const bool result = enable
 						? service->enable_provider(provider)
 						: service->disable_provider(provider);
@@ -245,12 +246,13 @@ namespace geolocation
 				logger::error("script2go", "Unexpected count of arguments for 'get_available_providers' external function");
 				throw infrastructure::InvalidArgumentException();
 			}
-			if (not arguments[0].is_string())
+			const utils::keystring* provider_name = arguments[0].try_as<utils::keystring>();
+			if (provider_name == nullptr)
 			{
 				logger::error("script2go", "Unexpected argument type at 'get_error' external function");
 				throw infrastructure::InvalidArgumentException();
 			}
-			const auto& provider = to_provider(arguments[0].as_keystring());
+			const auto& provider = to_provider(*provider_name);
 			const auto& error = service->get_error(provider);
 			return { to_property(error) };
 		}
@@ -105,6 +105,9 @@ namespace http
 
 		virtual bool perform() noexcept final override
 		{
+			//nothing to transfer: the idle service is suspended at once
+			if (tasks.empty())
+				return not completed_tasks.empty();
 			perform_data();
 			push_data();
 			return not(tasks.empty() and completed_tasks.empty());
@@ -256,52 +259,13 @@ namespace http
 		}
 
 	private:
+		//does not wait for the sockets: it runs on the shared pool, the service polls it again later
 		void perform_data()
 		{
-			fd_set fdread;
-			fd_set fdwrite;
-			fd_set fdexcep;
-
-			FD_ZERO(&fdread);
-			FD_ZERO(&fdwrite);
-			FD_ZERO(&fdexcep);
-
-			int maxfd = -1;
-			const CURLMcode cc = check_code(curl_multi_fdset(multi_handle, &fdread, &fdwrite, &fdexcep, &maxfd), "curl_multi_fdset");
-			if (cc != CURLM_OK)
-			{
-				logger::error("http", "curl_multi_fdset exit with error: {}", static_cast<int>(cc));
-				return;
-			}
-
-			if (maxfd == -1)
-			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
-			}
-			else
-			{
-				timeval timeout = get_timeout();
-				if (select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &timeout) == -1)
-					logger::error("http", "select exit with error: {}", errno);
-			}
-
 			int still_running = 0;
 			check_code(curl_multi_perform(multi_handle, &still_running), "curl_multi_perform");
 		}
 
-		timeval get_timeout() const
-		{
-			timeval timeout = {0, 100000};
-			long curl_timeout = 0;
-			check_code(curl_multi_timeout(multi_handle, &curl_timeout), "curl_multi_timeout");
-			if (curl_timeout >= 0)
-			{
-				timeout.tv_sec = curl_timeout / 1000;
-				timeout.tv_usec = (curl_timeout % 1000 ) * 1000;
-			}
-			return timeout;
-		}
-
 		void push_data()
 		{
 			int msg_left = 0;
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <pisk/defines.h>
+#include <pisk/utils/object_pool.h>
 
 #include <pisk/http/structs.h>
 
@@ -31,7 +32,9 @@ namespace http
 		Response response;
 		std::promise<Response> response_promise;
 	};
-	using HttpTaskPtr = std::unique_ptr<HttpTask>;
+	//tasks are made by threads of requests and released by the thread of the service
+	using HttpTaskPool = utils::object_pool<HttpTask>;
+	using HttpTaskPtr = HttpTaskPool::pointer;
 }
 }
 }
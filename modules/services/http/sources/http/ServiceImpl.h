@@ -15,7 +15,7 @@
 
 #include <pisk/defines.h>
 
-#include <pisk/utils/safequeue.h>
+#include <pisk/utils/mpsc_queue.h>
 #include <pisk/infrastructure/Logger.h>
 #include <pisk/tools/Job.h>
 
@@ -35,7 +35,10 @@ namespace http
 	class ServiceImpl :
 		public Service
 	{
-		utils::safequeue<HttpTaskPtr> requests;
+		//is declared first: it outlives the tasks in the queue and in the worker
+		HttpTaskPool task_pool;
+		//filled by any thread, read by the iterations of the job
+		utils::mpsc_queue<HttpTaskPtr> requests;
 		WorkerPtr worker;
 		tools::CyclicalScopedJob job;
 
@@ -43,6 +46,7 @@ namespace http
 		explicit ServiceImpl(WorkerPtr&& worker):
 			worker(std::move(worker)),
 			job(
+				tools::ThreadPool::shared(),
 				std::bind(&ServiceImpl::iteration, this, std::placeholders::_1),
 				std::bind(&ServiceImpl::deinit_service, this),
 				std::bind(&ServiceImpl::init_service, this)
@@ -62,9 +66,13 @@ namespace http
 		{
 			push_tasks();
 			const bool all_tasks_completed = not worker->perform();
-			if (all_tasks_completed)
-				waiting_for_task();
 			pop_completed_tasks();
+			if (all_tasks_completed and requests.empty())
+				job.suspend();
+			else if (not all_tasks_completed)
+				//the job shares the pool with the other tasks, so it does not block in select():
+				//it polls the transfers again later and holds no worker till then
+				job.delay(std::chrono::milliseconds(5));
 		}
 
 	private:
@@ -94,12 +102,6 @@ namespace http
 			}
 		}
 
-		void waiting_for_task() const
-		{
-			while (requests.empty() and not job.is_stopped())
-				std::this_thread::sleep_for(std::chrono::milliseconds(30));
-		}
-
 
 	private:
 		virtual void release() final override
@@ -110,9 +112,10 @@ namespace http
 		virtual std::future<Response> request(const Request& request) noexcept threadsafe final override
 		{
 			logger::debug("http", "Request by url: {}", to_string(request.url));
-			auto task = std::make_unique<HttpTask>(HttpTask {request});
+			auto task = task_pool.make(HttpTask {request});
 			auto future = task->response_promise.get_future();
 			requests.push(std::move(task));
+			job.resume();
 			return future;
 		}
 	};
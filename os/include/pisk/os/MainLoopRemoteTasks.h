@@ -20,6 +20,7 @@
 #include <pisk/infrastructure/Logger.h>
 
 #include <atomic>
+#include <chrono>
 #include <thread>
 
 namespace pisk
@@ -30,6 +31,8 @@ namespace os
 		public core::Component
 	{
 		tools::RemoteTaskExecutor remote_task_list;
+		//the main loop has to process the os events: the rest of the tasks waits for the next iteration
+		const std::chrono::milliseconds execute_budget = std::chrono::milliseconds(5);
 
 	public:
 		constexpr static const char* uid = "main_loop_remote_tasks";
@@ -48,7 +51,7 @@ namespace os
 
 		void execute()
 		{
-			remote_task_list.execute_remote_tasks();
+			remote_task_list.execute_remote_tasks(execute_budget);
 		}
 
 		void deinit()
@@ -34,7 +34,7 @@ class ConsoleLogger:
 		const std::string tid = '[' + std::to_string(utils::get_current_thread_id()) + "] ";
 		std::string ctag = tag;
 		ctag.resize(16, ' ');
-		std::cout << static_cast<int>(level) << ':' << ctag << '\t' << tid << ' ' << message << std::endl;
+		std::cout << static_cast<int>(level) << ':' << ctag << '\t' << tid << ' ' << message << '\n';
 	}
 
 	virtual void store(const infrastructure::Logger::Level level, const std::string& tag, const std::vector<std::string>& messages) noexcept final override
@@ -42,6 +42,18 @@ class ConsoleLogger:
 		for (const auto& message : messages)
 			store(level, tag, message);
 	}
+
+	//the logger flushes once per record or per batch of records, not on every line
+	virtual void flush() noexcept final override
+	{
+		std::cout.flush();
+	}
+
+	//the standard output descriptor: the records pending on a crash go after the flushed std::cout lines
+	virtual int get_crash_descriptor() const noexcept final override
+	{
+		return 1;
+	}
 };
 
 }
@@ -60,7 +60,7 @@ try
 			});
 			if (not cmp["dependencies"].is_none())
 				for(const auto& libname : cmp["dependencies"].as_array())
-					out.back().dependencies.push_back(libname.second.as_string());
+					out.back().dependencies.push_back(libname.as_string());
 		}
 	}
 	return out;
@@ -84,6 +84,7 @@ void common_init_logger(std::unique_ptr<infrastructure::LogStorage>&& log_storag
 {
 	logger::set_log_level(infrastructure::Logger::Level::Debug);
 	logger::set_log_storage(std::move(log_storage));
+	logger::start_async();
 }
 
 void common_run_application(const tools::AppConfigurator& configurator)
@@ -0,0 +1,119 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#pragma once
+
+#include <pisk/defines.h>
+#include <pisk/infrastructure/Logger.h>
+#include <pisk/infrastructure/TraceLog.h>
+#include <pisk/os/utils.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace pisk
+{
+namespace os
+{
+namespace impl
+{
+
+//The trace ring in a mapped file: the records survive a crash of the process,
+//the file is decoded by tools/trace_decoder. The previous file is kept with the ".1" suffix.
+class TraceFileLogger:
+	public infrastructure::TraceStorage
+{
+	class mapped_file
+	{
+		void* data = nullptr;
+		std::size_t size = 0;
+
+	public:
+		mapped_file(const std::string& path, const std::size_t new_size)
+		{
+			std::rename(path.c_str(), (path + ".1").c_str());
+			const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (fd < 0)
+				throw infrastructure::InitializeError();
+			if (::ftruncate(fd, new_size) != 0)
+			{
+				::close(fd);
+				throw infrastructure::InitializeError();
+			}
+			void* mapped = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (mapped == MAP_FAILED)
+				throw infrastructure::InitializeError();
+			data = mapped;
+			size = new_size;
+		}
+		~mapped_file()
+		{
+			::munmap(data, size);
+		}
+		void* get() const
+		{
+			return data;
+		}
+	};
+
+	mapped_file file;
+	infrastructure::TraceRing ring;
+
+	static std::uint32_t get_thread_id()
+	{
+		static thread_local const std::uint32_t id = static_cast<std::uint32_t>(utils::get_current_thread_id());
+		return id;
+	}
+
+public:
+	TraceFileLogger(const std::string& path, const std::size_t records, const std::size_t strings):
+		file(path, infrastructure::TraceRing::block_size(records, strings)),
+		ring(file.get(), records, strings)
+	{}
+
+	virtual std::uint32_t intern(const char* text, const std::size_t size) noexcept final override
+	{
+		return ring.intern(text, size);
+	}
+
+	virtual void write(infrastructure::TraceRecord& record) noexcept final override
+	{
+		record.thread = get_thread_id();
+		ring.write(record);
+	}
+};
+
+//PISK_TRACE_LOG=<file> turns the trace on: the last 64K debug records (8 Mb) are kept in the file
+inline void init_trace_log()
+{
+	const char* path = std::getenv("PISK_TRACE_LOG");
+	if (path == nullptr or *path == '\x0')
+		return;
+	try
+	{
+		logger::set_trace_storage(std::make_unique<TraceFileLogger>(path, 65536, 65536));
+		logger::info("framework", "The trace log is written to '{}'", path);
+	}
+	catch (const infrastructure::InitializeError&)
+	{
+		logger::error("framework", "Unable to open the trace log '{}'", path);
+	}
+}
+
+}
+}
+}
@@ -13,6 +13,7 @@
 
 #include "../../common.h"
 #include "../../ConsoleLogger.h"
+#include "../TraceFileLogger.h"
 #include "../../OsAppInstance.h"
 
 #include <pisk/tools/MainLoop.h>
@@ -32,6 +33,7 @@ extern "C"
 void run_application()
 {
 	pisk::os::common_init_logger(std::make_unique<pisk::os::impl::ConsoleLogger>());
+	pisk::os::impl::init_trace_log();
 
 	const pisk::tools::OsComponentList components {
 		{pisk::tools::OsAppInstance::uid, &common_make_os_app_instance_component},
@@ -13,6 +13,7 @@
 
 #include "../../common.h"
 #include "../../ConsoleLogger.h"
+#include "../TraceFileLogger.h"
 
 #include <pisk/tools/MainLoop.h>
 #include <pisk/os/WindowManager.h>
@@ -48,6 +49,7 @@ extern "C"
 void run_application()
 {
 	pisk::os::common_init_logger(std::make_unique<pisk::os::impl::ConsoleLogger>());
+	pisk::os::impl::init_trace_log();
 
 	::XSetErrorHandler(&x_error_handler);
 	::XInitThreads();
@@ -133,6 +133,18 @@ function test_combo_dict(dict)\n\
 		end\n\
 	until true end\n\
 	return out\n\
+end\n\
+function test_echo(value)\n\
+	return value\n\
+end\n\
+function test_holed_array()\n\
+	return {1, nil, 3}\n\
+end\n\
+function test_mixed_table()\n\
+	return {10, 20, name = 'qwe'}\n\
+end\n\
+function test_numeric_string_keys()\n\
+	return {['1'] = 'asd', ['2'] = 'zxc'}, {10, ['2'] = 'zxc'}\n\
 end\n\
 		";
 		return pisk::infrastructure::DataBuffer(testdata.begin(), testdata.end());
@@ -337,6 +349,70 @@ Context(check_script_service) {
 		});
 		Assert::That(fail_msg, Is().EqualTo(""));
 	}
+	Spec(script_executed_with_holed_array_arguments) {
+		std::string fail_msg = RunAppForTestService<pisk::system::ResourceManager>(desc_list, [](const pisk::system::ResourceManagerPtr& res_mgr) {
+			res_mgr->get_pack_manager().set_pack("1", std::make_unique<TestResourcePack<TestDataStream<test_data_hello_world>>>());
+			const auto& resource = res_mgr->load<script::Resource>("script");
+			const auto& script = resource->make_instance();
+			pisk::utils::property argument;
+			argument[std::size_t(0)] = 15;
+			argument[2UL] = 27;
+			const auto& sum = check_result(script->execute("test_sum_array", {argument}), {42.});
+			if (not sum.empty())
+				return sum;
+			pisk::utils::property array;
+			array[std::size_t(0)] = 15.;
+			array[2UL] = 27.;
+			return check_result(script->execute("test_echo", {argument}), {array});
+		});
+		Assert::That(fail_msg, Is().EqualTo(""));
+	}
+	Spec(script_executed_with_holed_array_result) {
+		std::string fail_msg = RunAppForTestService<pisk::system::ResourceManager>(desc_list, [](const pisk::system::ResourceManagerPtr& res_mgr) {
+			res_mgr->get_pack_manager().set_pack("1", std::make_unique<TestResourcePack<TestDataStream<test_data_hello_world>>>());
+			const auto& resource = res_mgr->load<script::Resource>("script");
+			const auto& script = resource->make_instance();
+			const auto& result = script->execute("test_holed_array", {});
+			pisk::utils::property array;
+			array[std::size_t(0)] = 1.;
+			array[2UL] = 3.;
+			return check_result(result, {array});
+		});
+		Assert::That(fail_msg, Is().EqualTo(""));
+	}
+	Spec(script_executed_with_mixed_table_result) {
+		std::string fail_msg = RunAppForTestService<pisk::system::ResourceManager>(desc_list, [](const pisk::system::ResourceManagerPtr& res_mgr) -> std::string {
+			res_mgr->get_pack_manager().set_pack("1", std::make_unique<TestResourcePack<TestDataStream<test_data_hello_world>>>());
+			const auto& resource = res_mgr->load<script::Resource>("script");
+			const auto& script = resource->make_instance();
+			//a property is either an array or a dictionary
+			try {
+				script->execute("test_mixed_table", {});
+				return "mixed table converted, but should not";
+			} catch (const pisk::utils::PropertyCastException&) {
+			}
+			//the stack of the script is restored after the failure
+			return check_result(script->execute("test_number", {}), {2.});
+		});
+		Assert::That(fail_msg, Is().EqualTo(""));
+	}
+	Spec(script_executed_with_numeric_string_keys_result) {
+		std::string fail_msg = RunAppForTestService<pisk::system::ResourceManager>(desc_list, [](const pisk::system::ResourceManagerPtr& res_mgr) {
+			res_mgr->get_pack_manager().set_pack("1", std::make_unique<TestResourcePack<TestDataStream<test_data_hello_world>>>());
+			const auto& resource = res_mgr->load<script::Resource>("script");
+			const auto& script = resource->make_instance();
+			const auto& result = script->execute("test_numeric_string_keys", {});
+			//a numeric string key is an index, but it is not a part of the sequence read by index
+			pisk::utils::property strings;
+			strings[std::size_t(0)] = "asd";
+			strings[1UL] = "zxc";
+			pisk::utils::property mixed;
+			mixed[std::size_t(0)] = 10.;
+			mixed[1UL] = "zxc";
+			return check_result(result, {strings, mixed});
+		});
+		Assert::That(fail_msg, Is().EqualTo(""));
+	}
 };
 
 struct test_data_non_registered_error {
@@ -15,6 +15,8 @@
 
 #include <pisk/utils/noncopyable.h>
 #include <pisk/utils/property_tree.h>
+#include <pisk/utils/small_function.h>
+#include <pisk/tools/FramePacer.h>
 
 #include <pisk/system/PatchPtr.h>
 
@@ -25,10 +27,15 @@ namespace pisk
 {
 namespace system
 {
+	using EngineTaskHandle = utils::small_function<void ()>;
+
 	class PatchRecipient
 	{
 	public:
 		virtual void push(const PatchPtr& patch) noexcept threadsafe = 0;
+
+		//Runs the task by the engine thread before the next patches and wakes the engine up
+		virtual void post(EngineTaskHandle&& task) noexcept threadsafe = 0;
 	};
 
 	class EngineStrategy :
@@ -37,7 +44,24 @@ namespace system
 	public:
 		struct Configure
 		{
+			enum class Scheduling
+			{
+				//the engine ticks every update_interval
+				FixedInterval,
+				//the engine ticks when a patch or a task arrives, but not more often than min_interval
+				//and not more rarely than max_latency
+				OnEvent,
+			};
+
 			std::chrono::milliseconds update_interval = std::chrono::milliseconds(25);
+			//FixedInterval only: the frames missed by a long tick are skipped or caught up by extra updates
+			tools::FrameOverrun overrun = tools::FrameOverrun::Skip;
+			std::size_t max_catch_up = 4;
+
+			Scheduling scheduling = Scheduling::FixedInterval;
+			std::chrono::microseconds min_interval = std::chrono::milliseconds(1);
+			//also bounds the time the engine needs to notice a stop request
+			std::chrono::milliseconds max_latency = std::chrono::milliseconds(25);
 		};
 
 		virtual ~EngineStrategy() {}
@@ -66,14 +90,23 @@ namespace system
 		{
 			push_changes(std::make_shared<Patch>(patch));
 		}
+		//the patch have not to be changed by the caller anymore, so all engines share its storage
 		void push_changes(Patch&& patch) const noexcept threadsafe
 		{
-			push_changes(std::make_shared<Patch>(std::move(patch)));
+			auto&& shared_patch = std::make_shared<Patch>(std::move(patch));
+			shared_patch->seal();
+			push_changes(shared_patch);
 		}
 		void push_changes(const PatchPtr& patch) const noexcept threadsafe
 		{
 			patch_recipient.push(patch);
 		}
+
+		//the task is executed by the engine thread, so it may touch the strategy without locks
+		void post_task(EngineTaskHandle&& task) const noexcept threadsafe
+		{
+			patch_recipient.post(std::move(task));
+		}
 	};
 
 	using PatchRecipientPtr = std::unique_ptr<PatchRecipient>();
@@ -13,7 +13,7 @@
 
 #pragma once
 
-#include <pisk/utils/safequeue.h>
+#include <pisk/utils/mpsc_queue.h>
 #include <pisk/utils/property_tree.h>
 
 namespace pisk
@@ -22,7 +22,8 @@ namespace system
 {
 	using Patch = utils::property;
 	using PatchPtr = std::shared_ptr<const Patch>;
-	using PatchQueue = utils::safequeue<PatchPtr>;
+	//every engine reads its own queue, the other engines write to it
+	using PatchQueue = utils::mpsc_queue<PatchPtr>;
 	using PatchQueuePtr = std::shared_ptr<PatchQueue>;
 }
 }
@@ -16,6 +16,8 @@
 
 #include <pisk/utils/noncopyable.h>
 #include <pisk/infrastructure/Logger.h>
+#include <pisk/tools/RemoteTaskList.h>
+#include <pisk/tools/FramePacer.h>
 
 #include <pisk/system/Engine.h>
 #include <pisk/system/EngineStrategy.h>
@@ -24,6 +26,7 @@
 #include "EngineSynchronizer.h"
 
 #include <chrono>
+#include <deque>
 #include <thread>
 #include <atomic>
 #include <memory>
@@ -40,11 +43,14 @@ namespace impl
 	{
 		EngineStrategy::Configure config;
 
+		tools::RemoteTaskExecutor tasks;
 		EngineSynchronizerSlavePtr synchronizer;
 		EngineStrategyPtr strategy;
 		PatchGatePtr patch_gate;
 
-		std::chrono::system_clock::time_point last_update;
+		tools::FramePacer pacer {config.update_interval, config.overrun, config.max_catch_up};
+		tools::TickStatistics tick_statistics;
+		std::chrono::steady_clock::time_point last_update;
 		std::atomic_bool stop;
 		std::thread worker;
 	public:
@@ -70,6 +76,8 @@ namespace impl
 			logger::debug("engine_task", "Engine task is going to stop ({})", this);
 			request_stop();
 			wait();
+			//the strategy may post tasks until it is destroyed, so it goes before the gate
+			strategy.reset();
 			logger::debug("engine_task", "Engine task destroied ({})", this);
 		}
 
@@ -78,6 +86,17 @@ namespace impl
 			patch_gate->push(patch);
 		}
 
+		virtual void post(EngineTaskHandle&& task) noexcept threadsafe
+		try
+		{
+			tasks.post_remote_task(std::move(task));
+			patch_gate->wakeup();
+		}
+		catch (const infrastructure::InitializeError&)
+		{
+			logger::warning("engine_task", "Task was dropped: the engine does not run ({})", this);
+		}
+
 	private:
 
 		void start()
@@ -91,6 +110,7 @@ namespace impl
 		void request_stop()
 		{
 			stop = true;
+			patch_gate->wakeup();
 		}
 		bool is_running()
 		{
@@ -117,7 +137,9 @@ namespace impl
 		{
 			synchronizer->notify_ready();
 			synchronizer->wait_initialize_signal();
+			tasks.init();
 			config = strategy->on_init_app();
+			pacer = tools::FramePacer(config.update_interval, config.overrun, config.max_catch_up);
 			synchronizer->notify_initialize_finished();
 		}
 		void run_loop()
@@ -125,17 +147,22 @@ namespace impl
 			synchronizer->wait_loop_begin_signal();
 			while (is_running())
 			{
-				wait_for_interval();
+				const std::size_t updates = wait_for_next_tick();
+				tick_statistics.tick(std::chrono::steady_clock::now());
+				execute_tasks();
 				prepatch();
 				process_input_patches();
-				update();
+				for (std::size_t i = 0; i < updates; ++i)
+					update();
 			}
+			log_tick_statistics();
 			synchronizer->notify_loop_finished();
 		}
 		void deinitialize()
 		{
 			synchronizer->wait_deinitialize_signal();
 			strategy->on_deinit_app();
+			tasks.deinit();
 			synchronizer->notify_deinitialize_finished();
 		}
 
@@ -147,6 +174,10 @@ namespace impl
 			for (auto&& input_patch : patches)
 				strategy->patch_scene(input_patch);
 		}
+		void execute_tasks()
+		{
+			tasks.execute_remote_tasks();
+		}
 		void prepatch()
 		{
 			strategy->prepatch();
@@ -155,14 +186,44 @@ namespace impl
 		{
 			strategy->update();
 		}
-		void wait_for_interval()
+		//returns the count of updates for the tick
+		std::size_t wait_for_next_tick()
 		{
-			const auto now = std::chrono::system_clock::now();
-			const auto work_time = now - last_update;
-			if (work_time < config.update_interval)
-				std::this_thread::sleep_for(config.update_interval - work_time);
-			last_update = now;
-
+			switch (config.scheduling)
+			{
+			case EngineStrategy::Configure::Scheduling::FixedInterval:
+				return pacer.wait_next_frame();
+			case EngineStrategy::Configure::Scheduling::OnEvent:
+				wait_for_event();
+				return 1;
+			}
+			return 1;
+		}
+		//A push to the gate or a posted task interrupts the wait: the patch is handled
+		//right away instead of at the next slot
+		void wait_for_event()
+		{
+			const auto throttle_time = last_update + config.min_interval;
+			const auto now = std::chrono::steady_clock::now();
+			if (now < throttle_time)
+				tools::sleep_until(throttle_time);
+
+			const auto deadline = last_update + config.max_latency;
+			const auto timeout = deadline - std::chrono::steady_clock::now();
+			if (timeout > std::chrono::steady_clock::duration::zero())
+				patch_gate->wait(timeout);
+			last_update = std::chrono::steady_clock::now();
+		}
+		void log_tick_statistics()
+		{
+			using std::chrono::duration_cast;
+			using std::chrono::microseconds;
+			logger::info("engine_task", "Tick period of engine task ({}): min {} us, avg {} us, p99 {} us ({} ticks)",
+				this,
+				duration_cast<microseconds>(tick_statistics.get_min()).count(),
+				duration_cast<microseconds>(tick_statistics.get_average()).count(),
+				duration_cast<microseconds>(tick_statistics.get_percentile(99)).count(),
+				tick_statistics.get_count());
 		}
 	};
 	using EngineTaskPtr = std::unique_ptr<EngineTask>;
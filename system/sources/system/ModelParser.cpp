@@ -20,21 +20,44 @@ namespace pisk
 {
 namespace system
 {
+	namespace
+	{
+		const utils::property& materialize(const utils::property& value)
+		{
+			return value;
+		}
+		utils::property materialize(const utils::json::lazy_property& value)
+		{
+			return value.materialize();
+		}
+
+		//Description is utils::property or utils::json::lazy_property
+		template <typename Description>
+		ModelParser::Presentations parse_model(const Description& description) noexcept
+		try
+		{
+			const std::string& scene_name = description["properties"]["name"].get_or("noname");
+			logger::info("modelparser", "Parse object '{}'", scene_name);
+
+			ModelParser::Presentations out;
+			for (auto it = description.begin(); it != description.end(); ++it)
+				if (it->is_dictionary())
+					out[it.get_key()] = materialize(*it);
+			return out;
+		} catch (const infrastructure::Exception&) {
+			logger::error("modelparser", "There is an error while loading model");
+			return {};
+		}
+	}
+
 	ModelParser::Presentations ModelParser::parse(const utils::property& description) noexcept
-	try
 	{
-		const auto prop_scene_name = description["properties"]["name"];
-		const std::string& scene_name = prop_scene_name.is_string() ? prop_scene_name.as_string() : "noname";
-		logger::info("modelparser", "Parse object '{}'", scene_name);
-
-		Presentations out;
-		for (auto it = description.begin(); it != description.end(); ++it)
-			if (it->is_dictionary())
-				out[it.get_key()] = *it;
-		return out;
-	} catch (const infrastructure::Exception&) {
-		logger::error("modelparser", "There is an error while loading model");
-		return {};
+		return parse_model(description);
+	}
+
+	ModelParser::Presentations ModelParser::parse(const utils::json::lazy_property& description) noexcept
+	{
+		return parse_model(description);
 	}
 }
 }
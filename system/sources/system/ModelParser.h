@@ -16,6 +16,7 @@
 #include <pisk/defines.h>
 #include <pisk/utils/noncopyable.h>
 #include <pisk/utils/property_tree.h>
+#include <pisk/utils/json_utils.h>
 
 #include <memory>
 #include <map>
@@ -31,6 +32,7 @@ namespace system
 
 		//TODO: extend method with callback interface
 		static Presentations parse(const utils::property& description) noexcept;
+		static Presentations parse(const utils::json::lazy_property& description) noexcept;
 	};
 	typedef std::unique_ptr<ModelParser> ModelParserPtr;
 }
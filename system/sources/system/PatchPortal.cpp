@@ -15,6 +15,7 @@
 #include "PatchPortal.h"
 
 #include <memory>
+#include <deque>
 #include <mutex>
 #include <set>
 
@@ -40,6 +41,14 @@ namespace impl
 		{
 			queue.push(patch);
 		}
+		bool wait(const std::chrono::steady_clock::duration timeout)
+		{
+			return queue.wait(timeout);
+		}
+		void wakeup() threadsafe
+		{
+			queue.wakeup();
+		}
 	};
 
 	class PatchGates
@@ -75,6 +84,16 @@ namespace impl
 		{
 			gates->push(patch);
 		}
+
+		virtual bool wait(const std::chrono::steady_clock::duration timeout) final override
+		{
+			return gate->wait(timeout);
+		}
+
+		virtual void wakeup() threadsafe final override
+		{
+			gate->wakeup();
+		}
 	public:
 		PatchGate(const std::shared_ptr<PatchGateQueue>& gate, const std::shared_ptr<PatchGates>& gates):
 			gate(gate),
@@ -15,6 +15,7 @@
 
 #include <pisk/system/PatchPtr.h>
 
+#include <chrono>
 #include <memory>
 
 namespace pisk
@@ -29,6 +30,12 @@ namespace system
 		virtual PatchPtr pop() threadsafe = 0;
 
 		virtual void push(const PatchPtr& patch) threadsafe = 0;
+
+		//Is called by the thread of pop(): waits for a patch up to `timeout`; false on timeout or wakeup()
+		virtual bool wait(const std::chrono::steady_clock::duration timeout) = 0;
+
+		//Interrupts the current or the next wait()
+		virtual void wakeup() threadsafe = 0;
 	};
 	using PatchGatePtr = std::unique_ptr<PatchGate>;
 
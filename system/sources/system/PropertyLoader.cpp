@@ -14,6 +14,7 @@
 
 #include <pisk/defines.h>
 #include <pisk/utils/json_utils.h>
+#include <pisk/utils/binary_property.h>
 #include <pisk/tools/ComponentsLoader.h>
 
 #include <pisk/system/PropertyLoader.h>
@@ -29,6 +30,7 @@ namespace impl
 	{
 		utils::property prop;
 
+		//the copy shares the whole tree with the resource: O(1)
 		virtual utils::property get() threadsafe const noexcept final override
 		{
 			return prop;
@@ -37,9 +39,23 @@ namespace impl
 	public:
 		explicit PropertyTreeResource(utils::property&& prop):
 			prop(std::move(prop))
-		{}
+		{
+			this->prop.seal();
+		}
 	};
 
+	inline bool is_binary_property(const infrastructure::DataStreamPtr& stream) noexcept
+	{
+		if (stream == nullptr)
+			return false;
+		infrastructure::DataBuffer header;
+		const auto orig_pos = stream->tell();
+		stream->seek(0, infrastructure::DataStream::Whence::begin);
+		stream->read(utils::binary::header_size, header);
+		stream->seek(orig_pos, infrastructure::DataStream::Whence::begin);
+		return utils::binary::is_binary_property(header.data(), header.size());
+	}
+
 	class JsonToPropertyTreeResourceLoader :
 		public ResourceLoader
 	{
@@ -48,9 +64,10 @@ namespace impl
 			delete this;
 		}
 
-		virtual bool can_load(const infrastructure::DataStreamPtr&) const noexcept threadsafe final override
+		//any text is passed to the json parser; the binary form is left to BinaryToPropertyTreeResourceLoader
+		virtual bool can_load(const infrastructure::DataStreamPtr& stream) const noexcept threadsafe final override
 		{
-			return true;
+			return not is_binary_property(stream);
 		}
 
 		virtual ResourcePtr load(infrastructure::DataStreamPtr&& stream) const threadsafe final override
@@ -62,6 +79,28 @@ namespace impl
 		}
 	};
 
+	class BinaryToPropertyTreeResourceLoader :
+		public ResourceLoader
+	{
+		virtual void release() final override
+		{
+			delete this;
+		}
+
+		virtual bool can_load(const infrastructure::DataStreamPtr& stream) const noexcept threadsafe final override
+		{
+			return is_binary_property(stream);
+		}
+
+		virtual ResourcePtr load(infrastructure::DataStreamPtr&& stream) const threadsafe final override
+		{
+			if (stream == nullptr)
+				throw infrastructure::NullPointerException();
+			auto&& prop = utils::binary::parse_binary_to_property(*stream);
+			return std::make_shared<PropertyTreeResource>(std::move(prop));
+		}
+	};
+
 }
 }
 }
@@ -92,3 +131,26 @@ EXPORT pisk::tools::components::ComponentFactory __cdecl get_property_tree_loade
 	return &property_tree_loader_factory;
 }
 
+SafeComponentPtr __cdecl binary_property_tree_loader_factory(const ServiceRegistry& temp_sl, const InstanceFactory& factory, const pisk::utils::property&)
+{
+	static_assert(std::is_convertible<decltype(&binary_property_tree_loader_factory), pisk::tools::components::ComponentFactory>::value, "Signature was changed!");
+
+	auto resource_manager = temp_sl.get<pisk::system::ResourceManager>();
+	if (resource_manager == nullptr)
+		throw pisk::infrastructure::NullPointerException();
+
+	auto resource_loader = factory.make<pisk::system::impl::BinaryToPropertyTreeResourceLoader>();
+
+	resource_manager->get_loader_registry().register_resource_loader(
+		pisk::system::PropertyTreeResource::resource_type, resource_loader
+	);
+	return resource_loader;
+}
+
+extern "C"
+EXPORT pisk::tools::components::ComponentFactory __cdecl get_binary_property_tree_loader_factory()
+{
+	static_assert(std::is_convertible<decltype(&get_binary_property_tree_loader_factory), pisk::tools::components::ComponentFactoryGetter>::value, "Signature was changed!");
+
+	return &binary_property_tree_loader_factory;
+}
@@ -23,35 +23,59 @@ namespace pisk
 {
 namespace system
 {
-	SceneParser::Objects SceneParser::parse(const utils::property& description) noexcept
-	try
+	namespace
 	{
-		const auto prop_scene_name = description["properties"]["name"];
-		const std::string& scene_name = prop_scene_name.is_string() ? prop_scene_name.as_string() : "noname";
-		logger::info("sceneparser", "Loading scene '{}'", scene_name);
-
-		if (description["objects"].is_array() == false)
+		const utils::property& materialize(const utils::property& value)
 		{
-			logger::error("sceneparser", "'objects' not found at the scene '{}'", scene_name);
-			return {};
+			return value;
+		}
+		utils::property materialize(const utils::json::lazy_property& value)
+		{
+			return value.materialize();
 		}
 
-		SceneParser::Objects out;
-		for (const auto& object : description["objects"])
+		//Description is utils::property or utils::json::lazy_property; only the overrides are materialized
+		template <typename Description>
+		SceneParser::Objects parse_scene(const Description& description) noexcept
+		try
 		{
-			const utils::property& model = object["model"];
-			const utils::property& overrides = object["overrides"];
-			if (model.is_string() == false)
-				continue;
-			logger::debug("sceneparser", "Detect model '{}'", model.as_string());
-			out.emplace_back(std::make_pair(model.as_keystring(), overrides));
+			const std::string& scene_name = description["properties"]["name"].get_or("noname");
+			logger::info("sceneparser", "Loading scene '{}'", scene_name);
+
+			if (description["objects"].is_array() == false)
+			{
+				logger::error("sceneparser", "'objects' not found at the scene '{}'", scene_name);
+				return {};
+			}
+
+			SceneParser::Objects out;
+			for (const auto& object : description["objects"])
+			{
+				const auto& model = object["model"];
+				const auto& overrides = object["overrides"];
+				if (model.is_string() == false)
+					continue;
+				const utils::keystring& model_id = model.as_keystring();
+				logger::debug("sceneparser", "Detect model '{}'", model_id);
+				out.emplace_back(std::make_pair(model_id, materialize(overrides)));
+			}
+
+			logger::info("sceneparser", "Complete parse scene '{}'", scene_name);
+			return out;
+		} catch (const infrastructure::Exception&) {
+			logger::error("sceneparser", "There is an error while parse scene");
+			return {};
 		}
+	}
 
-		logger::info("sceneparser", "Complete parse scene '{}'", scene_name);
-		return out;
-	} catch (const infrastructure::Exception&) {
-		logger::error("sceneparser", "There is an error while parse scene");
-		return {};
+	SceneParser::Objects SceneParser::parse(const utils::property& description) noexcept
+	{
+		return parse_scene(description);
+	}
+
+	SceneParser::Objects SceneParser::parse(const utils::json::lazy_property& description) noexcept
+	{
+		return parse_scene(description);
 	}
 }
 }
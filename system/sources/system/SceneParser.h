@@ -16,6 +16,7 @@
 #include <pisk/defines.h>
 #include <pisk/utils/noncopyable.h>
 #include <pisk/utils/property_tree.h>
+#include <pisk/utils/json_utils.h>
 
 #include <memory>
 #include <vector>
@@ -31,6 +32,8 @@ namespace system
 
 		//TODO: extend method with callback interface
 		static Objects parse(const utils::property& description) noexcept;
+		//parses only the objects list of the document, other parts of the scene stay unparsed
+		static Objects parse(const utils::json::lazy_property& description) noexcept;
 	};
 }
 }
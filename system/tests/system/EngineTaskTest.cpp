@@ -132,10 +132,18 @@ public:
 		void push(const system::PatchPtr& patch) {
 			return mock.push(patch);
 		}
+		bool wait(const std::chrono::steady_clock::duration timeout) {
+			return mock.wait(timeout);
+		}
+		void wakeup() {
+			return mock.wakeup();
+		}
 	};
 
 	MOCK_METHOD0(pop, system::PatchPtr());
 	MOCK_METHOD1(push, void(const system::PatchPtr& patch));
+	MOCK_METHOD1(wait, bool(const std::chrono::steady_clock::duration timeout));
+	MOCK_METHOD0(wakeup, void());
 };
 
 //TODO: refactor it: EXPECT_CALL can not in threadsafe
@@ -21,6 +21,8 @@ namespace system {
 }//namespace system
 }//namespace pisk
 
+pisk::system::PatchPortalPtr CreatePatchPortal();
+
 using namespace igloo;
 using namespace pisk;
 using namespace pisk::system;
@@ -69,5 +71,40 @@ Describe(EngineTest) {
 			}*/
 		};
 	};
+	When(event_driven_engine_receives_patch) {
+		EngineSynchronizerPtr engine_synchronizer;
+		PatchPortalPtr portal;
+		PatchGatePtr sender;
+		std::shared_ptr<impl::Engine> engine;
+		std::chrono::steady_clock::duration reaction_time;
+
+		void SetUp() {
+			engine_synchronizer = make_engine_synchronizer();
+			portal = CreatePatchPortal();
+			sender = portal->make_gate();
+
+			auto&& task = make_engine_task<EventDrivenTestStrategy>(portal->make_gate(), engine_synchronizer->make_slave());
+			engine = std::make_shared<impl::Engine>(std::move(task));
+
+			engine_synchronizer->initialize_signal();
+			engine_synchronizer->run_loop_signal();
+
+			const auto pushed = std::chrono::steady_clock::now();
+			sender->push(std::make_shared<Patch>("data"));
+			while (not EventDrivenTestStrategy::patched and std::chrono::steady_clock::now() - pushed < std::chrono::seconds(5))
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			reaction_time = std::chrono::steady_clock::now() - pushed;
+		}
+		void TearDown() {
+			engine_synchronizer->stop_all();
+			engine_synchronizer->deinitialize_signal();
+			engine.reset();
+		}
+
+		Then(patch_is_handled_without_waiting_max_latency) {
+			Assert::That(static_cast<bool>(EventDrivenTestStrategy::patched), Is().EqualTo(true));
+			Assert::That(reaction_time < std::chrono::seconds(1), Is().EqualTo(true));
+		}
+	};
 };
 
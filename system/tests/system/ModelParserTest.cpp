@@ -89,4 +89,21 @@ Describe(ModelParserTest) {
 			Assert::That(system::ModelParser::parse(desc)[utils::keystring("script")]["rid"].as_string(), Is().EqualTo("SuperUI.lua"));
 		}
 	};
+	Context(lazy_model) {
+		utils::json::lazy_property desc;
+		void SetUp() {
+			desc = utils::json::parse_json_to_lazy_property(R"({
+				"properties": {"name": "box"},
+				"location": {"position": [1, 2, 3]},
+				"audio": [],
+				"script": "none"
+			})");
+		}
+		Spec(dictionaries_are_submodels) {
+			const auto& presentations = system::ModelParser::parse(desc);
+			Assert::That(presentations.size(), Is().EqualTo(2U));
+			Assert::That(presentations.at(utils::keystring("properties"))["name"].as_string(), Is().EqualTo("box"));
+			Assert::That(presentations.at(utils::keystring("location")), Is().EqualTo(desc["location"].materialize()));
+		}
+	};
 };
@@ -15,6 +15,8 @@
 
 #include "../../sources/system/PatchPortal.h"
 
+#include <thread>
+
 using namespace igloo;
 using namespace pisk;
 
@@ -66,6 +68,9 @@ Describe(PatchDispatcherTest) {
 			Then(portal_still_empty_for_first) {
 				Assert::That(Parent().gate1->pop(), Is().EqualTo(nullptr));
 			}
+			Then(second_wait_returns_at_once) {
+				Assert::That(Parent().gate2->wait(std::chrono::seconds(10)), Is().EqualTo(true));
+			}
 			Then(second_can_pop_data) {
 				auto data = Parent().gate2->pop();
 				Assert::That(data, Is().Not().EqualTo(nullptr));
@@ -82,6 +87,30 @@ Describe(PatchDispatcherTest) {
 			};
 		};
 	};
+	When(portal_for_two_waits) {
+		system::PatchGatePtr gate1;
+		system::PatchGatePtr gate2;
+		void SetUp() {
+			gate1 = Root().portal->make_gate();
+			gate2 = Root().portal->make_gate();
+		}
+		Then(wait_times_out_without_patches) {
+			Assert::That(gate2->wait(std::chrono::milliseconds(1)), Is().EqualTo(false));
+		}
+		Then(wakeup_interrupts_the_next_wait) {
+			gate2->wakeup();
+			Assert::That(gate2->wait(std::chrono::seconds(10)), Is().EqualTo(false));
+		}
+		Then(push_from_other_thread_interrupts_wait) {
+			std::thread pusher([this]() {
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				gate1->push(std::make_shared<system::Patch>("data"));
+			});
+			const bool ready = gate2->wait(std::chrono::seconds(10));
+			pusher.join();
+			Assert::That(ready, Is().EqualTo(true));
+		}
+	};
 	When(portal_for_sandwich) {
 		system::PatchGatePtr gate1;
 		system::PatchGatePtr gate2;
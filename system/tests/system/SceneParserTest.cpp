@@ -17,8 +17,6 @@
 using namespace igloo;
 using namespace pisk;
 
-//TODO: json_utils_test?
-
 Describe(SceneParserTest) {
 	Context(empty_scene) {
 		utils::property desc;
@@ -110,5 +108,31 @@ Describe(SceneParserTest) {
 			Assert::That(system::SceneParser::parse(desc)[1].second.is_none(), Is().EqualTo(true));
 		}
 	};
+	Context(lazy_scene) {
+		utils::json::lazy_property desc;
+		void SetUp() {
+			desc = utils::json::parse_json_to_lazy_property(R"({
+				"properties": {"name": "Level 0"},
+				"objects": [
+					{"model": "some_model", "overrides": {"location": "1,1,1"}},
+					{"model": 7},
+					{"model": "another_model"}
+				],
+				"unused": [{"a": 1}, {"b": 2}]
+			})");
+		}
+		Spec(check_objects) {
+			const auto& objects = system::SceneParser::parse(desc);
+			Assert::That(objects.size(), Is().EqualTo(2U));
+			Assert::That(objects[0].first.get_content(), Is().EqualTo("some_model"));
+			Assert::That(objects[0].second["location"].as_string(), Is().EqualTo("1,1,1"));
+			Assert::That(objects[1].first.get_content(), Is().EqualTo("another_model"));
+			Assert::That(objects[1].second.is_none(), Is().EqualTo(true));
+		}
+		Spec(same_as_eager) {
+			const auto& eager = system::SceneParser::parse(desc.materialize());
+			Assert::That(system::SceneParser::parse(desc), Is().EqualTo(eager));
+		}
+	};
 };
 
@@ -17,3 +17,4 @@
 
 std::atomic<std::thread::id> EngineStrateyTestBase::thread_id;
 std::atomic_bool EngineStrateyTestBase::destroied;
+std::atomic_bool EventDrivenTestStrategy::patched;
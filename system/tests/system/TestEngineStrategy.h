@@ -69,6 +69,32 @@ public:
 	{}
 };
 
+class EventDrivenTestStrategy :
+	public EngineStrateyTestBase
+{
+public:
+	static std::atomic_bool patched;
+
+	EventDrivenTestStrategy()
+	{
+		patched = false;
+	}
+
+	virtual Configure on_init_app() override
+	{
+		Configure configure = EngineStrateyTestBase::on_init_app();
+		configure.scheduling = Configure::Scheduling::OnEvent;
+		configure.max_latency = std::chrono::seconds(10);
+		return configure;
+	}
+
+	virtual void patch_scene(const pisk::system::PatchPtr& scene) override
+	{
+		EngineStrateyTestBase::patch_scene(scene);
+		patched = true;
+	}
+};
+
 class TestPatchGate:
 	public pisk::system::PatchGate
 {
@@ -80,6 +106,15 @@ public:
 
 	virtual void push(const pisk::system::PatchPtr&) threadsafe
 	{}
+
+	virtual bool wait(const std::chrono::steady_clock::duration timeout)
+	{
+		std::this_thread::sleep_for(timeout);
+		return false;
+	}
+
+	virtual void wakeup() threadsafe
+	{}
 };
 
 template <typename Strategy>
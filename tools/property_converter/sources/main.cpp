@@ -0,0 +1,62 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/utils/json_utils.h>
+#include <pisk/utils/binary_property.h>
+
+#include <iostream>
+#include <iterator>
+#include <fstream>
+#include <string>
+
+//Usage: property_converter <input.json> <output>
+//The output directory have to exist.
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <input.json> <output>" << std::endl;
+		return 1;
+	}
+
+	std::ifstream input(argv[1], std::ios::binary);
+	if (not input)
+	{
+		std::cerr << "Failed to open '" << argv[1] << "'" << std::endl;
+		return 1;
+	}
+	const std::string document {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+
+	const pisk::utils::property& prop = pisk::utils::json::parse_json_to_property(document);
+	if (prop.is_none())
+	{
+		std::cerr << "Failed to parse '" << argv[1] << "' or it is empty" << std::endl;
+		return 1;
+	}
+
+	const pisk::infrastructure::DataBuffer& binary = pisk::utils::binary::to_binary(prop);
+	if (binary.empty())
+	{
+		std::cerr << "Failed to convert '" << argv[1] << "'" << std::endl;
+		return 1;
+	}
+
+	std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+	output.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+	if (not output)
+	{
+		std::cerr << "Failed to write '" << argv[2] << "'" << std::endl;
+		return 1;
+	}
+	return 0;
+}
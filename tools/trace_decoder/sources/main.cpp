@@ -0,0 +1,72 @@
+// Project pisk
+// Copyright (C) 2016-2017 Dmitry Shatilov
+//
+// Original sources:
+//   https://github.com/shatilov-diman/pisk/
+//   https://bitbucket.org/charivariltd/pisk/
+//
+// Author contacts:
+//   Dmitry Shatilov (e-mail: shatilov.diman@gmail.com; site: https://www.linkedin.com/in/shatilov)
+//
+//
+
+
+#include <pisk/infrastructure/TraceLog.h>
+
+#include <iostream>
+#include <iterator>
+#include <fstream>
+#include <iomanip>
+#include <ctime>
+
+using namespace pisk;
+
+static char level_to_char(const infrastructure::Logger::Level level)
+{
+	return "-CEWIDS"[static_cast<int>(level)];
+}
+
+static std::string time_to_string(const std::int64_t time)
+{
+	const std::time_t seconds = static_cast<std::time_t>(time / 1000000000);
+	char out[32] {};
+	std::strftime(out, sizeof(out), "%Y-%m-%d %H:%M:%S", std::localtime(&seconds));
+	return utils::string::format("{}.{:09}", out, time % 1000000000);
+}
+
+//Usage: trace_decoder <trace file> [count of the last records]
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <trace file> [count of the last records]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (not file)
+	{
+		std::cerr << "Unable to open '" << argv[1] << "'" << std::endl;
+		return 1;
+	}
+	const std::vector<char> data {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+	try
+	{
+		const auto& lines = infrastructure::TraceReader(data.data(), data.size()).read();
+		const std::size_t count = argc > 2 ? std::stoul(argv[2]) : lines.size();
+		const std::size_t first = lines.size() > count ? lines.size() - count : 0;
+		for (std::size_t index = first; index < lines.size(); ++index)
+		{
+			const auto& line = lines[index];
+			std::cout << time_to_string(line.time) << ' ' << level_to_char(line.level) << ' '
+				<< std::left << std::setw(16) << line.tag << " [" << line.thread << "] " << line.message << '\n';
+		}
+	}
+	catch (const infrastructure::TraceFormatException&)
+	{
+		std::cerr << "'" << argv[1] << "' is not a trace file" << std::endl;
+		return 1;
+	}
+	return 0;
+}